@@ -3,7 +3,10 @@
 #include "api_internal/math/vec_utils.h"
 #include "application.h"
 #include "game.h"
+#include "graphics/spatial_index.h"
+#include "graphics/view_allocator.h"
 #include "mesh_renderer.h"
+#include "occluder.h"
 
 namespace engine {
     Camera::Camera(entt::registry &registry)
@@ -11,26 +14,83 @@ namespace engine {
         , transform_ptr_{&get_gameobject().get_or_add_component<Transform>()} {
     }
 
+    bool Camera::rasterize_occluders(
+            std::span<float const, 4 * 4> view_proj, Frustum const &frustum
+    ) const {
+        auto const occluders = get_registry().view<Occluder const>();
+        if (occluders.empty())
+            return false;
+
+        occlusion_buffer_.begin(view_proj);
+        for (auto const &[entity, occluder] : occluders.each()) {
+            if (frustum.intersects(occluder.get_world_bounds()))
+                occluder.rasterize(occlusion_buffer_);
+        }
+        occlusion_buffer_.build_hierarchy();
+
+        return true;
+    }
+
     void Camera::render(Game const &game) const {
         math::SquareMatrix<> const view_mat =
                 transform_ptr_->get_view_matrix().transpose();
 
-        auto const &app = Application::get_instance();
-        float       proj[16];
+        auto const     &app        = Application::get_instance();
+        constexpr float near_plane = 0.1f;
+        constexpr float far_plane  = 10000.0f;
+        float           proj[16];
         bx::mtxProj(
                 proj, 60.0f,
                 static_cast<float>(app.get_width()) /
                         static_cast<float>(app.get_height()),
-                0.1f, 10000.0f, bgfx::getCaps()->homogeneousDepth
+                near_plane, far_plane, bgfx::getCaps()->homogeneousDepth
+        );
+
+        auto              &view_allocator = ViewAllocator::get_instance();
+        RenderQueue::Views views{};
+        if (depth_prepass_) {
+            views.depth_prepass_ = view_allocator.allocate("Depth prepass");
+            bgfx::setViewTransform(
+                    *views.depth_prepass_, view_mat.get_span().data(), proj
+            );
+        }
+        views.opaque_ = view_allocator.allocate("Opaque");
+        bgfx::setViewTransform(views.opaque_, view_mat.get_span().data(), proj);
+
+        float view_proj[16];
+        bx::mtxMul(view_proj, view_mat.get_span().data(), proj);
+        auto const frustum = Frustum::from_view_projection(
+                view_proj, bgfx::getCaps()->homogeneousDepth
         );
-        bgfx::setViewTransform(0, view_mat.get_span().data(), proj);
 
         {
-            auto const mesh_renderers = get_registry().view<MeshRenderer>();
+            auto const &registry      = get_registry();
+            auto const &spatial_index = registry.ctx().get<SpatialIndex>();
+
+            LodSelection lod_selection{};
+            lod_selection.pixels_per_unit_ =
+                    proj[5] * static_cast<float>(app.get_height()) / 2.f;
+            lod_selection.max_error_pixels_ = max_lod_error_pixels_;
+
+            bool const has_occluders = rasterize_occluders(view_proj, frustum);
+            render_queue_.begin(
+                    view_mat.get_span(), far_plane, frustum,
+                    {proj[5], min_projected_size_}, lod_selection,
+                    has_occluders ? &occlusion_buffer_ : nullptr
+            );
+
+            spatial_index.query(frustum, [&](entt::entity entity) {
+                auto const &renderer = registry.get<MeshRenderer>(entity);
+
+                // Renderers that are hidden as a whole skip collecting their draws, the render queue tests each of
+                // their primitives as well.
+                if (has_occluders &&
+                    occlusion_buffer_.is_occluded(renderer.get_world_bounds()))
+                    return;
 
-            mesh_renderers.each([](auto const &mesh_renderer) {
-                mesh_renderer.render();
+                renderer.collect(render_queue_);
             });
+            render_queue_.submit(views);
 
             game.render();
         }
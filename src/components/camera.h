@@ -2,6 +2,8 @@
 #define CAMERA_H
 
 #include "component.h"
+#include "graphics/occlusion_buffer.h"
+#include "graphics/render_queue.h"
 #include "transform.h"
 
 namespace engine {
@@ -12,12 +14,37 @@ namespace engine {
         , public Updatable {
         Transform const                 *transform_ptr_;
         mutable std::array<float, 4 * 4> view_mat_{};
+        mutable RenderQueue              render_queue_{};
+        mutable OcclusionBuffer          occlusion_buffer_{256, 128};
+        float                            min_projected_size_{};
+        float                            max_lod_error_pixels_{1.f};
+        bool                             depth_prepass_{true};
+
+        // Rasterizes the occluders in view, returns whether there were any.
+        bool rasterize_occluders(
+                std::span<float const, 4 * 4> view_proj, Frustum const &frustum
+        ) const;
 
     public:
         explicit Camera(entt::registry &registry);
 
         void render(Game const &game) const;
 
+        // Primitives whose bounds cover less than this fraction of the viewport height are not drawn, 0 disables this.
+        void set_min_projected_size(float min_projected_size) {
+            min_projected_size_ = min_projected_size;
+        }
+
+        // Primitives are drawn with the coarsest level of detail whose error covers at most this many pixels.
+        void set_max_lod_error_pixels(float max_lod_error_pixels) {
+            max_lod_error_pixels_ = max_lod_error_pixels;
+        }
+
+        // Draws the depth of everything in a separate view before shading it, so each pixel is only shaded once.
+        void set_depth_prepass(bool depth_prepass) {
+            depth_prepass_ = depth_prepass;
+        }
+
         void update() override;
     };
 }// namespace engine
@@ -35,6 +35,11 @@ namespace engine {
             return *registry_;
         }
 
+        [[nodiscard]]
+        entt::registry &get_registry() {
+            return *registry_;
+        }
+
     public:
         explicit Component(entt::registry &registry)
             : registry_(&registry) {
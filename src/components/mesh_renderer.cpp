@@ -1,51 +1,112 @@
 #include "mesh_renderer.h"
 
-#include <bx/math.h>
+#include <algorithm>
+#include <cassert>
+#include <optional>
 
+#include "graphics/lod_selection.h"
+#include "graphics/render_queue.h"
 #include "transform.h"
 
 namespace engine {
-    MeshRenderer::MeshRenderer(
-            entt::registry &registry, std::unique_ptr<Mesh> mesh_uptr
-    )
+    namespace {
+        // Keeps the projected error finite for primitives the camera is inside of.
+        constexpr float min_lod_distance = 0.01f;
+
+        // Largest scale along any axis of a matrix in the layout passed to bgfx.
+        [[nodiscard]]
+        float get_max_scale(std::array<float, 4 * 4> const &transform) {
+            float max_scale{};
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                math::Vec3 const scaled_axis{
+                        transform[axis * 4], transform[axis * 4 + 1],
+                        transform[axis * 4 + 2]
+                };
+                max_scale = std::max(max_scale, scaled_axis.get_magnitude());
+            }
+
+            return max_scale;
+        }
+    }// namespace
+
+    MeshRenderer::MeshRenderer(entt::registry &registry, MeshHandle mesh)
         : Component{registry}
         , transform_ptr_{&get_gameobject().get_or_add_component<Transform>()}
-        , mesh_uptr_{std::move(mesh_uptr)} {
+        , mesh_{std::move(mesh)} {
     }
 
-    void MeshRenderer::render() const {
-        auto const &texture_store     = TextureStore::get_instance();
-        auto const &base_color_factor = texture_store.get_base_color_factor();
-
-        for (auto const &primitive : mesh_uptr_->primitives_) {
-            uint64_t state = BGFX_STATE_DEFAULT | BGFX_STATE_WRITE_RGB |
-                             BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z |
-                             BGFX_STATE_DEPTH_TEST_LESS | BGFX_STATE_MSAA |
-                             BGFX_STATE_FRONT_CCW;
-            state |= primitive.get_format() ==
-                                     Primitive::IndexFormat::TriangleStrip
-                           ? BGFX_STATE_PT_TRISTRIP
-                           : 0;
-
-            bgfx::setVertexBuffer(0, primitive.get_vertex_buffer());
-            bgfx::setIndexBuffer(primitive.get_index_buffer());
-            bgfx::setUniform(
-                    base_color_factor,
-                    primitive.get_base_color_factor().get_data().data()
-            );
+    std::array<float, 4 * 4> MeshRenderer::get_world_matrix() const {
+        auto const trans_mat =
+                transform_ptr_->get_transform_matrix().transpose();
+
+        assert(trans_mat.get_span().size() == 4 * 4);
+        std::array<float, 4 * 4> transform;
+        std::ranges::copy(trans_mat.get_span(), transform.begin());
+
+        return transform;
+    }
+
+    void MeshRenderer::collect(RenderQueue &render_queue) const {
+        auto const transform = get_world_matrix();
+
+        // Shared by all primitives with unpacked vertices, added once the first of them needs it.
+        std::optional<uint32_t> transform_index{};
 
-            auto const &texture_indices = primitive.get_texture_indices();
-            if (texture_indices.albedo_) {
-                texture_indices.albedo_->submit(TextureType::Albedo, 0);
+        // Errors are in the space of the mesh, scaling the distance instead scales all of them at once.
+        float const scale = get_max_scale(transform);
+        lod_indices_.resize(mesh_->primitives_.size());
+
+        for (std::size_t i = 0; i < mesh_->primitives_.size(); ++i) {
+            auto const &primitive    = mesh_->primitives_[i];
+            auto const &quantization = primitive.get_position_quantization();
+            auto const  world_bounds =
+                    primitive.get_bounds().transformed(transform);
+
+            uint32_t primitive_transform_index;
+            if (quantization) {
+                // Packed positions are dequantized by the model matrix.
+                primitive_transform_index = render_queue.add_transform(
+                        quantization->apply(transform)
+                );
+            } else {
+                if (!transform_index)
+                    transform_index = render_queue.add_transform(transform);
+
+                primitive_transform_index = *transform_index;
             }
 
-            auto const trans_mat =
-                    transform_ptr_->get_transform_matrix().transpose();
+            // Distance to the closest point of the bounding sphere, the error is largest there.
+            auto const  to_center = world_bounds.get_center() -
+                                   render_queue.get_camera_position();
+            float const distance  = std::max(
+                    to_center.get_magnitude() -
+                            world_bounds.get_extents().get_magnitude(),
+                    min_lod_distance
+            );
+            auto const lod = select_lod(
+                    primitive.get_lod_errors(),
+                    scale > 0.f ? distance / scale : distance, lod_indices_[i],
+                    render_queue.get_lod_selection()
+            );
+            lod_indices_[i] = static_cast<uint8_t>(lod);
 
-            assert(trans_mat.get_span().size() == 4 * 4);
-            bgfx::setTransform(trans_mat.get_span().data());
-            bgfx::setState(state);
-            bgfx::submit(0, program_uptr_.get());
+            render_queue.add(
+                    primitive, lod, program_.get(), instanced_program_.get(),
+                    primitive_transform_index, world_bounds
+            );
         }
     }
+
+    math::Aabb MeshRenderer::get_world_bounds() const {
+        auto const transform = get_world_matrix();
+
+        auto bounds = math::Aabb::empty();
+        for (auto const &primitive : mesh_->primitives_) {
+            auto const primitive_bounds =
+                    primitive.get_bounds().transformed(transform);
+            bounds = bounds.merged(primitive_bounds);
+        }
+
+        return bounds;
+    }
 }// namespace engine
@@ -1,28 +1,45 @@
 #ifndef MESH_RENDERER_H
 #define MESH_RENDERER_H
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include "component.h"
 #include "graphics/mesh.h"
-#include "misc/utils.h"
+#include "math/aabb.h"
+#include "mesh_store.h"
+#include "shader_store.h"
 #include "types.h"
 
 namespace engine {
+    class RenderQueue;
     class Transform;
 
-    // TODO: the mesh renderer should not own the mesh, the mesh should be a separate component
     class MeshRenderer : public Component<MeshRenderer> {
-        Transform const      *transform_ptr_{};
-        std::unique_ptr<Mesh> mesh_uptr_;
-        ShaderUPtr  vert_shader_uptr_{utils::load_shader("cube_vert")};
-        ShaderUPtr  frag_shader_uptr_{utils::load_shader("cube_frag")};
-        ProgramUPtr program_uptr_{bgfx::createProgram(
-                vert_shader_uptr_.get(), frag_shader_uptr_.get(), true
+        Transform const *transform_ptr_{};
+        MeshHandle       mesh_;
+        ProgramHandle    program_{ShaderStore::get_instance().get_program(
+                "cube_vert", "cube_frag"
         )};
+        ProgramHandle    instanced_program_{
+                ShaderStore::get_instance().get_program(
+                        "cube_instanced_vert", "cube_frag"
+                )
+        };
+        // The level of detail each primitive was drawn with last, which selection starts from.
+        mutable std::vector<uint8_t> lod_indices_{};
+
+        [[nodiscard]]
+        std::array<float, 4 * 4> get_world_matrix() const;
 
     public:
-        MeshRenderer(entt::registry &registry, std::unique_ptr<Mesh> mesh);
+        MeshRenderer(entt::registry &registry, MeshHandle mesh);
+
+        void collect(RenderQueue &render_queue) const;
 
-        void render() const;
+        [[nodiscard]]
+        math::Aabb get_world_bounds() const;
     };
 }// namespace engine
 
@@ -0,0 +1,39 @@
+#include "occluder.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "graphics/occlusion_buffer.h"
+#include "transform.h"
+
+namespace engine {
+    Occluder::Occluder(
+            entt::registry                     &registry,
+            std::shared_ptr<OccluderMesh const> mesh
+    )
+        : Component{registry}
+        , transform_ptr_{&get_gameobject().get_or_add_component<Transform>()}
+        , mesh_{std::move(mesh)} {
+    }
+
+    std::array<float, 4 * 4> Occluder::get_world_matrix() const {
+        auto const trans_mat =
+                transform_ptr_->get_transform_matrix().transpose();
+
+        assert(trans_mat.get_span().size() == 4 * 4);
+        std::array<float, 4 * 4> transform;
+        std::ranges::copy(trans_mat.get_span(), transform.begin());
+
+        return transform;
+    }
+
+    void Occluder::rasterize(OcclusionBuffer &occlusion_buffer) const {
+        occlusion_buffer.rasterize(
+                mesh_->positions_, mesh_->indices_, get_world_matrix()
+        );
+    }
+
+    math::Aabb Occluder::get_world_bounds() const {
+        return mesh_->bounds_.transformed(get_world_matrix());
+    }
+}// namespace engine
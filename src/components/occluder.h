@@ -0,0 +1,45 @@
+#ifndef OCCLUDER_H
+#define OCCLUDER_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "component.h"
+#include "math/aabb.h"
+#include "math/vec.h"
+
+namespace engine {
+    class OcclusionBuffer;
+    class Transform;
+
+    // Simplified triangle list geometry that hides what is behind it, in the space of the mesh.
+    struct OccluderMesh final {
+        std::vector<math::Vec3> positions_{};
+        std::vector<uint32_t>   indices_{};
+        math::Aabb              bounds_{math::Aabb::empty()};
+    };
+
+    // Marks the game object as an occluder, its mesh is rasterized into the camera's occlusion buffer.
+    class Occluder final : public Component<Occluder> {
+        Transform const                    *transform_ptr_{};
+        std::shared_ptr<OccluderMesh const> mesh_;
+
+        [[nodiscard]]
+        std::array<float, 4 * 4> get_world_matrix() const;
+
+    public:
+        Occluder(
+                entt::registry                     &registry,
+                std::shared_ptr<OccluderMesh const> mesh
+        );
+
+        void rasterize(OcclusionBuffer &occlusion_buffer) const;
+
+        [[nodiscard]]
+        math::Aabb get_world_bounds() const;
+    };
+}// namespace engine
+
+#endif//OCCLUDER_H
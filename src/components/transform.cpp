@@ -3,6 +3,16 @@
 #include "api_internal/math/vec_utils.h"
 
 namespace engine {
+    void mark_transform_moved(entt::registry &registry, entt::entity entity) {
+        registry.emplace_or_replace<TransformMoved>(entity);
+
+        if (auto const *relationship = registry.try_get<Relationship>(entity)) {
+            for (auto const child : relationship->children) {
+                mark_transform_moved(registry, child);
+            }
+        }
+    }
+
     math::SquareMatrix<> Transform::get_view_matrix() const {
         math::SquareMatrix<> start_mat{};
 
@@ -95,8 +105,16 @@ namespace engine {
         return transform_;
     }
 
+    void Transform::mark_moved() {
+        auto &registry = get_registry();
+        mark_transform_moved(
+                registry, entt::to_entity(registry.storage<Transform>(), *this)
+        );
+    }
+
     void Transform::translate(math::Vec3 const &translation) {
         position_ += translation;
+        mark_moved();
     }
 
     math::Vec3 Transform::orient_vec(math::Vec3 const &vec) const {
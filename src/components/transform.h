@@ -10,6 +10,12 @@
 namespace engine {
     class Camera;
 
+    // Tag for entities whose world transform changed since the spatial index was last updated.
+    struct TransformMoved final {};
+
+    // Tags the entity and all of its descendants with TransformMoved.
+    void mark_transform_moved(entt::registry &registry, entt::entity entity);
+
     class Transform final : public Component<Transform> {
         mutable math::SquareMatrix<> transform_{};
         Dirty<math::Vec3>            position_{};
@@ -21,6 +27,8 @@ namespace engine {
         [[nodiscard]]
         math::SquareMatrix<> get_view_matrix() const;
 
+        void mark_moved();
+
     public:
         using Component::Component;
 
@@ -28,18 +36,21 @@ namespace engine {
             requires std::constructible_from<math::Vec3, Args...>
         void set_position(Args &&...args) {
             position_ = math::Vec3{std::forward<Args>(args)...};
+            mark_moved();
         }
 
         template<class... Args>
             requires std::constructible_from<math::Vec3, Args...>
         void set_scale(Args &&...args) {
             scale_ = math::Vec3{std::forward<Args>(args)...};
+            mark_moved();
         }
 
         template<class... Args>
             requires std::constructible_from<math::Quaternion, Args...>
         void set_rotation(Args &&...args) {
             rotation_ = math::Quaternion(std::forward<Args>(args)...);
+            mark_moved();
         }
 
         [[nodiscard]]
@@ -1,10 +0,0 @@
-#ifndef ENGINE_CONSTANTS
-#define ENGINE_CONSTANTS
-
-#include <bgfx/bgfx.h>
-
-namespace engine::core::constants {
-    constexpr bgfx::ViewId clear_view = 0;
-}
-
-#endif
@@ -6,10 +6,14 @@
 #include <memory>
 
 #include "application.h"
-#include "constants.h"
+#include "graphics/geometry_pool.h"
+#include "graphics/view_allocator.h"
 #include "input/mouse_keyboard_input.h"
+#include "mesh_store.h"
 #include "misc/service_locator.h"
 #include "presentation/game_host.h"
+#include "shader_store.h"
+#include "texture_store.h"
 #include "types.h"
 
 namespace engine {
@@ -53,14 +57,9 @@ namespace engine {
 
             constexpr auto clear_color = 0x264B56FF;
             // constexpr auto clear_color = 0x000000FF;// Black
-            bgfx::setViewClear(
-                    0, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, clear_color, 1.0f, 0
-            );
-            bgfx::setViewRect(
-                    core::constants::clear_view, 0, 0,
-                    bgfx::BackbufferRatio::Equal
-            );
+            ViewAllocator::get_instance().set_clear_color(clear_color);
             Vertex::setup_layout();
+            PackedVertex::setup_layout();
             game_ptr_->setup();
         }
 
@@ -73,14 +72,14 @@ namespace engine {
                 height         = res.height;
             });
 
-            // This dummy draw call is here to make sure that view 0 is cleared if no
-            // other draw calls are submitted to view 0.
-            bgfx::touch(core::constants::clear_view);
+            // This dummy draw call makes sure the clear view is cleared, nothing else is drawn into it.
+            bgfx::touch(ViewAllocator::get_instance().begin_frame());
             bgfx::dbgTextClear();
 
             bgfx::setDebug(BGFX_DEBUG_TEXT);
 
             ServiceLocator<KeyboardMouseInputService>::Get().process_input();
+            TextureStore::get_instance().upload_streamed_textures();
 
             if (app.has_active_scene()) {
                 game_ptr_->update();
@@ -88,6 +87,7 @@ namespace engine {
                 scene.update();
                 scene.render(*game_ptr_);
             }
+            TextureStore::get_instance().update_residency();
 
             bgfx::frame();
         }
@@ -111,6 +111,9 @@ namespace engine {
     void Engine::cleanup() {
         TextureStore::get_instance().clear();
         Application::get_instance().clear_active_scene();
+        MeshStore::get_instance().clear();
+        GeometryPool::get_instance().clear();
+        ShaderStore::get_instance().clear();
         bgfx::shutdown();
         delete impl_ptr_;
     }
@@ -9,8 +9,11 @@
 #include "graphics/mesh.h"
 #include "scene.h"
 #include "scene_loaders/gltf_loader.h"
+#include "texture_store.h"
 
 namespace game {
+    static constexpr std::size_t texture_residency_budget = 256u << 20;
+
     static std::array verts = {
             // Front (+Z)
             engine::Vertex{-1, 1, 1, 0x0000, 0x0000},  // 0
@@ -78,7 +81,22 @@ namespace game {
                         "SCENE environment variable is not set"
                 };
             }
-            engine::load_gltf_scene(scene, scene_path);
+            engine::GltfLoadOptions options;
+            options.optimize_meshes_   = true;
+            options.lod_count_         = 3;
+            options.compress_textures_ = true;
+            options.stream_textures_   = true;
+            options.cache_directory_   = "cache";
+            // Sponza is a single mesh of walls, columns and floors, the loader leaves its cut-out foliage and fabrics
+            // out of the occluder. Its bounds contain the camera, so it hides its own primitives, not the whole mesh.
+            options.is_occluder_ = [](std::string_view,
+                                      engine::math::Aabb const &) {
+                return true;
+            };
+            engine::TextureStore::get_instance().set_residency_budget(
+                    texture_residency_budget
+            );
+            engine::load_gltf_scene(scene, scene_path, nullptr, options);
             std::cout << "GLTF Scene loaded" << std::endl;
         }
 
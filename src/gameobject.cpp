@@ -1,6 +1,7 @@
 #include "gameobject.h"
 
 #include "components/camera.h"
+#include "components/transform.h"
 #include "scene.h"
 
 namespace engine {
@@ -40,6 +41,8 @@ namespace engine {
                         )
                         .children;
         parent_children.emplace(entity_);
+
+        mark_transform_moved(*registry_, entity_);
     }
 
     GameObject *GameObject::get_parent() const {
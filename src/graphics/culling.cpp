@@ -0,0 +1,252 @@
+#include "culling.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) ||                                     \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ENGINE_CULLING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace engine {
+    namespace {
+        constexpr std::size_t simd_width = 4;
+
+        using PlaneCoefficients = std::array<float, 4>;
+
+        [[nodiscard]]
+        Plane make_plane(PlaneCoefficients const &coefficients) {
+            math::Vec3 const normal{
+                    coefficients[0], coefficients[1], coefficients[2]
+            };
+            float const length = normal.get_magnitude();
+
+            return Plane{normal / length, coefficients[3] / length};
+        }
+
+        [[nodiscard]]
+        bool is_outside(
+                Plane const &plane, math::Vec3 const &center,
+                math::Vec3 const &extents
+        ) {
+            float const distance = plane.normal_.dot(center) + plane.distance_;
+            float const radius =
+                    std::abs(plane.normal_.get_x()) * extents.get_x() +
+                    std::abs(plane.normal_.get_y()) * extents.get_y() +
+                    std::abs(plane.normal_.get_z()) * extents.get_z();
+
+            return distance + radius < 0.f;
+        }
+
+        [[nodiscard]]
+        PlaneCoefficients
+        add(PlaneCoefficients const &lhs, PlaneCoefficients const &rhs) {
+            return {lhs[0] + rhs[0], lhs[1] + rhs[1], lhs[2] + rhs[2],
+                    lhs[3] + rhs[3]};
+        }
+
+        [[nodiscard]]
+        PlaneCoefficients
+        subtract(PlaneCoefficients const &lhs, PlaneCoefficients const &rhs) {
+            return {lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2],
+                    lhs[3] - rhs[3]};
+        }
+
+#ifndef ENGINE_CULLING_SSE
+        [[nodiscard]]
+        bool is_visible(
+                Frustum const &frustum, ProjectedSizeCutoff const &size_cutoff,
+                math::Vec3 const &center, math::Vec3 const &extents
+        ) {
+            if (!frustum.intersects({center - extents, center + extents}))
+                return false;
+
+            auto const &near_plane = frustum.get_planes()[Frustum::Near];
+            float const depth =
+                    near_plane.normal_.dot(center) + near_plane.distance_;
+
+            return extents.get_magnitude() * size_cutoff.projection_scale_ >=
+                   size_cutoff.min_size_ * std::max(depth, 0.f);
+        }
+#endif
+    }// namespace
+
+    Frustum Frustum::from_view_projection(
+            std::span<float const, 4 * 4> view_proj, bool homogeneous_depth
+    ) {
+        auto const column = [&view_proj](std::size_t index) {
+            return PlaneCoefficients{
+                    view_proj[index], view_proj[4 + index],
+                    view_proj[8 + index], view_proj[12 + index]
+            };
+        };
+
+        auto const x = column(0);
+        auto const y = column(1);
+        auto const z = column(2);
+        auto const w = column(3);
+
+        Frustum frustum;
+        auto   &planes = frustum.planes_;
+
+        planes[Left]   = make_plane(add(w, x));
+        planes[Right]  = make_plane(subtract(w, x));
+        planes[Bottom] = make_plane(add(w, y));
+        planes[Top]    = make_plane(subtract(w, y));
+        // Clip space depth starts at -w with OpenGL-style depth and at 0 otherwise.
+        planes[Near] = make_plane(homogeneous_depth ? add(w, z) : z);
+        planes[Far]  = make_plane(subtract(w, z));
+
+        return frustum;
+    }
+
+    Frustum Frustum::to_local_space(std::span<float const, 4 * 4> model
+    ) const {
+        Frustum local;
+        for (std::size_t plane_idx = 0; plane_idx < planes_.size();
+             ++plane_idx) {
+            auto const &[normal, distance] = planes_[plane_idx];
+            auto const row = [&model](std::size_t index) {
+                return math::Vec3{
+                        model[index * 4], model[index * 4 + 1],
+                        model[index * 4 + 2]
+                };
+            };
+
+            local.planes_[plane_idx] = make_plane({
+                    normal.dot(row(0)), normal.dot(row(1)), normal.dot(row(2)),
+                    normal.dot(row(3)) + distance
+            });
+        }
+
+        return local;
+    }
+
+    bool Frustum::intersects(math::Aabb const &bounds) const {
+        auto const center  = bounds.get_center();
+        auto const extents = bounds.get_extents();
+
+        return std::ranges::none_of(planes_, [&](Plane const &plane) {
+            return is_outside(plane, center, extents);
+        });
+    }
+
+    void BoundsCuller::clear() {
+        count_ = 0;
+        center_x_.clear();
+        center_y_.clear();
+        center_z_.clear();
+        extent_x_.clear();
+        extent_y_.clear();
+        extent_z_.clear();
+    }
+
+    uint32_t BoundsCuller::add(math::Aabb const &bounds) {
+        // The arrays are kept padded to a multiple of the SIMD width, so the last group can be loaded as a whole.
+        if (count_ % simd_width == 0) {
+            std::size_t const padded_size = count_ + simd_width;
+            center_x_.resize(padded_size);
+            center_y_.resize(padded_size);
+            center_z_.resize(padded_size);
+            extent_x_.resize(padded_size);
+            extent_y_.resize(padded_size);
+            extent_z_.resize(padded_size);
+        }
+
+        auto const center  = bounds.get_center();
+        auto const extents = bounds.get_extents();
+
+        center_x_[count_] = center.get_x();
+        center_y_[count_] = center.get_y();
+        center_z_[count_] = center.get_z();
+        extent_x_[count_] = extents.get_x();
+        extent_y_[count_] = extents.get_y();
+        extent_z_[count_] = extents.get_z();
+
+        return static_cast<uint32_t>(count_++);
+    }
+
+    void BoundsCuller::cull(
+            Frustum const &frustum, ProjectedSizeCutoff const &size_cutoff,
+            std::vector<uint8_t> &visible
+    ) const {
+        visible.resize(count_);
+
+#ifdef ENGINE_CULLING_SSE
+        auto const &planes = frustum.get_planes();
+
+        __m128 const zero       = _mm_setzero_ps();
+        __m128 const sign_mask  = _mm_set1_ps(-0.f);
+        __m128 const proj_scale = _mm_set1_ps(size_cutoff.projection_scale_);
+        __m128 const min_size   = _mm_set1_ps(size_cutoff.min_size_);
+
+        for (std::size_t first = 0; first < count_; first += simd_width) {
+            __m128 const cx = _mm_loadu_ps(center_x_.data() + first);
+            __m128 const cy = _mm_loadu_ps(center_y_.data() + first);
+            __m128 const cz = _mm_loadu_ps(center_z_.data() + first);
+            __m128 const ex = _mm_loadu_ps(extent_x_.data() + first);
+            __m128 const ey = _mm_loadu_ps(extent_y_.data() + first);
+            __m128 const ez = _mm_loadu_ps(extent_z_.data() + first);
+
+            __m128 inside = _mm_cmpeq_ps(zero, zero);
+            __m128 depth  = zero;
+
+            for (std::size_t plane_idx = 0; plane_idx < planes.size();
+                 ++plane_idx) {
+                auto const &plane = planes[plane_idx];
+                __m128 const nx   = _mm_set1_ps(plane.normal_.get_x());
+                __m128 const ny   = _mm_set1_ps(plane.normal_.get_y());
+                __m128 const nz   = _mm_set1_ps(plane.normal_.get_z());
+
+                __m128 distance = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                        _mm_add_ps(
+                                _mm_mul_ps(nz, cz),
+                                _mm_set1_ps(plane.distance_)
+                        )
+                );
+                __m128 const radius = _mm_add_ps(
+                        _mm_add_ps(
+                                _mm_mul_ps(_mm_andnot_ps(sign_mask, nx), ex),
+                                _mm_mul_ps(_mm_andnot_ps(sign_mask, ny), ey)
+                        ),
+                        _mm_mul_ps(_mm_andnot_ps(sign_mask, nz), ez)
+                );
+
+                if (plane_idx == Frustum::Near) {
+                    depth = _mm_max_ps(distance, zero);
+                }
+
+                distance = _mm_add_ps(distance, radius);
+                inside   = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+            }
+
+            __m128 const sphere_radius = _mm_sqrt_ps(_mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)),
+                    _mm_mul_ps(ez, ez)
+            ));
+            __m128 const large_enough = _mm_cmpge_ps(
+                    _mm_mul_ps(sphere_radius, proj_scale),
+                    _mm_mul_ps(min_size, depth)
+            );
+            inside = _mm_and_ps(inside, large_enough);
+
+            int const         mask  = _mm_movemask_ps(inside);
+            std::size_t const count = std::min(simd_width, count_ - first);
+            for (std::size_t i = 0; i < count; ++i) {
+                visible[first + i] = static_cast<uint8_t>((mask >> i) & 1);
+            }
+        }
+#else
+        for (std::size_t i = 0; i < count_; ++i) {
+            math::Vec3 const center{center_x_[i], center_y_[i], center_z_[i]};
+            math::Vec3 const extents{extent_x_[i], extent_y_[i], extent_z_[i]};
+
+            visible[i] = static_cast<uint8_t>(
+                    is_visible(frustum, size_cutoff, center, extents)
+            );
+        }
+#endif
+    }
+}// namespace engine
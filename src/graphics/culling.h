@@ -0,0 +1,94 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "math/aabb.h"
+
+namespace engine {
+    // Points for which normal.dot(point) + distance >= 0 lie on the inner side of the plane.
+    struct Plane final {
+        math::Vec3 normal_{};
+        float      distance_{};
+    };
+
+    class Frustum final {
+    public:
+        enum PlaneIndex : std::size_t {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            PlaneCount,
+        };
+
+        using Planes = std::array<Plane, PlaneCount>;
+
+        Frustum() = default;
+
+        // Extracts the (normalized) planes from a view-projection matrix in the layout used by bx and bgfx.
+        [[nodiscard]]
+        static Frustum from_view_projection(
+                std::span<float const, 4 * 4> view_proj, bool homogeneous_depth
+        );
+
+        [[nodiscard]]
+        Planes const &get_planes() const {
+            return planes_;
+        }
+
+        // The same frustum in the local space of `model`, laid out like the matrices passed to bgfx.
+        [[nodiscard]]
+        Frustum to_local_space(std::span<float const, 4 * 4> model) const;
+
+        // Whether the box is at least partially inside the frustum.
+        [[nodiscard]]
+        bool intersects(math::Aabb const &bounds) const;
+
+    private:
+        Planes planes_{};
+    };
+
+    // Bounds that project to less than `min_size_` of the viewport height are culled.
+    // `projection_scale_` is the vertical scale of the projection matrix, cot(fov_y / 2).
+    struct ProjectedSizeCutoff final {
+        float projection_scale_{1.f};
+        float min_size_{0.f};
+    };
+
+    // Tests many bounding boxes against a frustum at once. Boxes are stored as center/extents in separate arrays so
+    // that four of them are tested against a plane with a single set of SIMD operations.
+    class BoundsCuller final {
+    public:
+        void clear();
+
+        // Returns the index of the box in the visibility results.
+        uint32_t add(math::Aabb const &bounds);
+
+        [[nodiscard]]
+        std::size_t get_count() const {
+            return count_;
+        }
+
+        // Writes 1 for each box that is (partially) inside the frustum and large enough on screen, 0 otherwise.
+        void
+        cull(Frustum const &frustum, ProjectedSizeCutoff const &size_cutoff,
+             std::vector<uint8_t> &visible) const;
+
+    private:
+        std::size_t        count_{};
+        std::vector<float> center_x_;
+        std::vector<float> center_y_;
+        std::vector<float> center_z_;
+        std::vector<float> extent_x_;
+        std::vector<float> extent_y_;
+        std::vector<float> extent_z_;
+    };
+}// namespace engine
+
+#endif//CULLING_H
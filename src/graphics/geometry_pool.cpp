@@ -0,0 +1,126 @@
+#include "geometry_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "misc/utils.h"
+
+namespace engine {
+    void GeometryRangeReleaser::operator()(GeometryRange const &range) const {
+        GeometryPool::get_instance().free(range);
+    }
+
+    bgfx::VertexLayout const &GeometryPool::get_layout(VertexFormat format) {
+        switch (format) {
+            case VertexFormat::Float:
+                return Vertex::layout;
+            case VertexFormat::Packed:
+                return PackedVertex::layout;
+            default:
+                throw std::runtime_error{"Unknown vertex format"};
+        }
+    }
+
+    GeometryRangeUPtr GeometryPool::allocate(
+            VertexFormat format, std::span<std::byte const> vertex_data,
+            IndexWidth index_width, std::span<std::byte const> index_data
+    ) {
+        std::size_t const vertex_stride = get_layout(format).getStride();
+        std::size_t const index_stride =
+                index_width == IndexWidth::Bits16 ? sizeof(uint16_t)
+                                                  : sizeof(uint32_t);
+        if (vertex_data.empty() || index_data.empty() ||
+            vertex_data.size() % vertex_stride != 0 ||
+            index_data.size() % index_stride != 0)
+            throw std::runtime_error{"Primitive without valid geometry"};
+
+        GeometryRange range{};
+        range.format_       = format;
+        range.vertex_count_ =
+                static_cast<uint32_t>(vertex_data.size() / vertex_stride);
+        range.index_count_ =
+                static_cast<uint32_t>(index_data.size() / index_stride);
+
+        auto const try_allocate = [&](Page &page) {
+            if (page.format_ != format || page.index_width_ != index_width)
+                return false;
+
+            auto const base_vertex =
+                    page.vertex_ranges_.allocate(range.vertex_count_);
+            if (!base_vertex)
+                return false;
+
+            auto const first_index =
+                    page.index_ranges_.allocate(range.index_count_);
+            if (!first_index) {
+                page.vertex_ranges_.free(*base_vertex, range.vertex_count_);
+                return false;
+            }
+
+            range.base_vertex_ = *base_vertex;
+            range.first_index_ = *first_index;
+            return true;
+        };
+
+        uint32_t page_index{};
+        while (page_index < pages_.size() &&
+               !try_allocate(pages_[page_index])) {
+            ++page_index;
+        }
+
+        if (page_index == pages_.size()) {
+            // Primitives larger than a page get a page of their own.
+            uint32_t const vertex_capacity =
+                    std::max(range.vertex_count_, page_vertex_capacity);
+            uint32_t const index_capacity =
+                    std::max(range.index_count_, page_index_capacity);
+
+            pages_.push_back(Page{
+                    format,
+                    index_width,
+                    DynamicVertexBufferUPtr{utils::verify_bgfx_handle(
+                            bgfx::createDynamicVertexBuffer(
+                                    vertex_capacity, get_layout(format)
+                            ),
+                            "failed to create pooled vertex buffer"
+                    )},
+                    DynamicIndexBufferUPtr{utils::verify_bgfx_handle(
+                            bgfx::createDynamicIndexBuffer(
+                                    index_capacity,
+                                    index_width == IndexWidth::Bits32
+                                            ? BGFX_BUFFER_INDEX32
+                                            : BGFX_BUFFER_NONE
+                            ),
+                            "failed to create pooled index buffer"
+                    )},
+                    RangeAllocator{vertex_capacity},
+                    RangeAllocator{index_capacity}
+            });
+            try_allocate(pages_.back());
+        }
+
+        range.page_index_ = page_index;
+
+        auto const &page = pages_[page_index];
+        bgfx::update(
+                page.vertex_buffer_.get(), range.base_vertex_,
+                bgfx::copy(vertex_data.data(), vertex_data.size())
+        );
+        bgfx::update(
+                page.index_buffer_.get(), range.first_index_,
+                bgfx::copy(index_data.data(), index_data.size())
+        );
+
+        return GeometryRangeUPtr{std::move(range)};
+    }
+
+    void GeometryPool::free(GeometryRange const &range) {
+        // Ranges may outlive a cleared pool during shutdown.
+        if (range.page_index_ >= pages_.size())
+            return;
+
+        auto &page = pages_[range.page_index_];
+        page.vertex_ranges_.free(range.base_vertex_, range.vertex_count_);
+        page.index_ranges_.free(range.first_index_, range.index_count_);
+    }
+}// namespace engine
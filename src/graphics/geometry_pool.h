@@ -0,0 +1,95 @@
+#ifndef GEOMETRY_POOL_H
+#define GEOMETRY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "misc/range_allocator.h"
+#include "misc/singleton.h"
+#include "misc/unique_handle.h"
+#include "types.h"
+
+namespace engine {
+    // Where the geometry of a primitive lives in the GeometryPool. Indices are relative to `base_vertex_`.
+    struct GeometryRange final {
+        VertexFormat format_{};
+        uint32_t     page_index_{};
+        uint32_t     base_vertex_{};
+        uint32_t     vertex_count_{};
+        uint32_t     first_index_{};
+        uint32_t     index_count_{};
+
+        [[nodiscard]]
+        bool operator==(GeometryRange const &) const = default;
+    };
+
+    struct GeometryRangeReleaser final {
+        void operator()(GeometryRange const &range) const;
+    };
+
+    using GeometryRangeUPtr =
+            UniqueHandle<GeometryRange, GeometryRange{}, GeometryRangeReleaser>;
+
+    // Packs the vertices and indices of all loaded primitives into a few large GPU buffers, so that primitives are
+    // drawn from offsets into shared buffers instead of each owning a pair of small ones.
+    // Buffers are allocated in pages, a new page is only created once no existing page has room for a primitive.
+    // Each page holds vertices of a single format and indices of a single width.
+    class GeometryPool final : public Singleton<GeometryPool> {
+    public:
+        static constexpr uint32_t page_vertex_capacity = 1u << 20;
+        static constexpr uint32_t page_index_capacity  = 1u << 22;
+
+        GeometryPool() = default;
+
+        // Uploads the geometry into a page of the given vertex format and index width with enough room for it.
+        [[nodiscard]]
+        GeometryRangeUPtr allocate(
+                VertexFormat format, std::span<std::byte const> vertex_data,
+                IndexWidth index_width, std::span<std::byte const> index_data
+        );
+
+        [[nodiscard]]
+        static bgfx::VertexLayout const &get_layout(VertexFormat format);
+
+        [[nodiscard]]
+        bgfx::DynamicVertexBufferHandle get_vertex_buffer(uint32_t page_index
+        ) const {
+            return pages_[page_index].vertex_buffer_.get();
+        }
+
+        [[nodiscard]]
+        bgfx::DynamicIndexBufferHandle get_index_buffer(uint32_t page_index
+        ) const {
+            return pages_[page_index].index_buffer_.get();
+        }
+
+        [[nodiscard]]
+        std::size_t get_page_count() const {
+            return pages_.size();
+        }
+
+        void clear() {
+            pages_.clear();
+        }
+
+    private:
+        struct Page final {
+            VertexFormat            format_;
+            IndexWidth              index_width_;
+            DynamicVertexBufferUPtr vertex_buffer_;
+            DynamicIndexBufferUPtr  index_buffer_;
+            RangeAllocator          vertex_ranges_;
+            RangeAllocator          index_ranges_;
+        };
+
+        std::vector<Page> pages_;
+
+        friend struct GeometryRangeReleaser;
+
+        void free(GeometryRange const &range);
+    };
+}// namespace engine
+
+#endif//GEOMETRY_POOL_H
@@ -0,0 +1,28 @@
+#include "lod_selection.h"
+
+namespace engine {
+    std::size_t select_lod(
+            std::span<float const> errors, float distance, std::size_t current,
+            LodSelection const &selection
+    ) {
+        if (selection.pixels_per_unit_ <= 0.f || distance <= 0.f)
+            return 0;
+
+        float const pixels_per_error = selection.pixels_per_unit_ / distance;
+
+        // Errors grow with the level, so the first level that's too coarse ends the search.
+        std::size_t selected{};
+        for (std::size_t lod = 1; lod < errors.size(); ++lod) {
+            float const max_error =
+                    lod > current ? selection.max_error_pixels_ *
+                                            (1.f - selection.hysteresis_)
+                                  : selection.max_error_pixels_;
+            if (errors[lod] * pixels_per_error > max_error)
+                break;
+
+            selected = lod;
+        }
+
+        return selected;
+    }
+}// namespace engine
@@ -0,0 +1,29 @@
+#ifndef LOD_SELECTION_H
+#define LOD_SELECTION_H
+
+#include <cstddef>
+#include <span>
+
+namespace engine {
+    // Levels of detail are picked by how many pixels their error covers on screen.
+    // `pixels_per_unit_` is the size in pixels of one unit at a view distance of one, the vertical scale of the
+    // projection matrix times half the viewport height. 0 always selects the full detail.
+    struct LodSelection final {
+        float pixels_per_unit_{0.f};
+        float max_error_pixels_{1.f};
+        // A coarser level than the current one is only switched to once its error is this fraction below the limit,
+        // so that levels don't flicker back and forth at the distance where they switch.
+        float hysteresis_{0.25f};
+    };
+
+    // Returns the coarsest level whose error stays within the limit at `distance`. `errors` holds the error of each
+    // level in the units of the distance, from the full detail (0) to the coarsest one. `current` is the level that
+    // was selected in the previous frame.
+    [[nodiscard]]
+    std::size_t select_lod(
+            std::span<float const> errors, float distance, std::size_t current,
+            LodSelection const &selection
+    );
+}// namespace engine
+
+#endif//LOD_SELECTION_H
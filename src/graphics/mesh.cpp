@@ -1,31 +1,151 @@
 #include "mesh.h"
 
-#include "misc/utils.h"
+#include <algorithm>
+
+#include "mesh_processing/index_splitting.h"
 #include "texture_store.h"
 
 namespace engine {
+    namespace {
+        // Indices are stored in 16 bits whenever they fit.
+        [[nodiscard]]
+        GeometryRangeUPtr allocate_geometry(
+                VertexFormat format, std::span<std::byte const> vertex_data,
+                std::span<Index const> indices
+        ) {
+            auto &pool = GeometryPool::get_instance();
+
+            if (mesh_processing::fits_16_bit(indices)) {
+                auto const narrowed = mesh_processing::narrow_indices(indices);
+
+                return pool.allocate(
+                        format, vertex_data, IndexWidth::Bits16,
+                        std::as_bytes(std::span{narrowed})
+                );
+            }
+
+            return pool.allocate(
+                    format, vertex_data, IndexWidth::Bits32,
+                    std::as_bytes(indices)
+            );
+        }
+
+        // Primitives that fit in a single cluster are culled as a whole already.
+        [[nodiscard]]
+        MeshClusters build_clusters(
+                Primitive::IndexFormat format, std::span<Index const> indices,
+                std::span<math::Vec3 const> positions, bool double_sided
+        ) {
+            if (format != Primitive::IndexFormat::TriangleList ||
+                indices.size() <= MeshClusters::max_triangles * 3)
+                return {};
+
+            return MeshClusters::build(indices, positions, double_sided);
+        }
+    }// namespace
+
     Primitive::Primitive(
             IndexFormat format, std::span<Vertex const> vertices,
-            std::span<Index const> indices,
-            TextureIndices const  &texture_indices,
-            math::Vec4 const      &base_color_factor
+            std::span<Index const> indices, math::Aabb const &bounds,
+            TextureIndices const &texture_indices,
+            math::Vec4 const &base_color_factor, bool double_sided,
+            std::span<PrimitiveLod const> lods
+    )
+        : index_format_{format}
+        , bounds_{bounds}
+        , texture_indices_{texture_indices}
+        , base_color_factor_{base_color_factor} {
+        geometry_uptr_ = allocate_geometry(
+                VertexFormat::Float, std::as_bytes(vertices),
+                add_lods(indices, lods)
+        );
+
+        std::vector<math::Vec3> positions;
+        positions.reserve(vertices.size());
+        for (auto const &vertex : vertices) {
+            positions.emplace_back(vertex.x_, vertex.y_, vertex.z_);
+        }
+
+        clusters_ = build_clusters(format, indices, positions, double_sided);
+    }
+
+    Primitive::Primitive(
+            IndexFormat format, std::span<PackedVertex const> vertices,
+            PositionQuantization const &quantization,
+            std::span<Index const> indices, math::Aabb const &bounds,
+            TextureIndices const &texture_indices,
+            math::Vec4 const &base_color_factor, bool double_sided,
+            std::span<PrimitiveLod const> lods
     )
-        : vertex_buffer_uptr_{utils::verify_bgfx_handle(
-                  bgfx::createVertexBuffer(
-                          bgfx::copy(vertices.data(), vertices.size_bytes()),
-                          Vertex::layout
-                  ),
-                  "failed to create vertex buffer"
-          )}
-        , index_buffer_uptr_{utils::verify_bgfx_handle(
-                  bgfx::createIndexBuffer(
-                          bgfx::copy(indices.data(), indices.size_bytes()),
-                          BGFX_BUFFER_INDEX32
-                  ),
-                  "failed to create index buffer"
-          )}
+        : position_quantization_{quantization}
         , index_format_{format}
+        , bounds_{bounds}
         , texture_indices_{texture_indices}
         , base_color_factor_{base_color_factor} {
+        geometry_uptr_ = allocate_geometry(
+                VertexFormat::Packed, std::as_bytes(vertices),
+                add_lods(indices, lods)
+        );
+
+        // Clusters are built from the positions as the vertex shader reads them, before dequantization.
+        std::vector<math::Vec3> positions;
+        positions.reserve(vertices.size());
+        for (auto const &vertex : vertices) {
+            positions.emplace_back(
+                    dequantize_snorm16(vertex.x_),
+                    dequantize_snorm16(vertex.y_),
+                    dequantize_snorm16(vertex.z_)
+            );
+        }
+
+        clusters_ = build_clusters(format, indices, positions, double_sided);
+    }
+
+    std::vector<Index> Primitive::add_lods(
+            std::span<Index const>        indices,
+            std::span<PrimitiveLod const> lods
+    ) {
+        std::vector<Index> all_indices{indices.begin(), indices.end()};
+        lod_ranges_.push_back({0, static_cast<uint32_t>(indices.size())});
+        lod_errors_.push_back(0.f);
+
+        for (auto const &lod : lods) {
+            lod_ranges_.push_back(
+                    {static_cast<uint32_t>(all_indices.size()),
+                     static_cast<uint32_t>(lod.indices_.size())}
+            );
+            lod_errors_.push_back(lod.error_);
+            all_indices.insert(
+                    all_indices.end(), lod.indices_.begin(), lod.indices_.end()
+            );
+        }
+
+        return all_indices;
+    }
+
+    std::vector<PackedVertex> pack_vertices(
+            std::span<Vertex const>     vertices,
+            PositionQuantization const &quantization
+    ) {
+        std::vector<PackedVertex> packed(vertices.size());
+        std::ranges::transform(
+                vertices, packed.begin(),
+                [&quantization](Vertex const &vertex) {
+                    auto const [x, y, z] = quantization.quantize(
+                            math::Vec3{vertex.x_, vertex.y_, vertex.z_}
+                    );
+
+                    PackedVertex packed_vertex;
+                    packed_vertex.x_ = x;
+                    packed_vertex.y_ = y;
+                    packed_vertex.z_ = z;
+                    packed_vertex.u_ = float_to_half(vertex.u_);
+                    packed_vertex.v_ = float_to_half(vertex.v_);
+
+                    return packed_vertex;
+                }
+        );
+
+        return packed;
     }
 }// namespace engine
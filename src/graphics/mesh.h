@@ -5,9 +5,13 @@
 #include <span>
 #include <vector>
 
+#include "geometry_pool.h"
+#include "math/aabb.h"
 #include "math/vec.h"
+#include "mesh_clusters.h"
 #include "texture_store.h"
 #include "types.h"
+#include "vertex_packing.h"
 
 namespace engine {
     class Texture;
@@ -16,6 +20,13 @@ namespace engine {
         TextureHandle albedo_{};
     };
 
+    // A coarser version of a triangle list that is drawn with the same vertices.
+    struct PrimitiveLod final {
+        std::vector<Index> indices_;
+        // Distance between its surface and the full detail one, in the space of the mesh.
+        float              error_{};
+    };
+
     class Primitive final {
     public:
         enum class IndexFormat {
@@ -24,11 +35,25 @@ namespace engine {
         };
         Primitive(
                 IndexFormat format, std::span<Vertex const> vertices,
-                std::span<Index const> indices,
-                TextureIndices const  &texture_indices,
+                std::span<Index const> indices, math::Aabb const &bounds,
+                TextureIndices const &texture_indices,
                 math::Vec4 const      &base_color_factor = math::Vec4{
                         1.0f, 1.0f, 1.0f, 1.0f
-                }
+                },
+                bool                          double_sided = true,
+                std::span<PrimitiveLod const> lods         = {}
+        );
+        // `quantization` maps the packed positions back into the space of the mesh.
+        Primitive(
+                IndexFormat format, std::span<PackedVertex const> vertices,
+                PositionQuantization const &quantization,
+                std::span<Index const> indices, math::Aabb const &bounds,
+                TextureIndices const &texture_indices,
+                math::Vec4 const      &base_color_factor = math::Vec4{
+                        1.0f, 1.0f, 1.0f, 1.0f
+                },
+                bool                          double_sided = true,
+                std::span<PrimitiveLod const> lods         = {}
         );
         Primitive(Primitive const &)            = delete;
         Primitive(Primitive &&)                 = default;
@@ -40,14 +65,48 @@ namespace engine {
             return index_format_;
         }
 
+        // Where the vertices and indices are stored in the GeometryPool.
+        [[nodiscard]]
+        GeometryRange const &get_geometry() const {
+            return geometry_uptr_.get();
+        }
+
+        // Set if the vertices are packed, it has to be applied to the model matrix when drawing the primitive.
+        [[nodiscard]]
+        std::optional<PositionQuantization> const &
+        get_position_quantization() const {
+            return position_quantization_;
+        }
+
+        // Bounds of the vertices, in the space of the mesh.
+        [[nodiscard]]
+        math::Aabb const &get_bounds() const {
+            return bounds_;
+        }
+
+        // Clusters of a triangle list, empty if the primitive is drawn as a whole. Back-facing clusters are only
+        // culled if the primitive isn't double sided.
         [[nodiscard]]
-        VertexBufferUPtr::handle get_vertex_buffer() const {
-            return vertex_buffer_uptr_.get();
+        MeshClusters const &get_clusters() const {
+            return clusters_;
         }
 
+        // Level 0 is the full detail, the others are stored in the index buffer after it, from fine to coarse.
         [[nodiscard]]
-        IndexBufferUPtr::handle get_index_buffer() const {
-            return index_buffer_uptr_.get();
+        std::size_t get_lod_count() const {
+            return lod_ranges_.size();
+        }
+
+        // Indices of a level of detail, relative to the first index of the geometry.
+        [[nodiscard]]
+        IndexRange get_lod_range(std::size_t lod) const {
+            return lod_ranges_[lod];
+        }
+
+        // The error of every level of detail, in the space of the mesh.
+        [[nodiscard]]
+        std::span<float const> get_lod_errors() const {
+            return lod_errors_;
         }
 
         [[nodiscard]]
@@ -61,13 +120,34 @@ namespace engine {
         }
 
     private:
-        VertexBufferUPtr vertex_buffer_uptr_{};
-        IndexBufferUPtr  index_buffer_uptr_{};
-        IndexFormat      index_format_;
-        TextureIndices   texture_indices_;
-        math::Vec4       base_color_factor_{1.0f, 1.0f, 1.0f, 1.0f};
+        GeometryRangeUPtr                   geometry_uptr_{};
+        std::optional<PositionQuantization> position_quantization_{};
+        IndexFormat                         index_format_;
+        math::Aabb                          bounds_;
+        // Clusters only cover the full detail.
+        MeshClusters                        clusters_{};
+        std::vector<IndexRange>             lod_ranges_{};
+        std::vector<float>                  lod_errors_{};
+        TextureIndices                      texture_indices_;
+        math::Vec4                          base_color_factor_{
+                1.0f, 1.0f, 1.0f, 1.0f
+        };
+
+        // Records the ranges and errors of all levels of detail and returns the indices of all of them.
+        [[nodiscard]]
+        std::vector<Index> add_lods(
+                std::span<Index const>        indices,
+                std::span<PrimitiveLod const> lods
+        );
     };
 
+    // Converts the vertices to the packed format, with positions quantized by `quantization`.
+    [[nodiscard]]
+    std::vector<PackedVertex> pack_vertices(
+            std::span<Vertex const>     vertices,
+            PositionQuantization const &quantization
+    );
+
     struct Mesh final {
         std::vector<Primitive> primitives_{};
 
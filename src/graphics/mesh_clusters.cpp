@@ -0,0 +1,297 @@
+#include "mesh_clusters.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE__) || defined(_M_X64) ||                                     \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ENGINE_CLUSTERS_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace engine {
+    namespace {
+        constexpr std::size_t simd_width            = 4;
+        constexpr std::size_t vertices_per_triangle = 3;
+        // Normal cones wider than this can hardly ever be culled, testing them isn't worth it.
+        constexpr float min_cone_dot = 0.1f;
+
+#ifndef ENGINE_CLUSTERS_SSE
+        [[nodiscard]]
+        bool is_visible(
+                Frustum const &frustum, math::Vec3 const &camera_position,
+                math::Vec3 const &center, float radius, math::Vec3 const &apex,
+                math::Vec3 const &axis, float cutoff
+        ) {
+            for (auto const &plane : frustum.get_planes()) {
+                if (plane.normal_.dot(center) + plane.distance_ < -radius)
+                    return false;
+            }
+
+            // All triangles face away from the camera if it lies in the cone mirrored through the apex.
+            auto const to_apex = apex - camera_position;
+            return to_apex.dot(axis) <= cutoff * to_apex.get_magnitude();
+        }
+#endif
+    }// namespace
+
+    MeshClusters MeshClusters::build(
+            std::span<uint32_t const>   indices,
+            std::span<math::Vec3 const> positions, bool double_sided
+    ) {
+        assert(indices.size() % vertices_per_triangle == 0);
+        std::size_t const triangle_count =
+                indices.size() / vertices_per_triangle;
+
+        MeshClusters clusters;
+
+        // The cluster that last used each vertex, shifted by one so that 0 means none did.
+        std::vector<uint32_t> vertex_cluster(positions.size(), 0);
+        uint32_t              cluster_id{1};
+        std::size_t           first_triangle{};
+
+        auto const close_cluster = [&](std::size_t end_triangle) {
+            clusters.add(
+                    IndexRange{
+                            static_cast<uint32_t>(
+                                    first_triangle * vertices_per_triangle
+                            ),
+                            static_cast<uint32_t>(
+                                    (end_triangle - first_triangle) *
+                                    vertices_per_triangle
+                            )
+                    },
+                    indices, positions, double_sided
+            );
+            first_triangle = end_triangle;
+            ++cluster_id;
+        };
+
+        for (std::size_t triangle = 0; triangle < triangle_count; ++triangle) {
+            auto const corners =
+                    indices.subspan(triangle * vertices_per_triangle, 3);
+            std::size_t const cluster_size = triangle - first_triangle;
+
+            bool const is_connected = std::ranges::any_of(
+                    corners,
+                    [&](uint32_t vertex) {
+                        return vertex_cluster[vertex] == cluster_id;
+                    }
+            );
+            if (cluster_size == max_triangles ||
+                (cluster_size >= min_triangles && !is_connected)) {
+                close_cluster(triangle);
+            }
+
+            for (uint32_t const vertex : corners) {
+                vertex_cluster[vertex] = cluster_id;
+            }
+        }
+
+        if (first_triangle < triangle_count)
+            close_cluster(triangle_count);
+
+        return clusters;
+    }
+
+    void MeshClusters::cull(
+            Frustum const &frustum, math::Vec3 const &camera_position,
+            std::vector<IndexRange> &visible_ranges
+    ) const {
+#ifdef ENGINE_CLUSTERS_SSE
+        auto const &planes = frustum.get_planes();
+
+        __m128 const camera_x = _mm_set1_ps(camera_position.get_x());
+        __m128 const camera_y = _mm_set1_ps(camera_position.get_y());
+        __m128 const camera_z = _mm_set1_ps(camera_position.get_z());
+
+        for (std::size_t first = 0; first < count_; first += simd_width) {
+            __m128 const cx         = _mm_loadu_ps(center_x_.data() + first);
+            __m128 const cy         = _mm_loadu_ps(center_y_.data() + first);
+            __m128 const cz         = _mm_loadu_ps(center_z_.data() + first);
+            __m128 const radius     = _mm_loadu_ps(radius_.data() + first);
+            __m128 const neg_radius = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+            __m128 visible = _mm_cmpeq_ps(cx, cx);
+            for (auto const &plane : planes) {
+                __m128 const nx = _mm_set1_ps(plane.normal_.get_x());
+                __m128 const ny = _mm_set1_ps(plane.normal_.get_y());
+                __m128 const nz = _mm_set1_ps(plane.normal_.get_z());
+
+                __m128 const distance = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                        _mm_add_ps(
+                                _mm_mul_ps(nz, cz),
+                                _mm_set1_ps(plane.distance_)
+                        )
+                );
+                visible = _mm_and_ps(
+                        visible, _mm_cmpge_ps(distance, neg_radius)
+                );
+            }
+
+            __m128 const ax     = _mm_loadu_ps(axis_x_.data() + first);
+            __m128 const ay     = _mm_loadu_ps(axis_y_.data() + first);
+            __m128 const az     = _mm_loadu_ps(axis_z_.data() + first);
+            __m128 const cutoff = _mm_loadu_ps(cutoff_.data() + first);
+
+            // Same test as the scalar one, the cluster faces away if the camera is in its mirrored cone.
+            __m128 const dx = _mm_sub_ps(
+                    _mm_loadu_ps(apex_x_.data() + first), camera_x
+            );
+            __m128 const dy = _mm_sub_ps(
+                    _mm_loadu_ps(apex_y_.data() + first), camera_y
+            );
+            __m128 const dz = _mm_sub_ps(
+                    _mm_loadu_ps(apex_z_.data() + first), camera_z
+            );
+            __m128 const distance = _mm_sqrt_ps(_mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                    _mm_mul_ps(dz, dz)
+            ));
+            __m128 const along_axis = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(dx, ax), _mm_mul_ps(dy, ay)),
+                    _mm_mul_ps(dz, az)
+            );
+            __m128 const limit = _mm_mul_ps(cutoff, distance);
+            visible = _mm_and_ps(visible, _mm_cmple_ps(along_axis, limit));
+
+            int const         mask  = _mm_movemask_ps(visible);
+            std::size_t const count = std::min(simd_width, count_ - first);
+            for (std::size_t i = 0; i < count; ++i) {
+                if ((mask >> i) & 1)
+                    add_visible(first + i, visible_ranges);
+            }
+        }
+#else
+        for (std::size_t i = 0; i < count_; ++i) {
+            math::Vec3 const center{center_x_[i], center_y_[i], center_z_[i]};
+            math::Vec3 const apex{apex_x_[i], apex_y_[i], apex_z_[i]};
+            math::Vec3 const axis{axis_x_[i], axis_y_[i], axis_z_[i]};
+
+            if (is_visible(
+                        frustum, camera_position, center, radius_[i], apex,
+                        axis, cutoff_[i]
+                ))
+                add_visible(i, visible_ranges);
+        }
+#endif
+    }
+
+    void MeshClusters::add(
+            IndexRange range, std::span<uint32_t const> indices,
+            std::span<math::Vec3 const> positions, bool double_sided
+    ) {
+        auto const cluster_indices =
+                indices.subspan(range.first_index_, range.index_count_);
+
+        auto bounds = math::Aabb::empty();
+        for (uint32_t const vertex : cluster_indices) {
+            bounds.expand(positions[vertex]);
+        }
+
+        auto const center = bounds.get_center();
+        float      radius{};
+        for (uint32_t const vertex : cluster_indices) {
+            radius = std::max(
+                    radius, (positions[vertex] - center).get_magnitude()
+            );
+        }
+
+        // A point on each triangle and its unit normal.
+        std::vector<std::pair<math::Vec3, math::Vec3>> triangles;
+        triangles.reserve(cluster_indices.size() / vertices_per_triangle);
+        math::Vec3 axis{};
+        for (std::size_t i = 0; !double_sided && i < cluster_indices.size();
+             i += vertices_per_triangle) {
+            auto const &a = positions[cluster_indices[i]];
+            auto const &b = positions[cluster_indices[i + 1]];
+            auto const &c = positions[cluster_indices[i + 2]];
+
+            auto const  normal = (b - a).cross(c - a);
+            float const length = normal.get_magnitude();
+            // Degenerate triangles are never rasterized, they don't constrain the cone.
+            if (length == 0.f)
+                continue;
+
+            triangles.emplace_back(a, normal / length);
+            axis += triangles.back().second;
+        }
+
+        float       cutoff{1.f};
+        math::Vec3  apex{center};
+        float const axis_length = axis.get_magnitude();
+        if (axis_length > 0.f) {
+            axis /= axis_length;
+
+            float min_dot{1.f};
+            for (auto const &[point, normal] : triangles) {
+                min_dot = std::min(min_dot, normal.dot(axis));
+            }
+
+            if (min_dot > min_cone_dot) {
+                cutoff = std::sqrt(1.f - min_dot * min_dot);
+
+                // Moves the apex back along the axis until it is behind every triangle.
+                float apex_offset{};
+                for (auto const &[point, normal] : triangles) {
+                    apex_offset = std::max(
+                            apex_offset,
+                            (center - point).dot(normal) / normal.dot(axis)
+                    );
+                }
+                apex = center - axis * apex_offset;
+            } else {
+                axis = math::Vec3{};
+            }
+        }
+
+        // The arrays are kept padded to a multiple of the SIMD width, so the last group can be loaded as a whole.
+        if (count_ % simd_width == 0) {
+            std::size_t const padded_size = count_ + simd_width;
+            center_x_.resize(padded_size);
+            center_y_.resize(padded_size);
+            center_z_.resize(padded_size);
+            radius_.resize(padded_size);
+            apex_x_.resize(padded_size);
+            apex_y_.resize(padded_size);
+            apex_z_.resize(padded_size);
+            axis_x_.resize(padded_size);
+            axis_y_.resize(padded_size);
+            axis_z_.resize(padded_size);
+            cutoff_.resize(padded_size);
+        }
+
+        index_ranges_.push_back(range);
+        center_x_[count_] = center.get_x();
+        center_y_[count_] = center.get_y();
+        center_z_[count_] = center.get_z();
+        radius_[count_]   = radius;
+        apex_x_[count_]   = apex.get_x();
+        apex_y_[count_]   = apex.get_y();
+        apex_z_[count_]   = apex.get_z();
+        axis_x_[count_]   = axis.get_x();
+        axis_y_[count_]   = axis.get_y();
+        axis_z_[count_]   = axis.get_z();
+        cutoff_[count_]   = cutoff;
+        ++count_;
+    }
+
+    void MeshClusters::add_visible(
+            std::size_t cluster, std::vector<IndexRange> &visible_ranges
+    ) const {
+        auto const &range = index_ranges_[cluster];
+
+        if (!visible_ranges.empty()) {
+            auto &last = visible_ranges.back();
+            if (last.first_index_ + last.index_count_ == range.first_index_) {
+                last.index_count_ += range.index_count_;
+                return;
+            }
+        }
+
+        visible_ranges.push_back(range);
+    }
+}// namespace engine
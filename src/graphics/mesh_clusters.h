@@ -0,0 +1,88 @@
+#ifndef MESH_CLUSTERS_H
+#define MESH_CLUSTERS_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "culling.h"
+#include "math/vec.h"
+
+namespace engine {
+    // Indices [first_index_, first_index_ + index_count_) of a primitive.
+    struct IndexRange final {
+        uint32_t first_index_;
+        uint32_t index_count_;
+    };
+
+    // A triangle list split into clusters of nearby triangles, each with a bounding sphere and a cone that contains
+    // the normals of its triangles. The apex of the cone lies behind all triangles of the cluster.
+    // Clusters are stored in separate arrays per component, so that four of them are culled at once with SIMD.
+    // Everything is in the space of the vertex positions as they're stored in the vertex buffer.
+    class MeshClusters final {
+    public:
+        static constexpr std::size_t min_triangles = 64;
+        static constexpr std::size_t max_triangles = 128;
+
+        MeshClusters() = default;
+
+        // Clusters follow the order of the triangles, so the list should already be optimized for locality. A
+        // cluster is closed once it is full, or once it has `min_triangles` and the next triangle doesn't share a
+        // vertex with it. Clusters of double sided triangles never get a cone, so that they stay correct for
+        // materials that are drawn without face culling.
+        [[nodiscard]]
+        static MeshClusters build(
+                std::span<uint32_t const>   indices,
+                std::span<math::Vec3 const> positions, bool double_sided
+        );
+
+        [[nodiscard]]
+        std::size_t get_count() const {
+            return count_;
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return count_ == 0;
+        }
+
+        [[nodiscard]]
+        IndexRange get_index_range(std::size_t cluster) const {
+            return index_ranges_[cluster];
+        }
+
+        // Appends the index ranges of the clusters that are inside the frustum and not facing away from the camera,
+        // merging ranges that follow each other. Both the frustum and the camera position are in the space of the
+        // vertex positions.
+        void
+        cull(Frustum const &frustum, math::Vec3 const &camera_position,
+             std::vector<IndexRange> &visible_ranges) const;
+
+    private:
+        std::size_t             count_{};
+        std::vector<IndexRange> index_ranges_;
+        std::vector<float>      center_x_;
+        std::vector<float>      center_y_;
+        std::vector<float>      center_z_;
+        std::vector<float>      radius_;
+        // Clusters whose normals can't be bounded by a cone have a zero axis and a cutoff of 1, which never culls.
+        std::vector<float>      apex_x_;
+        std::vector<float>      apex_y_;
+        std::vector<float>      apex_z_;
+        std::vector<float>      axis_x_;
+        std::vector<float>      axis_y_;
+        std::vector<float>      axis_z_;
+        std::vector<float>      cutoff_;
+
+        void add(
+                IndexRange range, std::span<uint32_t const> indices,
+                std::span<math::Vec3 const> positions, bool double_sided
+        );
+
+        void add_visible(
+                std::size_t cluster, std::vector<IndexRange> &visible_ranges
+        ) const;
+    };
+}// namespace engine
+
+#endif//MESH_CLUSTERS_H
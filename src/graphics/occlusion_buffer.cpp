@@ -0,0 +1,341 @@
+#include "occlusion_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE__) || defined(_M_X64) ||                                     \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ENGINE_OCCLUSION_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace engine {
+    namespace {
+        constexpr float    far_depth       = 1.f;
+        constexpr float    min_w           = 1e-4f;
+        constexpr uint32_t lanes           = 4;
+        constexpr uint32_t max_test_texels = 4;
+
+        using ClipVertex = std::array<float, 4>;
+
+        [[nodiscard]]
+        OcclusionBuffer::Matrix multiply(
+                std::span<float const, 4 * 4> lhs,
+                std::span<float const, 4 * 4> rhs
+        ) {
+            OcclusionBuffer::Matrix result{};
+            for (std::size_t row = 0; row < 4; ++row) {
+                for (std::size_t col = 0; col < 4; ++col) {
+                    for (std::size_t i = 0; i < 4; ++i) {
+                        result[row * 4 + col] +=
+                                lhs[row * 4 + i] * rhs[i * 4 + col];
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        [[nodiscard]]
+        ClipVertex to_clip(
+                math::Vec3 const &position, OcclusionBuffer::Matrix const &mvp
+        ) {
+            ClipVertex clip{};
+            for (std::size_t i = 0; i < 4; ++i) {
+                clip[i] = position.get_x() * mvp[i] +
+                          position.get_y() * mvp[4 + i] +
+                          position.get_z() * mvp[8 + i] + mvp[12 + i];
+            }
+
+            return clip;
+        }
+    }// namespace
+
+    OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height)
+        : width_{width}
+        , height_{height} {
+        if (width == 0 || height == 0 || width % lanes != 0) {
+            throw std::runtime_error{
+                    "Occlusion buffer width must be a non-zero multiple of 4"
+            };
+        }
+
+        uint32_t level_width  = width;
+        uint32_t level_height = height;
+        while (true) {
+            levels_.push_back(Level{
+                    level_width, level_height,
+                    std::vector<float>(level_width * level_height, far_depth)
+            });
+
+            if (level_width == 1 && level_height == 1)
+                break;
+
+            level_width  = std::max(1u, (level_width + 1) / 2);
+            level_height = std::max(1u, (level_height + 1) / 2);
+        }
+    }
+
+    void OcclusionBuffer::begin(std::span<float const, 4 * 4> view_proj) {
+        std::ranges::copy(view_proj, view_proj_.begin());
+        std::ranges::fill(levels_[0].depth_, far_depth);
+    }
+
+    void OcclusionBuffer::rasterize(
+            std::span<math::Vec3 const> positions,
+            std::span<uint32_t const> indices,
+            std::span<float const, 4 * 4> model
+    ) {
+        auto const mvp = multiply(model, view_proj_);
+
+        auto const to_screen = [this](ClipVertex const &clip) {
+            float const inv_w = 1.f / clip[3];
+
+            return ScreenVertex{
+                    (clip[0] * inv_w * 0.5f + 0.5f) *
+                            static_cast<float>(width_),
+                    (0.5f - clip[1] * inv_w * 0.5f) *
+                            static_cast<float>(height_),
+                    clip[2] * inv_w
+            };
+        };
+
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            auto const c0 = to_clip(positions[indices[i]], mvp);
+            auto const c1 = to_clip(positions[indices[i + 1]], mvp);
+            auto const c2 = to_clip(positions[indices[i + 2]], mvp);
+
+            // Triangles crossing the near plane are skipped instead of clipped, which only makes culling less
+            // aggressive.
+            if (c0[3] < min_w || c1[3] < min_w || c2[3] < min_w)
+                continue;
+
+            rasterize_triangle(to_screen(c0), to_screen(c1), to_screen(c2));
+        }
+    }
+
+    void OcclusionBuffer::rasterize_triangle(
+            ScreenVertex v0, ScreenVertex v1, ScreenVertex v2
+    ) {
+        float area = (v1.x_ - v0.x_) * (v2.y_ - v0.y_) -
+                     (v1.y_ - v0.y_) * (v2.x_ - v0.x_);
+        if (area == 0.f || !std::isfinite(area))
+            return;
+
+        // Occluders are drawn double-sided, flip to a single winding so the edge tests are the same for all.
+        if (area < 0.f) {
+            std::swap(v1, v2);
+            area = -area;
+        }
+
+        auto const min_x = static_cast<int32_t>(
+                std::max(0.f, std::floor(std::min({v0.x_, v1.x_, v2.x_})))
+        );
+        auto const max_x = static_cast<int32_t>(std::min(
+                static_cast<float>(width_) - 1.f,
+                std::ceil(std::max({v0.x_, v1.x_, v2.x_}))
+        ));
+        auto const min_y = static_cast<int32_t>(
+                std::max(0.f, std::floor(std::min({v0.y_, v1.y_, v2.y_})))
+        );
+        auto const max_y = static_cast<int32_t>(std::min(
+                static_cast<float>(height_) - 1.f,
+                std::ceil(std::max({v0.y_, v1.y_, v2.y_}))
+        ));
+        if (min_x > max_x || min_y > max_y)
+            return;
+
+        // Edge functions e(x, y) = a * x + b * y + c, positive inside the triangle.
+        struct Edge final {
+            float a_, b_, c_;
+        };
+
+        auto const make_edge = [](ScreenVertex const &from,
+                                  ScreenVertex const &to) {
+            return Edge{
+                    from.y_ - to.y_, to.x_ - from.x_,
+                    from.x_ * to.y_ - from.y_ * to.x_
+            };
+        };
+
+        // Edges opposite of v0, v1 and v2, so they double as barycentric weights.
+        std::array const edges{
+                make_edge(v1, v2), make_edge(v2, v0), make_edge(v0, v1)
+        };
+
+        // The triangle's depth as a plane over the screen.
+        float const inv_area = 1.f / area;
+        Edge const  depth{
+                (edges[0].a_ * v0.z_ + edges[1].a_ * v1.z_ +
+                 edges[2].a_ * v2.z_) *
+                        inv_area,
+                (edges[0].b_ * v0.z_ + edges[1].b_ * v1.z_ +
+                 edges[2].b_ * v2.z_) *
+                        inv_area,
+                (edges[0].c_ * v0.z_ + edges[1].c_ * v1.z_ +
+                 edges[2].c_ * v2.z_) *
+                        inv_area
+        };
+
+        auto &buffer = levels_[0].depth_;
+
+#ifdef ENGINE_OCCLUSION_SSE
+        // Rows are processed in groups of four pixels starting at a multiple of four, so loads stay in bounds.
+        auto const first_x = min_x - min_x % static_cast<int32_t>(lanes);
+
+        __m128 const zero    = _mm_setzero_ps();
+        __m128 const offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        __m128 const max_px  = _mm_set1_ps(static_cast<float>(max_x) + 1.f);
+        __m128 const min_px  = _mm_set1_ps(static_cast<float>(min_x));
+
+        for (int32_t y = min_y; y <= max_y; ++y) {
+            float const py  = static_cast<float>(y) + 0.5f;
+            float *row = buffer.data() + static_cast<std::size_t>(y) * width_;
+
+            for (int32_t x = first_x; x <= max_x;
+                 x += static_cast<int32_t>(lanes)) {
+                __m128 const px = _mm_add_ps(
+                        _mm_set1_ps(static_cast<float>(x)), offsets
+                );
+
+                __m128 inside = _mm_and_ps(
+                        _mm_cmpge_ps(px, min_px), _mm_cmplt_ps(px, max_px)
+                );
+                for (auto const &edge : edges) {
+                    __m128 const value = _mm_add_ps(
+                            _mm_mul_ps(_mm_set1_ps(edge.a_), px),
+                            _mm_set1_ps(edge.b_ * py + edge.c_)
+                    );
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(value, zero));
+                }
+
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+
+                __m128 const z = _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(depth.a_), px),
+                        _mm_set1_ps(depth.b_ * py + depth.c_)
+                );
+                __m128 const old_z = _mm_loadu_ps(row + x);
+                __m128 const new_z = _mm_min_ps(old_z, z);
+
+                _mm_storeu_ps(
+                        row + x, _mm_or_ps(
+                                         _mm_and_ps(inside, new_z),
+                                         _mm_andnot_ps(inside, old_z)
+                                 )
+                );
+            }
+        }
+#else
+        for (int32_t y = min_y; y <= max_y; ++y) {
+            float const py  = static_cast<float>(y) + 0.5f;
+            float *row = buffer.data() + static_cast<std::size_t>(y) * width_;
+
+            for (int32_t x = min_x; x <= max_x; ++x) {
+                float const px = static_cast<float>(x) + 0.5f;
+
+                bool const inside =
+                        std::ranges::all_of(edges, [&](Edge const &edge) {
+                            return edge.a_ * px + edge.b_ * py + edge.c_ >= 0.f;
+                        });
+                if (!inside)
+                    continue;
+
+                float const z = depth.a_ * px + depth.b_ * py + depth.c_;
+                row[x]        = std::min(row[x], z);
+            }
+        }
+#endif
+    }
+
+    void OcclusionBuffer::build_hierarchy() {
+        for (std::size_t level = 1; level < levels_.size(); ++level) {
+            auto const &src = levels_[level - 1];
+            auto       &dst = levels_[level];
+
+            for (uint32_t y = 0; y < dst.height_; ++y) {
+                uint32_t const y0 = std::min(y * 2, src.height_ - 1);
+                uint32_t const y1 = std::min(y * 2 + 1, src.height_ - 1);
+
+                for (uint32_t x = 0; x < dst.width_; ++x) {
+                    uint32_t const x0 = std::min(x * 2, src.width_ - 1);
+                    uint32_t const x1 = std::min(x * 2 + 1, src.width_ - 1);
+
+                    dst.depth_[y * dst.width_ + x] = std::max(
+                            {src.depth_[y0 * src.width_ + x0],
+                             src.depth_[y0 * src.width_ + x1],
+                             src.depth_[y1 * src.width_ + x0],
+                             src.depth_[y1 * src.width_ + x1]}
+                    );
+                }
+            }
+        }
+    }
+
+    bool OcclusionBuffer::is_occluded(math::Aabb const &bounds) const {
+        float min_x     = std::numeric_limits<float>::max();
+        float min_y     = std::numeric_limits<float>::max();
+        float max_x     = std::numeric_limits<float>::lowest();
+        float max_y     = std::numeric_limits<float>::lowest();
+        float min_depth = std::numeric_limits<float>::max();
+
+        for (uint32_t corner = 0; corner < 8; ++corner) {
+            math::Vec3 const position{
+                    (corner & 1) ? bounds.max_.get_x() : bounds.min_.get_x(),
+                    (corner & 2) ? bounds.max_.get_y() : bounds.min_.get_y(),
+                    (corner & 4) ? bounds.max_.get_z() : bounds.min_.get_z()
+            };
+            auto const clip = to_clip(position, view_proj_);
+            if (clip[3] < min_w)
+                return false;
+
+            float const inv_w = 1.f / clip[3];
+            min_x             = std::min(min_x, clip[0] * inv_w);
+            max_x             = std::max(max_x, clip[0] * inv_w);
+            min_y             = std::min(min_y, clip[1] * inv_w);
+            max_y             = std::max(max_y, clip[1] * inv_w);
+            min_depth         = std::min(min_depth, clip[2] * inv_w);
+        }
+
+        auto const to_pixel = [](float ndc, uint32_t size, bool flip) {
+            float const normalized =
+                    flip ? 0.5f - ndc * 0.5f : ndc * 0.5f + 0.5f;
+
+            return static_cast<int32_t>(std::clamp(
+                    std::floor(normalized * static_cast<float>(size)), 0.f,
+                    static_cast<float>(size) - 1.f
+            ));
+        };
+
+        int32_t x0 = to_pixel(min_x, width_, false);
+        int32_t x1 = to_pixel(max_x, width_, false);
+        int32_t y0 = to_pixel(max_y, height_, true);
+        int32_t y1 = to_pixel(min_y, height_, true);
+
+        // Pick the level at which the rectangle spans at most a few texels in each direction.
+        std::size_t level = 0;
+        while (level + 1 < levels_.size() &&
+               std::max(x1 - x0, y1 - y0) >=
+                       static_cast<int32_t>(max_test_texels)) {
+            x0 /= 2;
+            x1 /= 2;
+            y0 /= 2;
+            y1 /= 2;
+            ++level;
+        }
+
+        auto const &hierarchy_level = levels_[level];
+        for (int32_t y = y0; y <= y1; ++y) {
+            for (int32_t x = x0; x <= x1; ++x) {
+                if (hierarchy_level.depth_[y * hierarchy_level.width_ + x] >=
+                    min_depth)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+}// namespace engine
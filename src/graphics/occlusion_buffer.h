@@ -0,0 +1,78 @@
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "math/aabb.h"
+
+namespace engine {
+    // Low resolution depth buffer that occluder meshes are rasterized into on the CPU, followed by a hierarchy of
+    // max-depth levels that bounding boxes are tested against. It doesn't touch the GPU, so it can run headless.
+    class OcclusionBuffer final {
+    public:
+        using Matrix = std::array<float, 4 * 4>;
+
+        // The width has to be a multiple of 4, as rows are rasterized four pixels at a time.
+        OcclusionBuffer(uint32_t width, uint32_t height);
+
+        // Clears the depth and sets the view-projection matrix for the next frame, laid out like the matrices
+        // passed to bgfx.
+        void begin(std::span<float const, 4 * 4> view_proj);
+
+        // Rasterizes an indexed triangle list, `model` transforms the positions into world space.
+        void rasterize(
+                std::span<math::Vec3 const> positions,
+                std::span<uint32_t const> indices,
+                std::span<float const, 4 * 4> model
+        );
+
+        // Must be called after the occluders were rasterized and before testing bounds.
+        void build_hierarchy();
+
+        // Whether the box is hidden behind the rasterized occluders. Boxes that cross the near plane are never
+        // considered occluded.
+        [[nodiscard]]
+        bool is_occluded(math::Aabb const &bounds) const;
+
+        [[nodiscard]]
+        uint32_t get_width() const {
+            return width_;
+        }
+
+        [[nodiscard]]
+        uint32_t get_height() const {
+            return height_;
+        }
+
+        // Depth of the nearest occluder at a pixel, the far plane if there is none.
+        [[nodiscard]]
+        float get_depth(uint32_t x, uint32_t y) const {
+            return levels_[0].depth_[y * width_ + x];
+        }
+
+    private:
+        struct Level final {
+            uint32_t           width_;
+            uint32_t           height_;
+            std::vector<float> depth_;
+        };
+
+        struct ScreenVertex final {
+            float x_, y_, z_;
+        };
+
+        uint32_t           width_;
+        uint32_t           height_;
+        Matrix             view_proj_{};
+        std::vector<Level> levels_;
+
+        void rasterize_triangle(
+                ScreenVertex v0, ScreenVertex v1, ScreenVertex v2
+        );
+    };
+}// namespace engine
+
+#endif//OCCLUSION_BUFFER_H
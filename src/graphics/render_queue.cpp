@@ -0,0 +1,618 @@
+#include "render_queue.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "geometry_pool.h"
+#include "mesh.h"
+#include "misc/radix_sort.h"
+#include "misc/thread_pool.h"
+#include "occlusion_buffer.h"
+#include "texture_store.h"
+
+namespace engine {
+    namespace {
+        constexpr std::size_t min_instanced_batch_size = 2;
+        // Below this many draws per chunk, handing chunks to other threads costs more than it saves.
+        constexpr std::size_t min_chunk_size = 256;
+        constexpr uint16_t    instance_stride =
+                sizeof(RenderQueue::InstanceTransform);
+
+        constexpr uint8_t primitive_discard_flags =
+                BGFX_DISCARD_VERTEX_STREAMS | BGFX_DISCARD_INDEX_BUFFER |
+                BGFX_DISCARD_STATE;
+
+        [[nodiscard]]
+        constexpr uint64_t mask(int bits) {
+            return (uint64_t{1} << bits) - 1;
+        }
+
+        [[nodiscard]]
+        uint64_t hash_material(math::Vec4 const &base_color_factor) {
+            uint64_t hash{0xcbf29ce484222325};
+            for (float const component : base_color_factor.get_data()) {
+                hash ^= std::bit_cast<uint32_t>(component);
+                hash *= 0x100000001b3;
+            }
+
+            return hash ^ (hash >> 32);
+        }
+
+        // Transforms a point by the inverse of `model`, laid out like the matrices passed to bgfx.
+        [[nodiscard]]
+        math::Vec3 to_local_space(
+                std::span<float const, 4 * 4> model, math::Vec3 const &point
+        ) {
+            math::Vec3 const x_axis{model[0], model[1], model[2]};
+            math::Vec3 const y_axis{model[4], model[5], model[6]};
+            math::Vec3 const z_axis{model[8], model[9], model[10]};
+            math::Vec3 const offset =
+                    point - math::Vec3{model[12], model[13], model[14]};
+
+            // Cramer's rule, the determinant is the triple product of the axes.
+            auto const  yz          = y_axis.cross(z_axis);
+            float const determinant = x_axis.dot(yz);
+            if (determinant == 0.f)
+                return math::Vec3{};
+
+            return math::Vec3{
+                           offset.dot(yz), x_axis.dot(offset.cross(z_axis)),
+                           x_axis.dot(y_axis.cross(offset))
+                   } /
+                   determinant;
+        }
+    }// namespace
+
+    uint64_t RenderQueue::get_state(Primitive const &primitive, Pass pass) {
+        // The same faces have to be culled in every pass, or the depth test of the opaque pass fails on them.
+        uint64_t state = BGFX_STATE_CULL_CW | BGFX_STATE_MSAA |
+                         BGFX_STATE_FRONT_CCW;
+        switch (pass) {
+            case Pass::DepthPrepass:
+                state |= BGFX_STATE_WRITE_Z | BGFX_STATE_DEPTH_TEST_LESS;
+                break;
+            case Pass::DepthEqual:
+                // Depth is already final, writing it again would only cost bandwidth.
+                state |= BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                         BGFX_STATE_DEPTH_TEST_EQUAL;
+                break;
+            case Pass::DepthLess:
+                state |= BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                         BGFX_STATE_WRITE_Z | BGFX_STATE_DEPTH_TEST_LESS;
+                break;
+        }
+        state |= primitive.get_format() == Primitive::IndexFormat::TriangleStrip
+                       ? BGFX_STATE_PT_TRISTRIP
+                       : 0;
+
+        return state;
+    }
+
+    std::size_t
+    RenderQueue::PrimitiveKeyHasher::operator()(PrimitiveKey const &key) const {
+        return std::hash<Primitive const *>{}(key.primitive_ptr_) ^
+               std::hash<uint16_t>{}(key.program_idx_) ^
+               (std::hash<uint8_t>{}(key.lod_) << 16);
+    }
+
+    void RenderQueue::begin(
+            std::span<float const, 4 * 4> view_mtx, float far_plane,
+            Frustum const &frustum, ProjectedSizeCutoff const &size_cutoff,
+            LodSelection const    &lod_selection,
+            OcclusionBuffer const *occlusion_buffer_ptr
+    ) {
+        std::ranges::copy(view_mtx, view_mtx_.begin());
+        // The view matrix is a rotation followed by a translation, undoing both gives the camera position.
+        auto const row = [&view_mtx](std::size_t index) {
+            return math::Vec3{
+                    view_mtx[index * 4], view_mtx[index * 4 + 1],
+                    view_mtx[index * 4 + 2]
+            };
+        };
+        auto const translation = row(3);
+        camera_position_       = -math::Vec3{
+                translation.dot(row(0)), translation.dot(row(1)),
+                translation.dot(row(2))
+        };
+
+        far_plane_            = far_plane;
+        frustum_              = frustum;
+        size_cutoff_          = size_cutoff;
+        lod_selection_        = lod_selection;
+        occlusion_buffer_ptr_ = occlusion_buffer_ptr;
+
+        transforms_.clear();
+        primitives_.clear();
+        primitive_indices_.clear();
+        items_.clear();
+        screen_sizes_.clear();
+        world_bounds_.clear();
+        culler_.clear();
+    }
+
+    uint32_t RenderQueue::add_transform(InstanceTransform const &transform) {
+        transforms_.push_back(transform);
+
+        return static_cast<uint32_t>(transforms_.size() - 1);
+    }
+
+    void RenderQueue::add(
+            Primitive const &primitive, std::size_t lod,
+            bgfx::ProgramHandle program, bgfx::ProgramHandle instanced_program,
+            uint32_t transform_index, math::Aabb const &world_bounds
+    ) {
+        assert(lod < primitive.get_lod_count());
+        PrimitiveKey const key{
+                &primitive, program.idx, static_cast<uint8_t>(lod)
+        };
+
+        auto const [it, inserted] = primitive_indices_.try_emplace(
+                key, static_cast<uint32_t>(primitives_.size())
+        );
+        if (inserted) {
+            auto const texture_index =
+                    primitive.get_texture_indices().albedo_.get_index();
+
+            primitives_.emplace_back(PrimitiveEntry{
+                    &primitive, program, instanced_program,
+                    texture_index ? static_cast<uint32_t>(*texture_index + 1)
+                                  : 0,
+                    key.lod_
+            });
+        }
+
+        uint32_t const primitive_index = it->second;
+        auto const    &entry           = primitives_[primitive_index];
+
+        float const depth = std::clamp(
+                get_view_depth(world_bounds.get_center()) / far_plane_, 0.f,
+                1.f
+        );
+        auto const quantized_depth = static_cast<uint64_t>(
+                depth * static_cast<float>(mask(depth_bits))
+        );
+
+        uint64_t sort_key{program.idx & mask(program_bits)};
+        sort_key = (sort_key << texture_bits) |
+                   (entry.texture_key_ & mask(texture_bits));
+        sort_key = (sort_key << material_bits) |
+                   (hash_material(primitive.get_base_color_factor()) &
+                    mask(material_bits));
+        sort_key = (sort_key << primitive_bits) |
+                   (primitive_index & mask(primitive_bits));
+        sort_key = (sort_key << depth_bits) | quantized_depth;
+
+        // The size of a sphere around the bounds, capped once the camera is inside it.
+        float const radius   = world_bounds.get_extents().get_magnitude();
+        float const distance = std::max(
+                (world_bounds.get_center() - camera_position_).get_magnitude(),
+                radius
+        );
+        float const screen_size =
+                distance > 0.f
+                        ? 2.f * radius * lod_selection_.pixels_per_unit_ /
+                                  distance
+                        : 0.f;
+
+        // Items and culled bounds share their index until the items get sorted.
+        culler_.add(world_bounds);
+        items_.push_back({sort_key, transform_index, primitive_index});
+        screen_sizes_.push_back(screen_size);
+        world_bounds_.push_back(world_bounds);
+    }
+
+    void RenderQueue::submit(Views const &views) {
+        remove_culled_items();
+        choose_instancing(views.depth_prepass_.has_value());
+
+        if (views.depth_prepass_) {
+            // Front to back, so that the closest surfaces reject most of the fragments behind them early. The depth
+            // bits are moved to the top of the key, draws at the same depth are still grouped by their state.
+            submit_pass(
+                    *views.depth_prepass_, Pass::DepthPrepass,
+                    [](DrawItem const &item) {
+                        return std::rotr(item.sort_key_, depth_bits);
+                    }
+            );
+        }
+
+        // Only the visible fragments pass the equal depth test, the order only matters for the state changes.
+        submit_pass(
+                views.opaque_,
+                views.depth_prepass_ ? Pass::DepthEqual : Pass::DepthLess,
+                [](DrawItem const &item) { return item.sort_key_; }
+        );
+    }
+
+    template<typename GetKey>
+    void RenderQueue::submit_pass(
+            bgfx::ViewId view_id, Pass pass, GetKey &&get_key
+    ) {
+        radix_sort(std::span{items_}, sort_scratch_, get_key);
+
+        build_runs();
+        build_chunks();
+
+        // Chunks are recorded concurrently, so bgfx can't rely on submission order. Each draw passes its position in
+        // the sorted items as depth instead, which makes bgfx replay the draws in exactly that order.
+        bgfx::setViewMode(view_id, bgfx::ViewMode::DepthAscending);
+
+        ThreadPool::get_instance().parallel_for(
+                chunks_.size(),
+                [this, view_id, pass](std::size_t chunk_index) {
+                    record_chunk(view_id, pass, chunk_index);
+                }
+        );
+    }
+
+    float RenderQueue::get_view_depth(math::Vec3 const &world_position) const {
+        return world_position.get_x() * view_mtx_[2] +
+               world_position.get_y() * view_mtx_[6] +
+               world_position.get_z() * view_mtx_[10] + view_mtx_[14];
+    }
+
+    void RenderQueue::remove_culled_items() {
+        culler_.cull(frustum_, size_cutoff_, visible_);
+
+        auto &texture_store = TextureStore::get_instance();
+
+        // Only the draws inside the frustum are tested against the occluders, which is the more expensive test.
+        std::size_t num_visible{};
+        for (std::size_t i = 0; i < items_.size(); ++i) {
+            if (visible_[i] &&
+                (occlusion_buffer_ptr_ == nullptr ||
+                 !occlusion_buffer_ptr_->is_occluded(world_bounds_[i]))) {
+                auto const &albedo =
+                        primitives_[items_[i].primitive_index_]
+                                .primitive_ptr_->get_texture_indices()
+                                .albedo_;
+                if (albedo)
+                    texture_store.request(albedo, screen_sizes_[i]);
+
+                items_[num_visible++] = items_[i];
+            }
+        }
+        items_.resize(num_visible);
+    }
+
+    void RenderQueue::choose_instancing(bool has_depth_prepass) {
+        if ((bgfx::getCaps()->supported & BGFX_CAPS_INSTANCING) == 0 ||
+            !bgfx::isValid(depth_instanced_program_.get()))
+            return;
+
+        draw_counts_.assign(primitives_.size(), 0);
+        for (auto const &item : items_) {
+            ++draw_counts_[item.primitive_index_];
+        }
+
+        // Each pass needs its own instance data. Primitives that don't fit anymore are drawn individually in every
+        // pass, instead of falling back halfway through one of them.
+        uint32_t const pass_count = has_depth_prepass ? 2 : 1;
+        uint32_t       available  = bgfx::getAvailInstanceDataBuffer(
+                std::numeric_limits<uint32_t>::max(), instance_stride
+        );
+        for (std::size_t i = 0; i < primitives_.size(); ++i) {
+            auto          &entry = primitives_[i];
+            uint32_t const count = draw_counts_[i] * pass_count;
+
+            entry.instanced_ = draw_counts_[i] >= min_instanced_batch_size &&
+                               bgfx::isValid(entry.instanced_program_) &&
+                               count <= available;
+            if (entry.instanced_)
+                available -= count;
+        }
+    }
+
+    void RenderQueue::build_runs() {
+        runs_.clear();
+
+        std::size_t first{};
+        while (first < items_.size()) {
+            uint32_t const primitive_index = items_[first].primitive_index_;
+
+            std::size_t last = first + 1;
+            while (last < items_.size() &&
+                   items_[last].primitive_index_ == primitive_index) {
+                ++last;
+            }
+
+            runs_.push_back({first, last});
+            first = last;
+        }
+    }
+
+    void RenderQueue::build_chunks() {
+        chunks_.clear();
+        if (runs_.empty())
+            return;
+
+        // The thread calling submit records the first chunk on encoder 0, every other chunk needs its own encoder.
+        std::size_t const max_encoders = bgfx::getCaps()->limits.maxEncoders;
+        std::size_t const max_chunks   = std::min(
+                std::max(max_encoders, std::size_t{1}),
+                ThreadPool::get_instance().get_worker_count() + 1
+        );
+        std::size_t const chunk_count = std::clamp(
+                items_.size() / min_chunk_size, std::size_t{1}, max_chunks
+        );
+        std::size_t const target_size =
+                (items_.size() + chunk_count - 1) / chunk_count;
+
+        // Chunks end on run boundaries, so runs are never split between encoders and can still be instanced.
+        std::size_t first_run{};
+        for (std::size_t run_idx = 0; run_idx < runs_.size(); ++run_idx) {
+            std::size_t const chunk_size =
+                    runs_[run_idx].last_ - runs_[first_run].first_;
+
+            if (chunk_size >= target_size || run_idx + 1 == runs_.size()) {
+                chunks_.push_back({first_run, run_idx + 1});
+                first_run = run_idx + 1;
+            }
+        }
+    }
+
+    void RenderQueue::record_chunk(
+            bgfx::ViewId view_id, Pass pass, std::size_t chunk_index
+    ) const {
+        // Only the first chunk is guaranteed to be recorded on the calling thread.
+        bgfx::Encoder *encoder_ptr = bgfx::begin(chunk_index != 0);
+        assert(encoder_ptr != nullptr);
+
+        Recorder recorder{*encoder_ptr, view_id, pass};
+
+        auto const &chunk = chunks_[chunk_index];
+        for (std::size_t run_idx = chunk.first_; run_idx < chunk.last_;
+             ++run_idx) {
+            auto const &[first, last] = runs_[run_idx];
+
+            std::span<DrawItem const> const run{
+                    items_.data() + first, last - first
+            };
+            // Discard flags only look ahead within the encoder, the next chunk starts from a clean state.
+            auto const next_index =
+                    run_idx + 1 < chunk.last_
+                            ? std::optional{items_[last].primitive_index_}
+                            : std::nullopt;
+
+            // Also when the run has a single draw, the primitive is drawn the same way in every pass.
+            if (primitives_[run.front().primitive_index_].instanced_) {
+                submit_instanced(recorder, run, next_index);
+            } else {
+                submit_individually(recorder, run, next_index);
+            }
+        }
+
+        bgfx::end(encoder_ptr);
+    }
+
+    bgfx::ProgramHandle RenderQueue::get_program(
+            Pass pass, uint32_t primitive_index, bool instanced
+    ) const {
+        if (pass == Pass::DepthPrepass)
+            return instanced ? depth_instanced_program_.get()
+                             : depth_program_.get();
+
+        auto const &entry = primitives_[primitive_index];
+        return instanced ? entry.instanced_program_ : entry.program_;
+    }
+
+    uint8_t RenderQueue::get_discard_flags(
+            uint32_t primitive_index, std::optional<uint32_t> next_index
+    ) const {
+        uint8_t flags = BGFX_DISCARD_ALL;
+        if (!next_index.has_value())
+            return flags;
+
+        if (*next_index == primitive_index) {
+            flags &= ~primitive_discard_flags;
+        }
+
+        if (primitives_[*next_index].texture_key_ ==
+            primitives_[primitive_index].texture_key_) {
+            flags &= ~BGFX_DISCARD_BINDINGS;
+        }
+
+        return flags;
+    }
+
+    void RenderQueue::bind_primitive(
+            Recorder &recorder, uint32_t primitive_index
+    ) const {
+        auto const &entry     = primitives_[primitive_index];
+        auto const &primitive = *entry.primitive_ptr_;
+        auto       &encoder   = recorder.encoder_;
+        auto       &bound     = recorder.bound_;
+
+        if (bound.primitive_index_ != primitive_index) {
+            auto const &geometry  = primitive.get_geometry();
+            auto const &pool      = GeometryPool::get_instance();
+            auto const  lod_range = primitive.get_lod_range(entry.lod_);
+
+            encoder.setVertexBuffer(
+                    0, pool.get_vertex_buffer(geometry.page_index_),
+                    geometry.base_vertex_, geometry.vertex_count_
+            );
+            encoder.setIndexBuffer(
+                    pool.get_index_buffer(geometry.page_index_),
+                    geometry.first_index_ + lod_range.first_index_,
+                    lod_range.index_count_
+            );
+            encoder.setState(get_state(primitive, recorder.pass_));
+            bound.primitive_index_ = primitive_index;
+        }
+
+        // The depth prepass doesn't read any material.
+        if (recorder.pass_ == Pass::DepthPrepass)
+            return;
+
+        if (bound.texture_key_ != entry.texture_key_) {
+            auto const &texture_indices = primitive.get_texture_indices();
+            if (texture_indices.albedo_) {
+                texture_indices.albedo_->submit(
+                        encoder, TextureType::Albedo, 0
+                );
+            }
+            bound.texture_key_ = entry.texture_key_;
+        }
+
+        // Uniform values persist between draws, only the changes have to be submitted.
+        auto const &base_color_factor = primitive.get_base_color_factor();
+        if (bound.base_color_factor_ != base_color_factor) {
+            encoder.setUniform(
+                    TextureStore::get_instance().get_base_color_factor(),
+                    base_color_factor.get_data().data()
+            );
+            bound.base_color_factor_ = base_color_factor;
+        }
+    }
+
+    void RenderQueue::submit_draw(
+            Recorder &recorder, bgfx::ProgramHandle program,
+            uint32_t primitive_index, uint32_t order,
+            std::optional<uint32_t>   next_index,
+            std::optional<IndexRange> index_range
+    ) const {
+        bind_primitive(recorder, primitive_index);
+
+        uint8_t flags = get_discard_flags(primitive_index, next_index);
+        if (index_range) {
+            auto const &geometry =
+                    primitives_[primitive_index].primitive_ptr_->get_geometry();
+
+            recorder.encoder_.setIndexBuffer(
+                    GeometryPool::get_instance().get_index_buffer(
+                            geometry.page_index_
+                    ),
+                    geometry.first_index_ + index_range->first_index_,
+                    index_range->index_count_
+            );
+            // The next draw has to bind the whole index range again.
+            flags |= BGFX_DISCARD_INDEX_BUFFER;
+        }
+        recorder.encoder_.submit(recorder.view_id_, program, order, flags);
+
+        if ((flags & primitive_discard_flags) != 0) {
+            recorder.bound_.primitive_index_.reset();
+        }
+        if ((flags & BGFX_DISCARD_BINDINGS) != 0) {
+            recorder.bound_.texture_key_.reset();
+        }
+    }
+
+    void RenderQueue::submit_individually(
+            Recorder &recorder, std::span<DrawItem const> run,
+            std::optional<uint32_t> next_index
+    ) const {
+        for (std::size_t i = 0; i < run.size(); ++i) {
+            auto const &item = run[i];
+
+            auto const &entry = primitives_[item.primitive_index_];
+            auto const  item_next_index =
+                    i + 1 < run.size() ? std::optional{item.primitive_index_}
+                                       : next_index;
+
+            // Clusters only cover the full detail, coarser levels are drawn whole.
+            if (entry.lod_ == 0 &&
+                !entry.primitive_ptr_->get_clusters().empty()) {
+                submit_clusters(recorder, item, item_next_index);
+                continue;
+            }
+
+            recorder.encoder_.setTransform(
+                    transforms_[item.transform_index_].data()
+            );
+            submit_draw(
+                    recorder,
+                    get_program(recorder.pass_, item.primitive_index_, false),
+                    item.primitive_index_, get_order(item), item_next_index
+            );
+        }
+    }
+
+    void RenderQueue::submit_clusters(
+            Recorder &recorder, DrawItem const &item,
+            std::optional<uint32_t> next_index
+    ) const {
+        auto const &entry     = primitives_[item.primitive_index_];
+        auto const &transform = transforms_[item.transform_index_];
+
+        // Clusters are stored in the space of the vertices, the frustum and camera are brought into that space
+        // instead of transforming every cluster.
+        auto &visible_ranges = recorder.visible_ranges_;
+        visible_ranges.clear();
+        entry.primitive_ptr_->get_clusters().cull(
+                frustum_.to_local_space(transform),
+                to_local_space(transform, camera_position_), visible_ranges
+        );
+
+        for (std::size_t i = 0; i < visible_ranges.size(); ++i) {
+            recorder.encoder_.setTransform(transform.data());
+            submit_draw(
+                    recorder,
+                    get_program(recorder.pass_, item.primitive_index_, false),
+                    item.primitive_index_, get_order(item),
+                    i + 1 < visible_ranges.size()
+                            ? std::optional{item.primitive_index_}
+                            : next_index,
+                    visible_ranges[i]
+            );
+        }
+    }
+
+    void RenderQueue::submit_instanced(
+            Recorder &recorder, std::span<DrawItem const> run,
+            std::optional<uint32_t> next_index
+    ) const {
+        auto const     total           = static_cast<uint32_t>(run.size());
+        uint32_t const primitive_index = run.front().primitive_index_;
+        uint32_t       submitted{};
+
+        while (submitted < total) {
+            bgfx::InstanceDataBuffer instance_data_buffer;
+            uint32_t                 count;
+            {
+                std::lock_guard const lock{instance_data_mutex_};
+
+                count = bgfx::getAvailInstanceDataBuffer(
+                        total - submitted, instance_stride
+                );
+                if (count != 0) {
+                    bgfx::allocInstanceDataBuffer(
+                            &instance_data_buffer, count, instance_stride
+                    );
+                }
+            }
+            if (count == 0) {
+                // The instance data was checked before the passes, this only happens if something else used it up
+                // since. The rest goes through the regular path.
+                submit_individually(
+                        recorder, run.subspan(submitted), next_index
+                );
+                return;
+            }
+
+            for (uint32_t i = 0; i < count; ++i) {
+                std::memcpy(
+                        instance_data_buffer.data + i * instance_stride,
+                        transforms_[run[submitted + i].transform_index_].data(),
+                        instance_stride
+                );
+            }
+
+            uint32_t const order = get_order(run[submitted]);
+            submitted += count;
+
+            recorder.encoder_.setInstanceDataBuffer(&instance_data_buffer);
+            submit_draw(
+                    recorder,
+                    get_program(recorder.pass_, primitive_index, true),
+                    primitive_index, order,
+                    submitted < total ? std::optional{primitive_index}
+                                      : next_index
+            );
+        }
+    }
+}// namespace engine
@@ -0,0 +1,263 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <array>
+#include <bgfx/bgfx.h>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "culling.h"
+#include "lod_selection.h"
+#include "math/vec.h"
+#include "mesh_clusters.h"
+#include "shader_store.h"
+
+namespace engine {
+    class OcclusionBuffer;
+    class Primitive;
+
+    // Collects the draws of a frame as compact items, culls them against the view frustum and the occluders, sorts them
+    // by a 64-bit key and submits them in that order. Each draw is culled with the bounds of its own primitive, so
+    // parts of a large mesh are culled even if the bounds of the whole mesh contain the camera.
+    // Sorting puts draws sharing a program, texture and material next to each other, which lets submission skip
+    // redundant state, uniform and texture binds, and turns runs of the same primitive into one instanced draw call.
+    // The sorted items are split into chunks that are recorded in parallel, each on its own bgfx encoder.
+    // Primitives with clusters that are drawn once are culled per cluster as well, only the index ranges of the
+    // visible clusters are submitted.
+    // Each draw uses one level of detail of its primitive, draws of different levels are batched separately.
+    // With a depth prepass, all draws are first submitted front to back with a position-only program that only writes
+    // depth. The opaque pass then only shades the fragments whose depth equals the closest one, so overdraw no longer
+    // multiplies the cost of the fragment shaders.
+    class RenderQueue final {
+    public:
+        // Column-major, as expected by bgfx::setTransform and the i_data0..3 instance attributes.
+        using InstanceTransform = std::array<float, 4 * 4>;
+
+        // Key layout, from the most to the least significant bits.
+        static constexpr int program_bits   = 10;
+        static constexpr int texture_bits   = 14;
+        static constexpr int material_bits  = 12;
+        static constexpr int primitive_bits = 12;
+        static constexpr int depth_bits     = 16;
+
+        static_assert(
+                program_bits + texture_bits + material_bits + primitive_bits +
+                        depth_bits ==
+                64
+        );
+
+        struct DrawItem final {
+            uint64_t sort_key_;
+            uint32_t transform_index_;
+            uint32_t primitive_index_;
+        };
+
+        // The views the passes are submitted to, there's no depth prepass if it has no view.
+        struct Views final {
+            std::optional<bgfx::ViewId> depth_prepass_;
+            bgfx::ViewId                opaque_;
+        };
+
+        // Must be called before adding draws. `view_mtx` is the view matrix as passed to bgfx::setViewTransform,
+        // it is used to compute the view depth of the draws. Draws hidden behind the occluders in the occlusion
+        // buffer, if there is one, are culled, its hierarchy has to be built before submit is called.
+        void
+        begin(std::span<float const, 4 * 4> view_mtx, float far_plane,
+              Frustum const &frustum, ProjectedSizeCutoff const &size_cutoff,
+              LodSelection const    &lod_selection,
+              OcclusionBuffer const *occlusion_buffer_ptr = nullptr);
+
+        [[nodiscard]]
+        math::Vec3 const &get_camera_position() const {
+            return camera_position_;
+        }
+
+        // How the draws added to this queue should pick their level of detail.
+        [[nodiscard]]
+        LodSelection const &get_lod_selection() const {
+            return lod_selection_;
+        }
+
+        [[nodiscard]]
+        uint32_t add_transform(InstanceTransform const &transform);
+
+        // Draws level of detail `lod` of the primitive.
+        void
+        add(Primitive const &primitive, std::size_t lod,
+            bgfx::ProgramHandle program, bgfx::ProgramHandle instanced_program,
+            uint32_t transform_index, math::Aabb const &world_bounds);
+
+        // Culls, sorts and submits every draw added since the last call to begin. Must be called from the thread
+        // that calls bgfx::frame.
+        void submit(Views const &views);
+
+    private:
+        struct PrimitiveEntry final {
+            Primitive const    *primitive_ptr_;
+            bgfx::ProgramHandle program_;
+            bgfx::ProgramHandle instanced_program_;
+            uint32_t            texture_key_;
+            uint8_t             lod_;
+            // Decided once per frame, so that the depth prepass and the opaque pass draw the primitive through the
+            // same vertex path and produce the same depth.
+            bool                instanced_{};
+        };
+
+        struct PrimitiveKey final {
+            Primitive const *primitive_ptr_;
+            uint16_t         program_idx_;
+            uint8_t          lod_;
+
+            [[nodiscard]]
+            bool operator==(PrimitiveKey const &) const = default;
+        };
+
+        struct PrimitiveKeyHasher final {
+            [[nodiscard]]
+            std::size_t operator()(PrimitiveKey const &key) const;
+        };
+
+        // What the previous submit left bound, so that the next draw can skip setting it again.
+        struct BoundState final {
+            std::optional<uint32_t>   primitive_index_;
+            std::optional<uint32_t>   texture_key_;
+            std::optional<math::Vec4> base_color_factor_;
+        };
+
+        // Items [first_, last_) that share a primitive.
+        struct Run final {
+            std::size_t first_;
+            std::size_t last_;
+        };
+
+        // Runs [first_, last_) that are recorded on the same encoder.
+        struct Chunk final {
+            std::size_t first_;
+            std::size_t last_;
+        };
+
+        enum class Pass {
+            DepthPrepass,
+            // Drawn after a depth prepass.
+            DepthEqual,
+            // Drawn without a depth prepass.
+            DepthLess,
+        };
+
+        // Per-chunk recording state, only touched by the thread recording the chunk.
+        struct Recorder final {
+            bgfx::Encoder          &encoder_;
+            bgfx::ViewId            view_id_;
+            Pass                    pass_;
+            BoundState              bound_{};
+            std::vector<IndexRange> visible_ranges_{};
+        };
+
+        using PrimitiveIndices =
+                std::unordered_map<PrimitiveKey, uint32_t, PrimitiveKeyHasher>;
+
+        ProgramHandle                  depth_program_{
+                ShaderStore::get_instance().get_program(
+                        "depth_vert", "depth_frag"
+                )
+        };
+        ProgramHandle                  depth_instanced_program_{
+                ShaderStore::get_instance().get_program(
+                        "depth_instanced_vert", "depth_frag"
+                )
+        };
+        std::array<float, 4 * 4>       view_mtx_{};
+        math::Vec3                     camera_position_{};
+        float                          far_plane_{1.f};
+        Frustum                        frustum_{};
+        ProjectedSizeCutoff            size_cutoff_{};
+        LodSelection                   lod_selection_{};
+        OcclusionBuffer const         *occlusion_buffer_ptr_{};
+        BoundsCuller                   culler_{};
+        std::vector<uint8_t>           visible_;
+        std::vector<InstanceTransform> transforms_;
+        std::vector<PrimitiveEntry>    primitives_;
+        PrimitiveIndices               primitive_indices_;
+        std::vector<DrawItem>          items_;
+        // Size in pixels of the bounds of each item, for texture residency.
+        std::vector<float>             screen_sizes_;
+        // World bounds of each item, for the occlusion test.
+        std::vector<math::Aabb>        world_bounds_;
+        std::vector<DrawItem>          sort_scratch_;
+        // Visible draws of each primitive.
+        std::vector<uint32_t>          draw_counts_;
+        std::vector<Run>               runs_;
+        std::vector<Chunk>             chunks_;
+        // Checking for and allocating transient instance data has to happen atomically across the recording threads.
+        mutable std::mutex             instance_data_mutex_;
+
+        [[nodiscard]]
+        static uint64_t get_state(Primitive const &primitive, Pass pass);
+
+        [[nodiscard]]
+        float get_view_depth(math::Vec3 const &world_position) const;
+
+        void remove_culled_items();
+
+        // Instances primitives with enough visible draws, as long as the instance data of all passes fits.
+        void choose_instancing(bool has_depth_prepass);
+
+        void build_runs();
+
+        void build_chunks();
+
+        // Sorts the items by `get_key`, and records them on the view in parallel.
+        template<typename GetKey>
+        void submit_pass(bgfx::ViewId view_id, Pass pass, GetKey &&get_key);
+
+        void record_chunk(
+                bgfx::ViewId view_id, Pass pass, std::size_t chunk_index
+        ) const;
+
+        [[nodiscard]]
+        bgfx::ProgramHandle get_program(
+                Pass pass, uint32_t primitive_index, bool instanced
+        ) const;
+
+        // Position of the item among the sorted items, submitted as the depth bgfx sorts by.
+        [[nodiscard]]
+        uint32_t get_order(DrawItem const &item) const {
+            return static_cast<uint32_t>(&item - items_.data());
+        }
+
+        [[nodiscard]]
+        uint8_t get_discard_flags(
+                uint32_t primitive_index, std::optional<uint32_t> next_index
+        ) const;
+
+        void bind_primitive(Recorder &recorder, uint32_t primitive_index) const;
+
+        // Draws the whole primitive, or only `index_range` of it if one is given.
+        void submit_draw(
+                Recorder &recorder, bgfx::ProgramHandle program,
+                uint32_t primitive_index, uint32_t order,
+                std::optional<uint32_t>   next_index,
+                std::optional<IndexRange> index_range = std::nullopt
+        ) const;
+
+        void submit_clusters(
+                Recorder &recorder, DrawItem const &item,
+                std::optional<uint32_t> next_index
+        ) const;
+
+        void submit_individually(
+                Recorder &recorder, std::span<DrawItem const> run,
+                std::optional<uint32_t> next_index
+        ) const;
+
+        void submit_instanced(
+                Recorder &recorder, std::span<DrawItem const> run,
+                std::optional<uint32_t> next_index
+        ) const;
+    };
+}// namespace engine
+
+#endif//RENDER_QUEUE_H
@@ -0,0 +1,50 @@
+#include "spatial_index.h"
+
+#include "components/mesh_renderer.h"
+#include "components/transform.h"
+
+namespace engine {
+    SpatialIndex::SpatialIndex(entt::registry &registry) {
+        registry.on_construct<MeshRenderer>().connect<&on_renderer_added>();
+        registry.on_destroy<MeshRenderer>().connect<&on_renderer_removed>();
+    }
+
+    void SpatialIndex::update(entt::registry &registry) {
+        auto const moved = registry.view<MeshRenderer const, TransformMoved>();
+
+        for (auto const entity : moved) {
+            auto const bounds =
+                    moved.get<MeshRenderer const>(entity).get_world_bounds();
+
+            if (auto const *proxy = registry.try_get<SpatialProxy>(entity)) {
+                tree_.move_proxy(proxy->proxy_id_, bounds);
+                continue;
+            }
+
+            auto const proxy_id =
+                    tree_.create_proxy(bounds, entt::to_integral(entity));
+            registry.emplace<SpatialProxy>(entity, proxy_id);
+        }
+
+        registry.clear<TransformMoved>();
+    }
+
+    void SpatialIndex::on_renderer_added(
+            entt::registry &registry, entt::entity entity
+    ) {
+        // The renderer gets inserted into the tree on the next update, once its transform is set up.
+        registry.emplace_or_replace<TransformMoved>(entity);
+    }
+
+    void SpatialIndex::on_renderer_removed(
+            entt::registry &registry, entt::entity entity
+    ) {
+        auto const *proxy = registry.try_get<SpatialProxy>(entity);
+        if (!proxy)
+            return;
+
+        auto &spatial_index = registry.ctx().get<SpatialIndex>();
+        spatial_index.tree_.destroy_proxy(proxy->proxy_id_);
+        registry.remove<SpatialProxy>(entity);
+    }
+}// namespace engine
@@ -0,0 +1,49 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <entt/entity/registry.hpp>
+
+#include "culling.h"
+#include "misc/dynamic_aabb_tree.h"
+
+namespace engine {
+    // Tree node of an entity in the spatial index.
+    struct SpatialProxy final {
+        DynamicAabbTree::ProxyId proxy_id_;
+    };
+
+    // Bounding volume hierarchy over the world bounds of all mesh renderers of a registry.
+    // It lives in the registry context and follows the MeshRenderer and TransformMoved components, only entities that
+    // moved since the last update are refitted.
+    class SpatialIndex final {
+    public:
+        explicit SpatialIndex(entt::registry &registry);
+
+        // Brings the index up to date with the renderers that were added or moved, must be called before querying.
+        void update(entt::registry &registry);
+
+        // Calls `callback(entity)` for every renderer whose bounds may intersect the frustum.
+        template<typename Callback>
+        void query(Frustum const &frustum, Callback &&callback) const {
+            tree_.query(
+                    [&frustum](math::Aabb const &bounds) {
+                        return frustum.intersects(bounds);
+                    },
+                    [&callback](uint32_t user_data) {
+                        callback(static_cast<entt::entity>(user_data));
+                    }
+            );
+        }
+
+    private:
+        DynamicAabbTree tree_{};
+
+        static void
+        on_renderer_added(entt::registry &registry, entt::entity entity);
+
+        static void
+        on_renderer_removed(entt::registry &registry, entt::entity entity);
+    };
+}// namespace engine
+
+#endif//SPATIAL_INDEX_H
@@ -1,17 +1,27 @@
 #include "texture.h"
 
+#include <algorithm>
 #include <bgfx/bgfx.h>
 #include <cassert>
 #include <format>
-#include <fstream>
+#include <memory>
 #include <stb_image.h>
+#include <string_view>
 
+#include "misc/mapped_file.h"
 #include "misc/utils.h"
+#include "texture_processing/block_compression.h"
+#include "texture_processing/ktx.h"
 #include "texture_store.h"
 
 namespace engine {
-    void stbi_image_release(void *, void *user_data_ptr) {
-        stbi_image_free(user_data_ptr);
+    [[nodiscard]]
+    bool is_container(std::span<stbi_uc const> data) {
+        constexpr std::string_view dds_magic{"DDS "};
+
+        return texture_processing::is_ktx(data) ||
+               (data.size() >= dds_magic.size() &&
+                std::equal(dds_magic.begin(), dds_magic.end(), data.begin()));
     }
 
     [[nodiscard]]
@@ -32,73 +42,186 @@ namespace engine {
         }
     }
 
-    Texture::Texture(
-            std::string const &name, stbi_uc *image_data_ptr, int width,
-            int height, int channels
-    )
-        : width_{width}
-        , height_{height}
-        , channels_{channels}
-        , image_data_ptr_{[image_data_ptr] {
-            if (image_data_ptr == nullptr) {
-                throw std::runtime_error(
-                        std::format(
-                                "Failed to load image: {}",
-                                stbi_failure_reason()
-                        )
+    [[nodiscard]]
+    texture_processing::MipChain build_mip_chain(
+            stbi_uc *image_data_ptr, int width, int height, int channels,
+            ThreadPool &thread_pool
+    ) {
+        if (image_data_ptr == nullptr) {
+            throw std::runtime_error(std::format(
+                    "Failed to load image: {}", stbi_failure_reason()
+            ));
+        }
+
+        std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> const image_data{
+                image_data_ptr, &stbi_image_free
+        };
+
+        return texture_processing::build_mip_chain(
+                std::span{
+                        image_data.get(),
+                        static_cast<std::size_t>(width) * height * channels
+                },
+                width, height, channels, texture_processing::ColorSpace::Srgb,
+                thread_pool
+        );
+    }
+
+    [[nodiscard]]
+    texture_processing::MipChain decode_mip_chain(
+            std::span<stbi_uc const> image_data, ThreadPool &thread_pool
+    ) {
+        int   width;
+        int   height;
+        int   channels;
+        auto *image_data_ptr = stbi_load_from_memory(
+                image_data.data(), static_cast<int>(image_data.size_bytes()),
+                &width, &height, &channels, 0
+        );
+
+        return build_mip_chain(
+                image_data_ptr, width, height, channels, thread_pool
+        );
+    }
+
+    MipChainView
+    MipChainView::from_chain(texture_processing::MipChain &&chain) {
+        auto const chain_ptr =
+                std::make_shared<texture_processing::MipChain const>(
+                        std::move(chain)
                 );
-            }
 
-            return image_data_ptr;
-        }()}
+        return MipChainView{
+                chain_ptr->channels_, chain_ptr->levels_,
+                SharedBytes{chain_ptr, chain_ptr->data_}
+        };
+    }
 
-        , texture_handle_{[this] {
-            auto const *mem = bgfx::makeRef(
-                    image_data_ptr_, get_byte_size(), stbi_image_release,
-                    image_data_ptr_
-            );
+    DecodedImage DecodedImage::from_file(
+            std::filesystem::path const &path, ThreadPool &thread_pool
+    ) {
+        auto const file = map_file(path);
+        // Containers are uploaded straight from the mapping.
+        if (is_container(file.bytes_))
+            return DecodedImage{file, true};
 
-            return UTextureHandle{bgfx::createTexture2D(
-                    width_, height_, false, 1,
-                    get_format_from_channels(channels_), BGFX_TEXTURE_NONE, mem
+        return DecodedImage{MipChainView::from_chain(
+                decode_mip_chain(file.bytes_, thread_pool)
+        )};
+    }
+
+    DecodedImage DecodedImage::from_memory(
+            std::span<stbi_uc const> image_data, ThreadPool &thread_pool
+    ) {
+        if (is_container(image_data)) {
+            return DecodedImage{SharedBytes::from_vector(
+                    std::vector<uint8_t>(image_data.begin(), image_data.end())
             )};
-        }()} {
-        utils::verify_bgfx_handle(texture_handle_.get(), stbi_failure_reason);
+        }
 
-        bgfx::setName(texture_handle_.get(), name.data());
+        return DecodedImage{MipChainView::from_chain(
+                decode_mip_chain(image_data, thread_pool)
+        )};
     }
 
-    Texture::Texture(std::filesystem::path const &path, std::string const &name)
-        : Texture{[&] {
-            int   width;
-            int   height;
-            int   channels;
-            auto *image_data_ptr = stbi_load(
-                    path.string().c_str(), &width, &height, &channels, 0
-            );
+    std::size_t DecodedImage::get_byte_size() const {
+        if (auto const *chain_ptr = std::get_if<MipChainView>(&data_))
+            return chain_ptr->data_.bytes_.size();
+
+        return std::get<SharedBytes>(data_).bytes_.size();
+    }
+
+    Texture::Texture(std::string name, Source source, bool keep_source)
+        : name_{std::move(name)}
+        , source_{std::move(source)} {
+        if (auto const *chain_ptr = std::get_if<MipChainView>(&*source_)) {
+            auto const &chain = *chain_ptr;
+            width_            = static_cast<int>(chain.levels_.front().width_);
+            height_           = static_cast<int>(chain.levels_.front().height_);
+            channels_         = static_cast<int>(chain.channels_);
+            mip_count_        = static_cast<uint32_t>(chain.levels_.size());
+            full_byte_size_   = chain.data_.bytes_.size();
+        }
+
+        create(0);
+        // bgfx holds its own reference until the upload is done.
+        if (!keep_source)
+            source_.reset();
+    }
 
-            return Texture{name, image_data_ptr, width, height, channels};
-        }()} {
+    Texture::Texture(DecodedImage &&image, std::string const &name)
+        : Texture{name, std::move(image.data_), image.mapped_} {
+    }
+
+    Texture::Texture(std::filesystem::path const &path, std::string const &name)
+        : Texture{DecodedImage::from_file(path), name} {
     }
 
     Texture::Texture(
             std::span<stbi_uc const> image_data, std::string const &name
     )
-        : Texture{[&] {
-            int   width;
-            int   height;
-            int   channels;
-            auto *image_data_ptr = stbi_load_from_memory(
-                    image_data.data(),
-                    static_cast<int>(image_data.size_bytes()), &width, &height,
-                    &channels, 0
-            );
+        : Texture{DecodedImage::from_memory(image_data), name} {
+    }
+
+    void Texture::create(uint32_t first_mip) {
+        // References keep the image data alive until bgfx is done with it, even if the texture is gone by then.
+        UTextureHandle texture_handle;
+        if (auto const *chain_ptr = std::get_if<MipChainView>(&*source_)) {
+            auto const &chain = *chain_ptr;
+            auto const &level = chain.levels_[first_mip];
+
+            byte_size_ = chain.data_.bytes_.size() - level.offset_;
+            auto const *mem =
+                    utils::make_bgfx_ref(chain.data_.subspan(level.offset_));
+            texture_handle = UTextureHandle{bgfx::createTexture2D(
+                    static_cast<uint16_t>(level.width_),
+                    static_cast<uint16_t>(level.height_), true, 1,
+                    get_format_from_channels(channels_), BGFX_TEXTURE_NONE, mem
+            )};
+        } else {
+            auto const *mem =
+                    utils::make_bgfx_ref(std::get<SharedBytes>(*source_));
+            bgfx::TextureInfo info{};
+            texture_handle = UTextureHandle{bgfx::createTexture(
+                    mem, BGFX_TEXTURE_NONE, static_cast<uint8_t>(first_mip),
+                    &info
+            )};
+            byte_size_ = info.storageSize;
 
-            return Texture{name, image_data_ptr, width, height, channels};
-        }()} {
+            // bgfx only reports the size of the full texture when no levels are skipped, which is how it's created
+            // first.
+            if (first_mip == 0) {
+                width_  = info.width;
+                height_ = info.height;
+                // Block compressed formats are sampled as RGBA.
+                channels_       = 4;
+                mip_count_      = info.numMips;
+                full_byte_size_ = info.storageSize;
+            }
+        }
+
+        utils::verify_bgfx_handle(
+                texture_handle.get(),
+                std::format("Failed to create texture: {}", name_)
+        );
+        bgfx::setName(texture_handle.get(), name_.data());
+
+        texture_handle_ = std::move(texture_handle);
+        first_mip_      = first_mip;
+    }
+
+    void Texture::set_first_mip(uint32_t first_mip) {
+        if (!source_)
+            return;
+
+        first_mip = std::min(first_mip, mip_count_ - 1);
+        if (first_mip != first_mip_)
+            create(first_mip);
     }
 
-    void Texture::submit(TextureType type, int stage) const {
+    void Texture::submit(
+            bgfx::Encoder &encoder, TextureType type, int stage
+    ) const {
         auto const uniform_handle = [type] -> UniformUniqueHandle::handle {
             auto const &texture_store = TextureStore::get_instance();
 
@@ -111,6 +234,26 @@ namespace engine {
             }
         }();
 
-        bgfx::setTexture(stage, uniform_handle, texture_handle_.get());
+        encoder.setTexture(stage, uniform_handle, texture_handle_.get());
+    }
+
+    DecodedImage compress_image(
+            std::span<stbi_uc const> image_data, ThreadPool &thread_pool
+    ) {
+        if (is_container(image_data))
+            return DecodedImage::from_memory(image_data, thread_pool);
+
+        auto const chain  = decode_mip_chain(image_data, thread_pool);
+        auto const format = chain.channels_ == 2 || chain.channels_ == 4
+                                  ? texture_processing::BlockFormat::BC7
+                                  : texture_processing::BlockFormat::BC1;
+
+        auto const compressed = texture_processing::compress_texture(
+                chain, format, thread_pool
+        );
+
+        return DecodedImage{SharedBytes::from_vector(
+                texture_processing::encode_ktx(compressed)
+        )};
     }
 }// namespace engine
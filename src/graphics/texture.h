@@ -2,10 +2,19 @@
 #define TEXTURE_H
 
 #include <bgfx/bgfx.h>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <span>
+#include <string>
+#include <variant>
+#include <vector>
 
+#include "misc/shared_bytes.h"
+#include "misc/thread_pool.h"
 #include "misc/unique_handle.h"
+#include "texture_processing/mip_chain.h"
 #include "types.h"
 
 namespace {
@@ -21,20 +30,76 @@ namespace engine {
         Albedo,
     };
 
+    // The levels of a mip chain, laid out like in a MipChain, whose data is owned elsewhere, e.g. by a MipChain or a
+    // mapped scene cache.
+    struct MipChainView final {
+        uint32_t                                  channels_{};
+        std::vector<texture_processing::MipLevel> levels_;
+        SharedBytes                               data_;
+
+        [[nodiscard]]
+        static MipChainView from_chain(texture_processing::MipChain &&chain);
+    };
+
+    // An image that is ready to be uploaded. Decoding doesn't call into bgfx, so images can be decoded on any thread
+    // and only creating their Texture has to happen on the thread that owns bgfx.
+    struct DecodedImage final {
+        // The full mip chain of the image, or a KTX or DDS file that bgfx parses itself.
+        std::variant<MipChainView, SharedBytes> data_;
+        // Whether the data is a view of a mapped file, like a cooked scene or a KTX file, which the texture can read
+        // again without holding a copy.
+        bool                                    mapped_{false};
+
+        // The mip chain is built on the given thread pool.
+        [[nodiscard]]
+        static DecodedImage from_file(
+                std::filesystem::path const &path,
+                ThreadPool &thread_pool = ThreadPool::get_instance()
+        );
+
+        [[nodiscard]]
+        static DecodedImage from_memory(
+                std::span<stbi_uc const> image_data,
+                ThreadPool &thread_pool = ThreadPool::get_instance()
+        );
+
+        // Bytes that are handed to bgfx when the image is uploaded.
+        [[nodiscard]]
+        std::size_t get_byte_size() const;
+    };
+
+    // Images are uploaded with their full mip chain, which is built on the thread pool. Their colors are assumed to
+    // be sRGB encoded, the only textures that are sampled are albedo textures. KTX and DDS files are uploaded as they
+    // are, block compressed and with the mips they contain.
+    // Textures of mapped images keep the mapping, so that the largest levels can be dropped from the GPU and read
+    // again. Other images are released once they're uploaded, their textures keep all of their levels.
     class Texture final {
         using UTextureHandle = UniqueHandle<
                 bgfx::TextureHandle, BGFX_INVALID_HANDLE, GenericBgfxDestroyer>;
 
-        int            width_{};
-        int            height_{};
-        int            channels_{};
-        void          *image_data_ptr_;
-        UTextureHandle texture_handle_;
+    public:
+        using Source = std::variant<MipChainView, SharedBytes>;
 
-        Texture(std::string const &name, stbi_uc *image_data_ptr, int width,
-                int height, int channels);
+    private:
+        std::string           name_;
+        // Empty if the image wasn't mapped.
+        std::optional<Source> source_;
+        int                   width_{};
+        int                   height_{};
+        int                   channels_{};
+        uint32_t              mip_count_{};
+        uint32_t              first_mip_{};
+        std::size_t           full_byte_size_{};
+        std::size_t           byte_size_{};
+        UTextureHandle        texture_handle_;
+
+        Texture(std::string name, Source source, bool keep_source);
+
+        void create(uint32_t first_mip);
 
     public:
+        explicit Texture(DecodedImage &&image, std::string const &name);
+
         explicit Texture(
                 std::filesystem::path const &path, std::string const &name
         );
@@ -43,13 +108,61 @@ namespace engine {
                 std::span<stbi_uc const> image_data, std::string const &name
         );
 
+        // Size of the mip levels on the GPU.
         [[nodiscard]]
         std::size_t get_byte_size() const {
-            return width_ * height_ * channels_;
+            return byte_size_;
+        }
+
+        // Size of all mip levels.
+        [[nodiscard]]
+        std::size_t get_full_byte_size() const {
+            return full_byte_size_;
+        }
+
+        // Size of the largest level, even if it isn't resident.
+        [[nodiscard]]
+        int get_width() const {
+            return width_;
         }
 
-        void submit(TextureType type, int stage) const;
+        [[nodiscard]]
+        int get_height() const {
+            return height_;
+        }
+
+        [[nodiscard]]
+        uint32_t get_mip_count() const {
+            return mip_count_;
+        }
+
+        // The largest level that is resident.
+        [[nodiscard]]
+        uint32_t get_first_mip() const {
+            return first_mip_;
+        }
+
+        // Only textures that kept their image data can drop levels.
+        [[nodiscard]]
+        bool can_drop_levels() const {
+            return source_.has_value();
+        }
+
+        // Recreates the texture from its image data with only the levels from `first_mip` on. Does nothing if it
+        // can't drop levels.
+        void set_first_mip(uint32_t first_mip);
+
+        void
+        submit(bgfx::Encoder &encoder, TextureType type, int stage) const;
     };
+
+    // Decodes an image, builds its mip chain and block compresses it into a KTX file in memory. Images with alpha are
+    // compressed to BC7, others to BC1. KTX and DDS files are kept as they are.
+    [[nodiscard]]
+    DecodedImage compress_image(
+            std::span<stbi_uc const> image_data,
+            ThreadPool              &thread_pool = ThreadPool::get_instance()
+    );
 }// namespace engine
 
 #endif//TEXTURE_H
@@ -0,0 +1,100 @@
+#include "texture_residency.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace engine {
+    std::size_t
+    get_resident_byte_size(std::size_t full_byte_size, uint32_t first_mip) {
+        assert(first_mip < 32);
+
+        return full_byte_size >> (first_mip * 2);
+    }
+
+    uint32_t get_required_first_mip(
+            uint32_t width, uint32_t height, uint32_t mip_count,
+            float screen_size
+    ) {
+        if (mip_count <= 1)
+            return 0;
+        if (screen_size <= 1.f)
+            return mip_count - 1;
+
+        float const texels_per_pixel =
+                static_cast<float>(std::max(width, height)) / screen_size;
+        if (texels_per_pixel <= 1.f)
+            return 0;
+
+        auto const first_mip =
+                static_cast<uint32_t>(std::floor(std::log2(texels_per_pixel)));
+
+        return std::min(first_mip, mip_count - 1);
+    }
+
+    uint32_t get_kept_first_mip(
+            uint32_t width, uint32_t height, uint32_t mip_count,
+            uint32_t first_mip, float screen_size, bool may_drop
+    ) {
+        uint32_t const required_first_mip =
+                get_required_first_mip(width, height, mip_count, screen_size);
+        if (required_first_mip <= first_mip)
+            return required_first_mip;
+        if (!may_drop)
+            return first_mip;
+
+        return std::max(
+                first_mip, get_required_first_mip(
+                                   width, height, mip_count,
+                                   screen_size * residency_drop_margin
+                           )
+        );
+    }
+
+    std::size_t fit_residency_budget(
+            std::span<TextureResidency> textures, std::size_t budget
+    ) {
+        std::size_t total{};
+        for (auto const &texture : textures) {
+            total += get_resident_byte_size(
+                    texture.full_byte_size_, texture.first_mip_
+            );
+        }
+        if (total <= budget)
+            return total;
+
+        std::vector<std::size_t> order(textures.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::ranges::sort(order, [&](std::size_t lhs, std::size_t rhs) {
+            auto const &a = textures[lhs];
+            auto const &b = textures[rhs];
+            if (a.last_used_frame_ != b.last_used_frame_)
+                return a.last_used_frame_ < b.last_used_frame_;
+
+            return a.full_byte_size_ > b.full_byte_size_;
+        });
+
+        for (std::size_t const index : order) {
+            auto &texture = textures[index];
+
+            while (total > budget &&
+                   texture.first_mip_ + 1 < texture.mip_count_) {
+                std::size_t const size = get_resident_byte_size(
+                        texture.full_byte_size_, texture.first_mip_
+                );
+                ++texture.first_mip_;
+                total -= size - get_resident_byte_size(
+                                        texture.full_byte_size_,
+                                        texture.first_mip_
+                                );
+            }
+
+            if (total <= budget)
+                break;
+        }
+
+        return total;
+    }
+}// namespace engine
@@ -0,0 +1,55 @@
+#ifndef TEXTURE_RESIDENCY_H
+#define TEXTURE_RESIDENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace engine {
+    // The mips of a texture that should be resident. Textures only ever drop their largest levels, `first_mip_` is
+    // the largest level that is kept.
+    struct TextureResidency final {
+        // Size of all levels of the texture.
+        std::size_t full_byte_size_{};
+        uint32_t    mip_count_{1};
+        uint32_t    first_mip_{};
+        uint64_t    last_used_frame_{};
+    };
+
+    // Every level is a quarter of the previous one, so the levels from `first_mip` on take about a quarter of the
+    // size per dropped level.
+    [[nodiscard]]
+    std::size_t
+    get_resident_byte_size(std::size_t full_byte_size, uint32_t first_mip);
+
+    // The largest level that is still needed to draw the texture at `screen_size` pixels, assuming it is stretched
+    // once over that size. Textures that repeat get blurrier than that estimate, levels are rounded towards the sharper
+    // one to make up for some of it.
+    [[nodiscard]]
+    uint32_t get_required_first_mip(
+            uint32_t width, uint32_t height, uint32_t mip_count,
+            float screen_size
+    );
+
+    // Textures have to be this many times smaller on screen than a level needs before the level is dropped.
+    inline constexpr float residency_drop_margin = 1.5f;
+
+    // The largest level to keep of a texture drawn at `screen_size` pixels, whose largest resident level is
+    // `first_mip`. Levels that are needed are added right away. Levels that aren't are only dropped if `may_drop` and
+    // the texture is smaller than they need by the drop margin, so that a texture close to the size where a level is
+    // needed doesn't drop and upload it again every few frames.
+    [[nodiscard]]
+    uint32_t get_kept_first_mip(
+            uint32_t width, uint32_t height, uint32_t mip_count,
+            uint32_t first_mip, float screen_size, bool may_drop
+    );
+
+    // Drops levels of the least recently used textures first until all of them fit into the budget, larger textures
+    // go first among those last used in the same frame. Textures keep at least their smallest level. Returns the total
+    // resident size, which only exceeds the budget if the smallest levels alone do.
+    std::size_t fit_residency_budget(
+            std::span<TextureResidency> textures, std::size_t budget
+    );
+}// namespace engine
+
+#endif//TEXTURE_RESIDENCY_H
@@ -0,0 +1,132 @@
+#include "vertex_packing.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace engine {
+    namespace {
+        constexpr float snorm16_max = 32767.f;
+        // 2^24, the inverse of the smallest subnormal half.
+        constexpr float half_subnormal_scale = 16777216.f;
+    }// namespace
+
+    uint16_t float_to_half(float value) {
+        uint32_t const bits     = std::bit_cast<uint32_t>(value);
+        auto const     sign     = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        uint32_t const abs_bits = bits & 0x7fffffff;
+
+        // Infinity and NaN, NaNs stay quiet NaNs.
+        if (abs_bits >= 0x7f800000)
+            return sign | 0x7c00 | (abs_bits > 0x7f800000 ? 0x0200 : 0);
+
+        // 65520 and up round to infinity.
+        if (abs_bits >= 0x477ff000)
+            return sign | 0x7c00;
+
+        // Below the smallest normal half, 2^-14.
+        if (abs_bits < 0x38800000) {
+            float const scaled =
+                    std::bit_cast<float>(abs_bits) * half_subnormal_scale;
+
+            return sign | static_cast<uint16_t>(std::nearbyint(scaled));
+        }
+
+        // Rebias the exponent from 127 to 15 and round the mantissa to the nearest even value, a carry into the
+        // exponent is still correctly rounded.
+        uint32_t const rounded = abs_bits + 0x0fff + ((abs_bits >> 13) & 1);
+
+        return sign | static_cast<uint16_t>((rounded - 0x38000000) >> 13);
+    }
+
+    float half_to_float(uint16_t half) {
+        uint32_t const sign     = static_cast<uint32_t>(half & 0x8000) << 16;
+        uint32_t const exponent = (half >> 10) & 0x1f;
+        uint32_t const mantissa = half & 0x03ff;
+
+        if (exponent == 0) {
+            float const magnitude =
+                    static_cast<float>(mantissa) / half_subnormal_scale;
+
+            return sign != 0 ? -magnitude : magnitude;
+        }
+
+        if (exponent == 0x1f)
+            return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+
+        return std::bit_cast<float>(
+                sign | ((exponent + 112) << 23) | (mantissa << 13)
+        );
+    }
+
+    int16_t quantize_snorm16(float value) {
+        return static_cast<int16_t>(
+                std::lround(std::clamp(value, -1.f, 1.f) * snorm16_max)
+        );
+    }
+
+    float dequantize_snorm16(int16_t value) {
+        return std::max(static_cast<float>(value) / snorm16_max, -1.f);
+    }
+
+    PositionQuantization
+    PositionQuantization::from_bounds(math::Aabb const &bounds) {
+        auto const extents = bounds.get_extents();
+
+        // Flat bounds would divide by zero, any scale works for them as every position maps to 0.
+        auto const scale_of = [](float extent) {
+            return extent > 0.f ? extent : 1.f;
+        };
+
+        return PositionQuantization{
+                bounds.get_center(),
+                math::Vec3{
+                        scale_of(extents.get_x()), scale_of(extents.get_y()),
+                        scale_of(extents.get_z())
+                }
+        };
+    }
+
+    std::array<int16_t, 3>
+    PositionQuantization::quantize(math::Vec3 const &position) const {
+        return {quantize_snorm16(
+                        (position.get_x() - offset_.get_x()) / scale_.get_x()
+                ),
+                quantize_snorm16(
+                        (position.get_y() - offset_.get_y()) / scale_.get_y()
+                ),
+                quantize_snorm16(
+                        (position.get_z() - offset_.get_z()) / scale_.get_z()
+                )};
+    }
+
+    math::Vec3
+    PositionQuantization::dequantize(std::array<int16_t, 3> const &quantized
+    ) const {
+        return math::Vec3{
+                dequantize_snorm16(quantized[0]) * scale_.get_x() +
+                        offset_.get_x(),
+                dequantize_snorm16(quantized[1]) * scale_.get_y() +
+                        offset_.get_y(),
+                dequantize_snorm16(quantized[2]) * scale_.get_z() +
+                        offset_.get_z()
+        };
+    }
+
+    std::array<float, 4 * 4>
+    PositionQuantization::apply(std::span<float const, 4 * 4> model) const {
+        // Positions are row vectors, so the dequantization scales the first three rows of the model matrix and its
+        // offset is moved into the translation row.
+        std::array<float, 4 * 4> result{};
+        std::ranges::copy(model, result.begin());
+
+        for (std::size_t row = 0; row < 3; ++row) {
+            for (std::size_t col = 0; col < 4; ++col) {
+                result[row * 4 + col] *= scale_[row];
+                result[12 + col] += offset_[row] * model[row * 4 + col];
+            }
+        }
+
+        return result;
+    }
+}// namespace engine
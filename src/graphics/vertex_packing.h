@@ -0,0 +1,49 @@
+#ifndef VERTEX_PACKING_H
+#define VERTEX_PACKING_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "math/aabb.h"
+
+namespace engine {
+    // IEEE 754 binary16 conversion, rounding to the nearest representable value.
+    [[nodiscard]]
+    uint16_t float_to_half(float value);
+
+    [[nodiscard]]
+    float half_to_float(uint16_t half);
+
+    // Maps [-1, 1] to a signed normalized 16-bit integer, values outside of that range are clamped.
+    [[nodiscard]]
+    int16_t quantize_snorm16(float value);
+
+    // Same as the conversion done by the GPU for normalized Int16 vertex attributes.
+    [[nodiscard]]
+    float dequantize_snorm16(int16_t value);
+
+    // Positions of a primitive are stored normalized to its bounds, the original position is
+    // `normalized * scale_ + offset_`.
+    struct PositionQuantization final {
+        math::Vec3 offset_{};
+        math::Vec3 scale_{1.f, 1.f, 1.f};
+
+        [[nodiscard]]
+        static PositionQuantization from_bounds(math::Aabb const &bounds);
+
+        [[nodiscard]]
+        std::array<int16_t, 3> quantize(math::Vec3 const &position) const;
+
+        [[nodiscard]]
+        math::Vec3 dequantize(std::array<int16_t, 3> const &quantized) const;
+
+        // Folds the dequantization into a model matrix laid out like the matrices passed to bgfx, so that the
+        // quantized positions can be transformed by the result directly.
+        [[nodiscard]]
+        std::array<float, 4 * 4> apply(std::span<float const, 4 * 4> model
+        ) const;
+    };
+}// namespace engine
+
+#endif//VERTEX_PACKING_H
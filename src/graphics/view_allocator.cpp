@@ -0,0 +1,37 @@
+#include "view_allocator.h"
+
+#include <format>
+#include <stdexcept>
+
+namespace engine {
+    bgfx::ViewId ViewAllocator::begin_frame() {
+        count_ = 0;
+
+        auto const view_id = allocate("Clear");
+        bgfx::setViewClear(
+                view_id, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, clear_color_,
+                1.0f, 0
+        );
+
+        return view_id;
+    }
+
+    bgfx::ViewId ViewAllocator::allocate(std::string_view name) {
+        if (count_ >= bgfx::getCaps()->limits.maxViews) {
+            throw std::runtime_error{std::format(
+                    "Out of bgfx views, cannot allocate {}", name
+            )};
+        }
+
+        auto const view_id = static_cast<bgfx::ViewId>(count_++);
+        // Views keep their settings between frames, the ID may have belonged to another pass last frame.
+        bgfx::setViewName(
+                view_id, name.data(), static_cast<int32_t>(name.size())
+        );
+        bgfx::setViewRect(view_id, 0, 0, bgfx::BackbufferRatio::Equal);
+        bgfx::setViewClear(view_id, BGFX_CLEAR_NONE);
+        bgfx::setViewMode(view_id, bgfx::ViewMode::Default);
+
+        return view_id;
+    }
+}// namespace engine
@@ -0,0 +1,43 @@
+#ifndef VIEW_ALLOCATOR_H
+#define VIEW_ALLOCATOR_H
+
+#include <bgfx/bgfx.h>
+#include <cstdint>
+#include <string_view>
+
+#include "misc/singleton.h"
+
+namespace engine {
+    // Hands out bgfx views for the passes of a frame. bgfx executes views in the order of their IDs, so views are
+    // allocated anew every frame in the order they have to be drawn in.
+    // Every view covers the whole backbuffer. Only the first view of a frame clears it, the views after it draw on
+    // top of its color and depth.
+    class ViewAllocator final : public Singleton<ViewAllocator> {
+    public:
+        ViewAllocator() = default;
+
+        // Starts allocating from the first view again and returns it, set up to clear the backbuffer.
+        [[nodiscard]]
+        bgfx::ViewId begin_frame();
+
+        // Returns the next view, the name shows up in graphics debuggers and bgfx's profiler.
+        [[nodiscard]]
+        bgfx::ViewId allocate(std::string_view name);
+
+        void set_clear_color(uint32_t rgba) {
+            clear_color_ = rgba;
+        }
+
+        // Number of views allocated this frame.
+        [[nodiscard]]
+        uint16_t get_count() const {
+            return count_;
+        }
+
+    private:
+        uint16_t count_{};
+        uint32_t clear_color_{0x000000FF};
+    };
+}// namespace engine
+
+#endif//VIEW_ALLOCATOR_H
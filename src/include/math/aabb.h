@@ -0,0 +1,111 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include <cmath>
+#include <limits>
+#include <span>
+
+#include "vec.h"
+
+namespace engine::math {
+    // Axis-aligned bounding box.
+    struct Aabb final {
+        Vec3 min_{};
+        Vec3 max_{};
+
+        // A box that contains nothing, expanding it by a point results in a box around just that point.
+        [[nodiscard]]
+        static Aabb empty() {
+            constexpr float max = std::numeric_limits<float>::max();
+
+            return Aabb{Vec3{max, max, max}, Vec3{-max, -max, -max}};
+        }
+
+        [[nodiscard]]
+        Vec3 get_center() const {
+            return (min_ + max_) * 0.5f;
+        }
+
+        [[nodiscard]]
+        Vec3 get_extents() const {
+            return (max_ - min_) * 0.5f;
+        }
+
+        void expand(Vec3 const &point) {
+            min_ = Vec3{
+                    std::min(min_.get_x(), point.get_x()),
+                    std::min(min_.get_y(), point.get_y()),
+                    std::min(min_.get_z(), point.get_z())
+            };
+            max_ = Vec3{
+                    std::max(max_.get_x(), point.get_x()),
+                    std::max(max_.get_y(), point.get_y()),
+                    std::max(max_.get_z(), point.get_z())
+            };
+        }
+
+        [[nodiscard]]
+        Aabb merged(Aabb const &other) const {
+            Aabb result{*this};
+            result.expand(other.min_);
+            result.expand(other.max_);
+
+            return result;
+        }
+
+        [[nodiscard]]
+        Aabb fattened(float margin) const {
+            Vec3 const margin_vec{margin, margin, margin};
+
+            return Aabb{min_ - margin_vec, max_ + margin_vec};
+        }
+
+        [[nodiscard]]
+        bool contains(Aabb const &other) const {
+            return min_.get_x() <= other.min_.get_x() &&
+                   min_.get_y() <= other.min_.get_y() &&
+                   min_.get_z() <= other.min_.get_z() &&
+                   other.max_.get_x() <= max_.get_x() &&
+                   other.max_.get_y() <= max_.get_y() &&
+                   other.max_.get_z() <= max_.get_z();
+        }
+
+        [[nodiscard]]
+        bool overlaps(Aabb const &other) const {
+            return min_.get_x() <= other.max_.get_x() &&
+                   min_.get_y() <= other.max_.get_y() &&
+                   min_.get_z() <= other.max_.get_z() &&
+                   other.min_.get_x() <= max_.get_x() &&
+                   other.min_.get_y() <= max_.get_y() &&
+                   other.min_.get_z() <= max_.get_z();
+        }
+
+        [[nodiscard]]
+        float get_surface_area() const {
+            auto const size = max_ - min_;
+
+            return 2.f * (size.get_x() * size.get_y() +
+                          size.get_y() * size.get_z() +
+                          size.get_z() * size.get_x());
+        }
+
+        // Bounds of this box after transforming it by `mat`, laid out like the matrices passed to bgfx.
+        [[nodiscard]]
+        Aabb transformed(std::span<float const, 4 * 4> mat) const {
+            auto const extents = get_extents();
+            auto const center  = get_center().mul(mat);
+
+            Vec3 world_extents{};
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                world_extents[axis] =
+                        std::abs(mat[0 * 4 + axis]) * extents.get_x() +
+                        std::abs(mat[1 * 4 + axis]) * extents.get_y() +
+                        std::abs(mat[2 * 4 + axis]) * extents.get_z();
+            }
+
+            return Aabb{center - world_extents, center + world_extents};
+        }
+    };
+}// namespace engine::math
+
+#endif//AABB_H
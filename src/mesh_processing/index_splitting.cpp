@@ -0,0 +1,110 @@
+#include "index_splitting.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace engine::mesh_processing {
+    namespace {
+        constexpr uint32_t unmapped = std::numeric_limits<uint32_t>::max();
+    }
+
+    bool fits_16_bit(std::span<uint32_t const> indices) {
+        return std::ranges::all_of(indices, [](uint32_t index) {
+            return index <= max_16_bit_index;
+        });
+    }
+
+    std::vector<uint16_t> narrow_indices(std::span<uint32_t const> indices) {
+        assert(fits_16_bit(indices));
+
+        std::vector<uint16_t> narrowed(indices.size());
+        std::ranges::transform(indices, narrowed.begin(), [](uint32_t index) {
+            return static_cast<uint16_t>(index);
+        });
+
+        return narrowed;
+    }
+
+    std::vector<uint32_t> strip_to_list(std::span<uint32_t const> strip) {
+        std::vector<uint32_t> list;
+        if (strip.size() < 3)
+            return list;
+
+        list.reserve((strip.size() - 2) * 3);
+        for (std::size_t i = 2; i < strip.size(); ++i) {
+            uint32_t a = strip[i - 2];
+            uint32_t b = strip[i - 1];
+            uint32_t c = strip[i];
+
+            if (a == b || b == c || a == c)
+                continue;
+
+            // Every other triangle of a strip has its winding flipped.
+            if (i % 2 == 1)
+                std::swap(a, b);
+
+            list.insert(list.end(), {a, b, c});
+        }
+
+        return list;
+    }
+
+    std::vector<IndexedSubset> split_triangle_list(
+            std::span<uint32_t const> indices, std::size_t vertex_count,
+            std::size_t max_vertices
+    ) {
+        assert(indices.size() % 3 == 0);
+        assert(max_vertices >= 3);
+
+        std::vector<IndexedSubset> subsets;
+        // Index of each original vertex in the current subset.
+        std::vector<uint32_t> subset_index(vertex_count, unmapped);
+
+        auto const start_subset = [&] {
+            if (!subsets.empty()) {
+                for (uint32_t const vertex : subsets.back().vertex_remap_) {
+                    subset_index[vertex] = unmapped;
+                }
+            }
+            subsets.emplace_back();
+        };
+        start_subset();
+
+        for (std::size_t first = 0; first < indices.size(); first += 3) {
+            auto const triangle = indices.subspan(first, 3);
+
+            std::size_t new_vertices{};
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                uint32_t const vertex = triangle[corner];
+                bool const     repeated =
+                        std::find(
+                                triangle.begin(), triangle.begin() + corner,
+                                vertex
+                        ) != triangle.begin() + corner;
+
+                if (subset_index[vertex] == unmapped && !repeated)
+                    ++new_vertices;
+            }
+
+            if (subsets.back().vertex_remap_.size() + new_vertices >
+                max_vertices)
+                start_subset();
+
+            auto &subset = subsets.back();
+            for (uint32_t const vertex : triangle) {
+                if (subset_index[vertex] == unmapped) {
+                    subset_index[vertex] =
+                            static_cast<uint32_t>(subset.vertex_remap_.size());
+                    subset.vertex_remap_.push_back(vertex);
+                }
+                subset.indices_.push_back(subset_index[vertex]);
+            }
+        }
+
+        if (subsets.back().indices_.empty())
+            subsets.pop_back();
+
+        return subsets;
+    }
+}// namespace engine::mesh_processing
@@ -0,0 +1,43 @@
+#ifndef INDEX_SPLITTING_H
+#define INDEX_SPLITTING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace engine::mesh_processing {
+    // Largest index stored in 16-bit index buffers. 0xffff is left unused, as some APIs always treat it as a strip
+    // restart.
+    constexpr uint32_t max_16_bit_index = 0xfffe;
+
+    // Whether all indices can be stored in a 16-bit index buffer.
+    [[nodiscard]]
+    bool fits_16_bit(std::span<uint32_t const> indices);
+
+    // All indices must fit in 16 bits.
+    [[nodiscard]]
+    std::vector<uint16_t> narrow_indices(std::span<uint32_t const> indices);
+
+    // Converts a triangle strip to a list with the same winding, degenerate triangles are dropped.
+    [[nodiscard]]
+    std::vector<uint32_t> strip_to_list(std::span<uint32_t const> strip);
+
+    // Part of a triangle list that references a subset of its vertices.
+    struct IndexedSubset final {
+        // Original index of each vertex of the subset.
+        std::vector<uint32_t> vertex_remap_;
+        // Triangle list indexing into the vertices of the subset.
+        std::vector<uint32_t> indices_;
+    };
+
+    // Splits a triangle list into consecutive parts that reference at most `max_vertices` vertices each, so that the
+    // parts fit in 16-bit index buffers. Triangles keep their order.
+    [[nodiscard]]
+    std::vector<IndexedSubset> split_triangle_list(
+            std::span<uint32_t const> indices, std::size_t vertex_count,
+            std::size_t max_vertices = max_16_bit_index + 1
+    );
+}// namespace engine::mesh_processing
+
+#endif//INDEX_SPLITTING_H
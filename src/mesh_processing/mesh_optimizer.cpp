@@ -0,0 +1,443 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <unordered_map>
+
+namespace engine::mesh_processing {
+    namespace {
+        // Scoring parameters from Forsyth's "Linear-Speed Vertex Cache Optimisation".
+        constexpr std::size_t forsyth_cache_size  = 32;
+        constexpr float       last_triangle_score = 0.75f;
+        constexpr float       cache_decay_power   = 1.5f;
+        constexpr float       valence_boost_scale = 2.f;
+        constexpr float       valence_boost_power = 0.5f;
+        constexpr int32_t     not_in_cache        = -1;
+
+        constexpr std::size_t overdraw_cache_size   = 16;
+        constexpr uint32_t    no_triangle           = UINT32_MAX;
+        constexpr std::size_t vertices_per_triangle = 3;
+
+        [[nodiscard]]
+        float get_vertex_score(int32_t cache_position, uint32_t valence) {
+            if (valence == 0)
+                return -1.f;
+
+            float score{};
+            if (cache_position < 3 && cache_position != not_in_cache) {
+                // The vertices of the last triangle get a fixed score, so that the next triangle doesn't simply reuse
+                // its most recent edge, which would make long thin strips.
+                score = last_triangle_score;
+            } else if (cache_position != not_in_cache) {
+                float const scale = 1.f / (forsyth_cache_size - 3);
+                score             = std::pow(
+                        1.f - static_cast<float>(cache_position - 3) * scale,
+                        cache_decay_power
+                );
+            }
+
+            // Vertices with few triangles left are finished first, so that no lone triangles are left behind.
+            float const valence_boost = std::pow(
+                    static_cast<float>(valence), -valence_boost_power
+            );
+
+            return score + valence_boost_scale * valence_boost;
+        }
+
+        // Vertex bytes as a hash map key, the bytes are looked up in the vertex data.
+        struct VertexBytesHasher final {
+            std::span<std::byte const> vertex_data_;
+            std::size_t                vertex_stride_;
+
+            [[nodiscard]]
+            std::size_t operator()(uint32_t vertex) const {
+                // FNV-1a
+                uint64_t hash{0xcbf29ce484222325};
+                for (auto const byte : vertex_data_.subspan(
+                             vertex * vertex_stride_, vertex_stride_
+                     )) {
+                    hash ^= static_cast<uint64_t>(byte);
+                    hash *= 0x100000001b3;
+                }
+
+                return static_cast<std::size_t>(hash);
+            }
+        };
+
+        struct VertexBytesEqual final {
+            std::span<std::byte const> vertex_data_;
+            std::size_t                vertex_stride_;
+
+            [[nodiscard]]
+            bool operator()(uint32_t lhs, uint32_t rhs) const {
+                return std::memcmp(
+                               vertex_data_.data() + lhs * vertex_stride_,
+                               vertex_data_.data() + rhs * vertex_stride_,
+                               vertex_stride_
+                       ) == 0;
+            }
+        };
+
+        struct Cluster final {
+            std::size_t first_triangle_;
+            std::size_t triangle_count_;
+            float       sort_key_;
+        };
+    }// namespace
+
+    float VertexCacheStatistics::get_acmr() const {
+        return triangle_count_ == 0
+                     ? 0.f
+                     : static_cast<float>(vertices_transformed_) /
+                               static_cast<float>(triangle_count_);
+    }
+
+    float VertexCacheStatistics::get_atvr() const {
+        return vertex_count_ == 0 ? 0.f
+                                  : static_cast<float>(vertices_transformed_) /
+                                            static_cast<float>(vertex_count_);
+    }
+
+    VertexCacheStatistics &
+    VertexCacheStatistics::operator+=(VertexCacheStatistics const &other) {
+        vertices_transformed_ += other.vertices_transformed_;
+        triangle_count_ += other.triangle_count_;
+        vertex_count_ += other.vertex_count_;
+
+        return *this;
+    }
+
+    VertexCacheStatistics analyze_vertex_cache(
+            std::span<uint32_t const> indices, std::size_t vertex_count,
+            std::size_t cache_size
+    ) {
+        VertexCacheStatistics statistics;
+        statistics.triangle_count_ = indices.size() / vertices_per_triangle;
+        statistics.vertex_count_   = vertex_count;
+
+        // A vertex is in the FIFO cache if fewer than `cache_size` vertices were added after it.
+        std::vector<std::size_t> added_at(vertex_count, 0);
+        std::size_t              time = cache_size + 1;
+
+        for (uint32_t const vertex : indices) {
+            if (time - added_at[vertex] > cache_size) {
+                added_at[vertex] = time++;
+                ++statistics.vertices_transformed_;
+            }
+        }
+
+        return statistics;
+    }
+
+    VertexRemap weld_vertices(
+            std::span<std::byte const> vertex_data, std::size_t vertex_stride
+    ) {
+        assert(vertex_data.size() % vertex_stride == 0);
+        std::size_t const vertex_count = vertex_data.size() / vertex_stride;
+
+        std::unordered_map<
+                uint32_t, uint32_t, VertexBytesHasher, VertexBytesEqual>
+                unique_vertices{
+                        vertex_count,
+                        VertexBytesHasher{vertex_data, vertex_stride},
+                        VertexBytesEqual{vertex_data, vertex_stride}
+                };
+
+        VertexRemap remap;
+        remap.remap_.resize(vertex_count);
+        for (uint32_t vertex = 0; vertex < vertex_count; ++vertex) {
+            auto const [it, inserted] = unique_vertices.try_emplace(
+                    vertex, static_cast<uint32_t>(remap.vertex_count_)
+            );
+            if (inserted)
+                ++remap.vertex_count_;
+
+            remap.remap_[vertex] = it->second;
+        }
+
+        return remap;
+    }
+
+    VertexRemap remap_for_fetch(
+            std::span<uint32_t const> indices, std::size_t vertex_count
+    ) {
+        VertexRemap remap;
+        remap.remap_.assign(vertex_count, VertexRemap::removed_vertex);
+
+        for (uint32_t const vertex : indices) {
+            if (remap.remap_[vertex] == VertexRemap::removed_vertex) {
+                remap.remap_[vertex] =
+                        static_cast<uint32_t>(remap.vertex_count_++);
+            }
+        }
+
+        return remap;
+    }
+
+    void remap_indices(std::span<uint32_t> indices, VertexRemap const &remap) {
+        for (auto &index : indices) {
+            assert(remap.remap_[index] != VertexRemap::removed_vertex);
+            index = remap.remap_[index];
+        }
+    }
+
+    std::vector<uint32_t> optimize_vertex_cache(
+            std::span<uint32_t const> indices, std::size_t vertex_count
+    ) {
+        assert(indices.size() % vertices_per_triangle == 0);
+        std::size_t const triangle_count =
+                indices.size() / vertices_per_triangle;
+
+        // Triangles using each vertex, vertex i owns the slice starting at triangle_offsets[i]. The first `valence`
+        // triangles of a slice are the ones that weren't added yet.
+        std::vector<uint32_t> valence(vertex_count, 0);
+        for (uint32_t const vertex : indices) {
+            ++valence[vertex];
+        }
+
+        std::vector<uint32_t> triangle_offsets(vertex_count + 1, 0);
+        for (std::size_t vertex = 0; vertex < vertex_count; ++vertex) {
+            triangle_offsets[vertex + 1] =
+                    triangle_offsets[vertex] + valence[vertex];
+        }
+
+        std::vector<uint32_t> vertex_triangles(indices.size());
+        {
+            std::vector<uint32_t> filled(vertex_count, 0);
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                uint32_t const vertex = indices[i];
+                vertex_triangles[triangle_offsets[vertex] + filled[vertex]++] =
+                        static_cast<uint32_t>(i / vertices_per_triangle);
+            }
+        }
+
+        std::vector<int32_t> cache_position(vertex_count, not_in_cache);
+        std::vector<float>   vertex_score(vertex_count);
+        for (std::size_t vertex = 0; vertex < vertex_count; ++vertex) {
+            vertex_score[vertex] =
+                    get_vertex_score(not_in_cache, valence[vertex]);
+        }
+
+        std::vector<bool> triangle_added(triangle_count, false);
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> next_cache;
+        cache.reserve(forsyth_cache_size + 3);
+        next_cache.reserve(forsyth_cache_size + 3);
+
+        uint32_t    best_triangle = no_triangle;
+        std::size_t input_cursor{};
+
+        for (std::size_t added = 0; added < triangle_count; ++added) {
+            // Dead end, none of the cached vertices has triangles left. Continue with the next triangle in input order.
+            if (best_triangle == no_triangle) {
+                while (triangle_added[input_cursor]) {
+                    ++input_cursor;
+                }
+                best_triangle = static_cast<uint32_t>(input_cursor);
+            }
+
+            auto const corners =
+                    indices.subspan(best_triangle * vertices_per_triangle, 3);
+            result.insert(result.end(), corners.begin(), corners.end());
+            triangle_added[best_triangle] = true;
+
+            for (uint32_t const vertex : corners) {
+                auto const first = vertex_triangles.begin() +
+                                   triangle_offsets[vertex];
+                auto const last = first + valence[vertex];
+                auto const it   = std::find(first, last, best_triangle);
+                assert(it != last);
+
+                std::iter_swap(it, last - 1);
+                --valence[vertex];
+            }
+
+            next_cache.clear();
+            for (uint32_t const vertex : corners) {
+                if (std::ranges::find(next_cache, vertex) == next_cache.end())
+                    next_cache.push_back(vertex);
+            }
+            for (uint32_t const vertex : cache) {
+                if (std::ranges::find(corners, vertex) == corners.end())
+                    next_cache.push_back(vertex);
+            }
+
+            for (std::size_t i = forsyth_cache_size; i < next_cache.size();
+                 ++i) {
+                uint32_t const vertex  = next_cache[i];
+                cache_position[vertex] = not_in_cache;
+                vertex_score[vertex] =
+                        get_vertex_score(not_in_cache, valence[vertex]);
+            }
+            next_cache.resize(std::min(next_cache.size(), forsyth_cache_size));
+            std::swap(cache, next_cache);
+
+            for (std::size_t i = 0; i < cache.size(); ++i) {
+                uint32_t const vertex  = cache[i];
+                cache_position[vertex] = static_cast<int32_t>(i);
+                vertex_score[vertex]   = get_vertex_score(
+                        cache_position[vertex], valence[vertex]
+                );
+            }
+
+            // Only triangles of cached vertices changed their score, the best one of those is added next.
+            best_triangle    = no_triangle;
+            float best_score = -1.f;
+            for (uint32_t const vertex : cache) {
+                auto const first = vertex_triangles.begin() +
+                                   triangle_offsets[vertex];
+                for (auto it = first; it != first + valence[vertex]; ++it) {
+                    uint32_t const triangle = *it;
+                    auto const     triangle_corners = indices.subspan(
+                            triangle * vertices_per_triangle, 3
+                    );
+
+                    float const score = vertex_score[triangle_corners[0]] +
+                                        vertex_score[triangle_corners[1]] +
+                                        vertex_score[triangle_corners[2]];
+                    if (score > best_score) {
+                        best_score    = score;
+                        best_triangle = triangle;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<uint32_t> optimize_overdraw(
+            std::span<uint32_t const>   indices,
+            std::span<math::Vec3 const> positions
+    ) {
+        assert(indices.size() % vertices_per_triangle == 0);
+        std::size_t const triangle_count =
+                indices.size() / vertices_per_triangle;
+        if (triangle_count == 0)
+            return {};
+
+        // Clusters start at triangles that miss the cache for all of their vertices.
+        std::vector<Cluster> clusters;
+        {
+            std::vector<std::size_t> added_at(positions.size(), 0);
+            std::size_t              time = overdraw_cache_size + 1;
+
+            for (std::size_t triangle = 0; triangle < triangle_count;
+                 ++triangle) {
+                std::size_t misses{};
+                for (std::size_t corner = 0; corner < 3; ++corner) {
+                    uint32_t const vertex =
+                            indices[triangle * vertices_per_triangle + corner];
+                    if (time - added_at[vertex] > overdraw_cache_size) {
+                        added_at[vertex] = time++;
+                        ++misses;
+                    }
+                }
+
+                if (triangle == 0 || misses == 3)
+                    clusters.push_back({triangle, 0, 0.f});
+                ++clusters.back().triangle_count_;
+            }
+        }
+
+        std::vector<math::Vec3> cluster_centers(clusters.size());
+        std::vector<math::Vec3> cluster_normals(clusters.size());
+        math::Vec3              mesh_center{};
+        float                   mesh_area{};
+
+        for (std::size_t cluster_idx = 0; cluster_idx < clusters.size();
+             ++cluster_idx) {
+            auto const &cluster = clusters[cluster_idx];
+
+            math::Vec3 center{};
+            math::Vec3 normal{};
+            float      area{};
+            for (std::size_t triangle = cluster.first_triangle_;
+                 triangle < cluster.first_triangle_ + cluster.triangle_count_;
+                 ++triangle) {
+                auto const corners =
+                        indices.subspan(triangle * vertices_per_triangle, 3);
+                auto const &a = positions[corners[0]];
+                auto const &b = positions[corners[1]];
+                auto const &c = positions[corners[2]];
+
+                // Its length is twice the area of the triangle.
+                auto const  triangle_normal = (b - a).cross(c - a);
+                float const triangle_area   = triangle_normal.get_magnitude();
+
+                center += (a + b + c) * (triangle_area / 3.f);
+                normal += triangle_normal;
+                area += triangle_area;
+            }
+
+            mesh_center += center;
+            mesh_area += area;
+
+            cluster_centers[cluster_idx] =
+                    area > 0.f ? center / area
+                               : positions[indices[cluster.first_triangle_ *
+                                                   vertices_per_triangle]];
+
+            float const normal_length = normal.get_magnitude();
+            cluster_normals[cluster_idx] =
+                    normal_length > 0.f ? normal / normal_length : normal;
+        }
+
+        if (mesh_area > 0.f)
+            mesh_center /= mesh_area;
+
+        // Clusters that face away from the center of the mesh are the most likely to cover other parts of it.
+        for (std::size_t cluster_idx = 0; cluster_idx < clusters.size();
+             ++cluster_idx) {
+            clusters[cluster_idx].sort_key_ = cluster_normals[cluster_idx].dot(
+                    cluster_centers[cluster_idx] - mesh_center
+            );
+        }
+
+        std::ranges::stable_sort(
+                clusters, std::ranges::greater{}, &Cluster::sort_key_
+        );
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (auto const &cluster : clusters) {
+            auto const cluster_indices = indices.subspan(
+                    cluster.first_triangle_ * vertices_per_triangle,
+                    cluster.triangle_count_ * vertices_per_triangle
+            );
+            result.insert(
+                    result.end(), cluster_indices.begin(),
+                    cluster_indices.end()
+            );
+        }
+
+        return result;
+    }
+
+    MeshOptimizationReport &
+    MeshOptimizationReport::operator+=(MeshOptimizationReport const &other) {
+        vertex_count_before_ += other.vertex_count_before_;
+        vertex_count_after_ += other.vertex_count_after_;
+        cache_before_ += other.cache_before_;
+        cache_after_ += other.cache_after_;
+
+        return *this;
+    }
+
+    std::ostream &
+    operator<<(std::ostream &stream, MeshOptimizationReport const &report) {
+        return stream << "vertices " << report.vertex_count_before_ << " -> "
+                      << report.vertex_count_after_ << ", ACMR "
+                      << report.cache_before_.get_acmr() << " -> "
+                      << report.cache_after_.get_acmr() << ", ATVR "
+                      << report.cache_before_.get_atvr() << " -> "
+                      << report.cache_after_.get_atvr();
+    }
+}// namespace engine::mesh_processing
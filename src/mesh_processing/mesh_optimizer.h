@@ -0,0 +1,142 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+#include "math/vec.h"
+
+namespace engine::mesh_processing {
+    // Result of simulating a GPU's post-transform vertex cache over a triangle list.
+    struct VertexCacheStatistics final {
+        std::size_t vertices_transformed_{};
+        std::size_t triangle_count_{};
+        std::size_t vertex_count_{};
+
+        // Average cache miss ratio, vertices transformed per triangle. 0.5 is about the best possible, 3 the worst.
+        [[nodiscard]]
+        float get_acmr() const;
+
+        // Average transformed vertex ratio, vertices transformed per vertex. 1 is the best possible.
+        [[nodiscard]]
+        float get_atvr() const;
+
+        VertexCacheStatistics &operator+=(VertexCacheStatistics const &other);
+    };
+
+    // Simulates a FIFO cache of `cache_size` vertices, which is how most GPUs behave.
+    [[nodiscard]]
+    VertexCacheStatistics analyze_vertex_cache(
+            std::span<uint32_t const> indices, std::size_t vertex_count,
+            std::size_t cache_size = 16
+    );
+
+    // Maps every old vertex index to its new index. Vertices that were removed map to `removed_vertex`.
+    struct VertexRemap final {
+        static constexpr uint32_t removed_vertex = UINT32_MAX;
+
+        std::vector<uint32_t> remap_;
+        std::size_t           vertex_count_{};
+    };
+
+    // Merges vertices whose bytes are identical.
+    [[nodiscard]]
+    VertexRemap weld_vertices(
+            std::span<std::byte const> vertex_data, std::size_t vertex_stride
+    );
+
+    // Orders vertices by their first use in the index buffer, so that vertex fetches are as sequential as possible.
+    // Vertices that aren't referenced are removed.
+    [[nodiscard]]
+    VertexRemap remap_for_fetch(
+            std::span<uint32_t const> indices, std::size_t vertex_count
+    );
+
+    void remap_indices(std::span<uint32_t> indices, VertexRemap const &remap);
+
+    template<typename Vertex>
+    [[nodiscard]]
+    std::vector<Vertex> remap_vertices(
+            std::span<Vertex const> vertices, VertexRemap const &remap
+    ) {
+        std::vector<Vertex> remapped(remap.vertex_count_);
+        for (std::size_t i = 0; i < vertices.size(); ++i) {
+            if (remap.remap_[i] != VertexRemap::removed_vertex)
+                remapped[remap.remap_[i]] = vertices[i];
+        }
+
+        return remapped;
+    }
+
+    // Reorders the triangles of a triangle list for the post-transform vertex cache, using Tom Forsyth's linear-speed
+    // vertex cache optimization.
+    [[nodiscard]]
+    std::vector<uint32_t> optimize_vertex_cache(
+            std::span<uint32_t const> indices, std::size_t vertex_count
+    );
+
+    // Reorders clusters of a cache optimized triangle list so that outward facing clusters are drawn first, which
+    // makes them occlude more of the mesh itself. Clusters are split where the cache would be cold anyway, so the
+    // vertex cache efficiency is mostly kept.
+    [[nodiscard]]
+    std::vector<uint32_t> optimize_overdraw(
+            std::span<uint32_t const>   indices,
+            std::span<math::Vec3 const> positions
+    );
+
+    struct MeshOptimizationReport final {
+        std::size_t           vertex_count_before_{};
+        std::size_t           vertex_count_after_{};
+        VertexCacheStatistics cache_before_{};
+        VertexCacheStatistics cache_after_{};
+
+        MeshOptimizationReport &operator+=(MeshOptimizationReport const &other);
+    };
+
+    std::ostream &
+    operator<<(std::ostream &stream, MeshOptimizationReport const &report);
+
+    // Runs all optimizations on a triangle list: welds duplicate vertices, optimizes for the vertex cache and then
+    // for overdraw, and finally reorders the vertices for fetching. `get_position` returns the position of a vertex as
+    // a math::Vec3.
+    template<typename Vertex, typename GetPosition>
+    MeshOptimizationReport optimize_mesh(
+            std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+            GetPosition &&get_position
+    ) {
+        MeshOptimizationReport report;
+        report.vertex_count_before_ = vertices.size();
+        report.cache_before_ = analyze_vertex_cache(indices, vertices.size());
+
+        auto const weld_remap = weld_vertices(
+                std::as_bytes(std::span{vertices}), sizeof(Vertex)
+        );
+        remap_indices(indices, weld_remap);
+        vertices =
+                remap_vertices(std::span<Vertex const>{vertices}, weld_remap);
+
+        indices = optimize_vertex_cache(indices, vertices.size());
+
+        std::vector<math::Vec3> positions;
+        positions.reserve(vertices.size());
+        for (auto const &vertex : vertices) {
+            positions.push_back(get_position(vertex));
+        }
+        indices = optimize_overdraw(indices, positions);
+
+        auto const fetch_remap = remap_for_fetch(indices, vertices.size());
+        remap_indices(indices, fetch_remap);
+        vertices =
+                remap_vertices(std::span<Vertex const>{vertices}, fetch_remap);
+
+        report.vertex_count_after_ = vertices.size();
+        report.cache_after_ = analyze_vertex_cache(indices, vertices.size());
+
+        return report;
+    }
+}// namespace engine::mesh_processing
+
+#endif//MESH_OPTIMIZER_H
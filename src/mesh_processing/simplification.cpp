@@ -0,0 +1,375 @@
+#include "simplification.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <unordered_set>
+
+namespace engine::mesh_processing {
+    namespace {
+        constexpr std::size_t vertices_per_triangle = 3;
+        // Levels of detail that keep more than this fraction of the previous level aren't worth drawing.
+        constexpr float min_lod_reduction = 0.9f;
+
+        // Sum of squared distances to a set of planes, weighted by the area of the triangles they came from.
+        struct Quadric final {
+            double a2_{}, b2_{}, c2_{}, ab_{}, ac_{}, bc_{};
+            double ad_{}, bd_{}, cd_{}, d2_{};
+            double weight_{};
+
+            [[nodiscard]]
+            static Quadric from_triangle(
+                    math::Vec3 const &a, math::Vec3 const &b,
+                    math::Vec3 const &c
+            ) {
+                auto const  normal = (b - a).cross(c - a);
+                float const length = normal.get_magnitude();
+                if (length == 0.f)
+                    return {};
+
+                double const area = length / 2.;
+                double const x    = normal.get_x() / length;
+                double const y    = normal.get_y() / length;
+                double const z    = normal.get_z() / length;
+                double const d    = -(x * a.get_x() + y * a.get_y() +
+                                   z * a.get_z());
+
+                return Quadric{
+                        x * x * area, y * y * area, z * z * area,
+                        x * y * area, x * z * area, y * z * area,
+                        x * d * area, y * d * area, z * d * area,
+                        d * d * area, area
+                };
+            }
+
+            Quadric &operator+=(Quadric const &other) {
+                a2_ += other.a2_;
+                b2_ += other.b2_;
+                c2_ += other.c2_;
+                ab_ += other.ab_;
+                ac_ += other.ac_;
+                bc_ += other.bc_;
+                ad_ += other.ad_;
+                bd_ += other.bd_;
+                cd_ += other.cd_;
+                d2_ += other.d2_;
+                weight_ += other.weight_;
+
+                return *this;
+            }
+
+            [[nodiscard]]
+            double evaluate(math::Vec3 const &point) const {
+                double const x = point.get_x();
+                double const y = point.get_y();
+                double const z = point.get_z();
+
+                double const error =
+                        a2_ * x * x + b2_ * y * y + c2_ * z * z +
+                        2. * (ab_ * x * y + ac_ * x * z + bc_ * y * z) +
+                        2. * (ad_ * x + bd_ * y + cd_ * z) + d2_;
+
+                // Rounding can make it slightly negative.
+                return std::max(error, 0.);
+            }
+        };
+
+        struct Collapse final {
+            uint32_t from_;
+            uint32_t to_;
+            // Mean squared distance of the merged vertex to the planes of both.
+            double   cost_;
+        };
+
+        // Triangles using each vertex, the triangles of vertex i are [offsets[i], offsets[i + 1]).
+        struct VertexTriangles final {
+            std::vector<uint32_t> offsets_;
+            std::vector<uint32_t> triangles_;
+
+            void build(std::span<uint32_t const> indices, std::size_t count) {
+                offsets_.assign(count + 1, 0);
+                for (uint32_t const vertex : indices) {
+                    ++offsets_[vertex + 1];
+                }
+                std::partial_sum(
+                        offsets_.begin(), offsets_.end(), offsets_.begin()
+                );
+
+                triangles_.resize(indices.size());
+                std::vector<uint32_t> filled(offsets_.begin(), offsets_.end());
+                for (std::size_t i = 0; i < indices.size(); ++i) {
+                    triangles_[filled[indices[i]]++] =
+                            static_cast<uint32_t>(i / vertices_per_triangle);
+                }
+            }
+
+            [[nodiscard]]
+            std::span<uint32_t const> get(uint32_t vertex) const {
+                uint32_t const first = offsets_[vertex];
+
+                return std::span{triangles_}.subspan(
+                        first, offsets_[vertex + 1] - first
+                );
+            }
+        };
+
+        // Vertices on edges that only one triangle uses in that direction.
+        [[nodiscard]]
+        std::vector<bool> find_open_edge_vertices(
+                std::span<uint32_t const> indices, std::size_t vertex_count
+        ) {
+            auto const edge_key = [](uint32_t from, uint32_t to) {
+                return (static_cast<uint64_t>(from) << 32) | to;
+            };
+
+            std::unordered_set<uint64_t> edges;
+            edges.reserve(indices.size());
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                std::size_t const next =
+                        i % vertices_per_triangle == 2 ? i - 2 : i + 1;
+                edges.insert(edge_key(indices[i], indices[next]));
+            }
+
+            std::vector<bool> open(vertex_count, false);
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                std::size_t const next =
+                        i % vertices_per_triangle == 2 ? i - 2 : i + 1;
+                if (!edges.contains(edge_key(indices[next], indices[i]))) {
+                    open[indices[i]]    = true;
+                    open[indices[next]] = true;
+                }
+            }
+
+            return open;
+        }
+
+        // Whether moving `from` onto `to` turns any of the remaining triangles of `from` around.
+        [[nodiscard]]
+        bool flips_triangles(
+                Collapse const &collapse, std::span<uint32_t const> indices,
+                std::span<math::Vec3 const> positions,
+                VertexTriangles const      &vertex_triangles
+        ) {
+            for (uint32_t const triangle :
+                 vertex_triangles.get(collapse.from_)) {
+                auto const corners =
+                        indices.subspan(triangle * vertices_per_triangle, 3);
+                if (std::ranges::find(corners, collapse.to_) != corners.end())
+                    continue;
+
+                std::array<math::Vec3, 3> before;
+                std::array<math::Vec3, 3> after;
+                for (std::size_t i = 0; i < 3; ++i) {
+                    before[i] = positions[corners[i]];
+                    after[i]  = corners[i] == collapse.from_
+                                      ? positions[collapse.to_]
+                                      : before[i];
+                }
+
+                auto const normal_before =
+                        (before[1] - before[0]).cross(before[2] - before[0]);
+                auto const normal_after =
+                        (after[1] - after[0]).cross(after[2] - after[0]);
+                if (normal_before.dot(normal_after) <= 0.f)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Collapses edges in passes, every pass collapses the cheapest edges whose neighbourhoods don't overlap and
+        // then drops the triangles that became degenerate. Simplification can be continued to a lower target, which
+        // keeps the quadrics, so that the error stays relative to the original triangles.
+        class Simplifier final {
+        public:
+            Simplifier(
+                    std::span<uint32_t const>   indices,
+                    std::span<math::Vec3 const> positions
+            )
+                : positions_{positions}
+                , indices_{indices.begin(), indices.end()}
+                , locked_{find_open_edge_vertices(indices, positions.size())}
+                , quadrics_(positions.size())
+                , remap_(positions.size())
+                , touched_(positions.size()) {
+                assert(indices.size() % vertices_per_triangle == 0);
+
+                for (std::size_t i = 0; i < indices.size();
+                     i += vertices_per_triangle) {
+                    auto const quadric = Quadric::from_triangle(
+                            positions[indices[i]], positions[indices[i + 1]],
+                            positions[indices[i + 2]]
+                    );
+                    for (std::size_t corner = 0; corner < 3; ++corner) {
+                        quadrics_[indices[i + corner]] += quadric;
+                    }
+                }
+            }
+
+            void simplify(std::size_t target_index_count, float max_error) {
+                double const max_cost = static_cast<double>(max_error) *
+                                        static_cast<double>(max_error);
+
+                while (indices_.size() > target_index_count) {
+                    if (run_pass(target_index_count, max_cost) == 0)
+                        break;
+                }
+            }
+
+            [[nodiscard]]
+            std::vector<uint32_t> const &get_indices() const {
+                return indices_;
+            }
+
+            [[nodiscard]]
+            float get_error() const {
+                return static_cast<float>(std::sqrt(collapsed_cost_));
+            }
+
+        private:
+            std::span<math::Vec3 const> positions_;
+            std::vector<uint32_t>       indices_;
+            std::vector<bool>           locked_;
+            std::vector<Quadric>        quadrics_;
+            VertexTriangles             vertex_triangles_;
+            std::vector<Collapse>       collapses_;
+            std::vector<uint32_t>       remap_;
+            std::vector<bool>           touched_;
+            double                      collapsed_cost_{};
+
+            [[nodiscard]]
+            double get_cost(uint32_t from, uint32_t to) const {
+                Quadric merged = quadrics_[from];
+                merged += quadrics_[to];
+
+                return merged.weight_ > 0.
+                             ? merged.evaluate(positions_[to]) / merged.weight_
+                             : 0.;
+            }
+
+            // Returns the number of triangles removed.
+            std::size_t
+            run_pass(std::size_t target_index_count, double max_cost) {
+                std::size_t const vertex_count = positions_.size();
+                vertex_triangles_.build(indices_, vertex_count);
+
+                // Edges with an unlocked vertex are shared by two triangles, one of them adds the candidates.
+                collapses_.clear();
+                for (std::size_t i = 0; i < indices_.size(); ++i) {
+                    std::size_t const next =
+                            i % vertices_per_triangle == 2 ? i - 2 : i + 1;
+                    uint32_t const a = indices_[i];
+                    uint32_t const b = indices_[next];
+                    if (a > b)
+                        continue;
+
+                    if (!locked_[a])
+                        collapses_.push_back({a, b, get_cost(a, b)});
+                    if (!locked_[b])
+                        collapses_.push_back({b, a, get_cost(b, a)});
+                }
+                std::ranges::sort(collapses_, {}, &Collapse::cost_);
+
+                std::iota(remap_.begin(), remap_.end(), uint32_t{0});
+                touched_.assign(vertex_count, false);
+
+                std::size_t const triangle_goal =
+                        (indices_.size() - target_index_count) /
+                        vertices_per_triangle;
+                std::size_t removed_triangles{};
+
+                for (auto const &collapse : collapses_) {
+                    if (removed_triangles >= triangle_goal ||
+                        collapse.cost_ > max_cost)
+                        break;
+
+                    if (touched_[collapse.from_] || touched_[collapse.to_] ||
+                        flips_triangles(
+                                collapse, indices_, positions_,
+                                vertex_triangles_
+                        ))
+                        continue;
+
+                    remap_[collapse.from_] = collapse.to_;
+                    quadrics_[collapse.to_] += quadrics_[collapse.from_];
+                    collapsed_cost_ = std::max(collapsed_cost_, collapse.cost_);
+
+                    // The triangles around the removed vertex change, so nothing else touches them in this pass.
+                    for (uint32_t const triangle :
+                         vertex_triangles_.get(collapse.from_)) {
+                        auto const corners = std::span{indices_}.subspan(
+                                triangle * vertices_per_triangle, 3
+                        );
+                        for (uint32_t const vertex : corners) {
+                            touched_[vertex] = true;
+                        }
+                        if (std::ranges::find(corners, collapse.to_) !=
+                            corners.end())
+                            ++removed_triangles;
+                    }
+                }
+
+                std::size_t kept{};
+                for (std::size_t i = 0; i < indices_.size();
+                     i += vertices_per_triangle) {
+                    uint32_t const a = remap_[indices_[i]];
+                    uint32_t const b = remap_[indices_[i + 1]];
+                    uint32_t const c = remap_[indices_[i + 2]];
+                    if (a == b || b == c || a == c)
+                        continue;
+
+                    indices_[kept++] = a;
+                    indices_[kept++] = b;
+                    indices_[kept++] = c;
+                }
+                indices_.resize(kept);
+
+                return removed_triangles;
+            }
+        };
+    }// namespace
+
+    SimplifiedIndices simplify(
+            std::span<uint32_t const>   indices,
+            std::span<math::Vec3 const> positions,
+            std::size_t target_index_count, float max_error
+    ) {
+        Simplifier simplifier{indices, positions};
+        simplifier.simplify(target_index_count, max_error);
+
+        return {simplifier.get_indices(), simplifier.get_error()};
+    }
+
+    std::vector<SimplifiedIndices> generate_lods(
+            std::span<uint32_t const>   indices,
+            std::span<math::Vec3 const> positions, std::size_t max_lod_count
+    ) {
+        std::vector<SimplifiedIndices> lods;
+        Simplifier                     simplifier{indices, positions};
+
+        std::size_t previous_size = indices.size();
+        for (std::size_t level = 0; level < max_lod_count; ++level) {
+            std::size_t const target_size = previous_size /
+                                            (2 * vertices_per_triangle) *
+                                            vertices_per_triangle;
+            if (target_size == 0)
+                break;
+
+            simplifier.simplify(
+                    target_size, std::numeric_limits<float>::max()
+            );
+
+            std::size_t const size = simplifier.get_indices().size();
+            if (static_cast<float>(size) >
+                static_cast<float>(previous_size) * min_lod_reduction)
+                break;
+
+            lods.push_back({simplifier.get_indices(), simplifier.get_error()});
+            previous_size = size;
+        }
+
+        return lods;
+    }
+}// namespace engine::mesh_processing
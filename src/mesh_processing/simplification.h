@@ -0,0 +1,41 @@
+#ifndef SIMPLIFICATION_H
+#define SIMPLIFICATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "math/vec.h"
+
+namespace engine::mesh_processing {
+    struct SimplifiedIndices final {
+        std::vector<uint32_t> indices_;
+        // Estimated distance between the simplified and the original surface, in the units of the positions.
+        float                 error_{};
+    };
+
+    // Simplifies a triangle list by collapsing edges in the order of their quadric error, until at most
+    // `target_index_count` indices are left or no edge can be collapsed without exceeding `max_error`.
+    // Vertices are only removed, never moved, so the result indexes into the same vertices. Vertices on open edges
+    // are never removed, which keeps the borders of the mesh and seams between vertices with different attributes.
+    [[nodiscard]]
+    SimplifiedIndices simplify(
+            std::span<uint32_t const>   indices,
+            std::span<math::Vec3 const> positions,
+            std::size_t                 target_index_count,
+            float max_error = std::numeric_limits<float>::max()
+    );
+
+    // Builds up to `max_lod_count` successively coarser levels of detail, each with about half the triangles of
+    // the previous one. Levels stop once simplification barely removes triangles anymore. The error of each level is
+    // relative to the original triangles.
+    [[nodiscard]]
+    std::vector<SimplifiedIndices> generate_lods(
+            std::span<uint32_t const>   indices,
+            std::span<math::Vec3 const> positions, std::size_t max_lod_count
+    );
+}// namespace engine::mesh_processing
+
+#endif//SIMPLIFICATION_H
@@ -0,0 +1,90 @@
+#include "mesh_store.h"
+
+#include <utility>
+
+namespace engine {
+    void MeshStore::acquire(std::size_t index) {
+        ++entries_[index].ref_count_;
+    }
+
+    void MeshStore::release(std::size_t index) {
+        // Handles may outlive a cleared store during shutdown.
+        if (index >= entries_.size())
+            return;
+
+        auto &entry = entries_[index];
+        if (--entry.ref_count_ != 0)
+            return;
+
+        entry.mesh_.reset();
+        free_indices_.push_back(index);
+    }
+
+    MeshHandle MeshStore::add_mesh(Mesh &&mesh) {
+        std::size_t index;
+        if (free_indices_.empty()) {
+            index = entries_.size();
+            entries_.emplace_back();
+        } else {
+            index = free_indices_.back();
+            free_indices_.pop_back();
+        }
+
+        entries_[index].mesh_.emplace(std::move(mesh));
+
+        return MeshHandle{index};
+    }
+
+    MeshHandle::MeshHandle(std::size_t index)
+        : index_{index} {
+        MeshStore::get_instance().acquire(index);
+    }
+
+    MeshHandle::MeshHandle(MeshHandle const &other)
+        : index_{other.index_} {
+        if (index_)
+            MeshStore::get_instance().acquire(*index_);
+    }
+
+    MeshHandle::MeshHandle(MeshHandle &&other) noexcept
+        : index_{std::exchange(other.index_, std::nullopt)} {
+    }
+
+    MeshHandle &MeshHandle::operator=(MeshHandle const &other) {
+        if (this == &other)
+            return *this;
+
+        *this = MeshHandle{other};
+
+        return *this;
+    }
+
+    MeshHandle &MeshHandle::operator=(MeshHandle &&other) noexcept {
+        if (this == &other)
+            return *this;
+
+        if (index_)
+            MeshStore::get_instance().release(*index_);
+
+        index_ = std::exchange(other.index_, std::nullopt);
+
+        return *this;
+    }
+
+    MeshHandle::~MeshHandle() {
+        if (index_)
+            MeshStore::get_instance().release(*index_);
+    }
+
+    Mesh const &MeshHandle::operator*() const {
+        return *MeshStore::get_instance().entries_[*index_].mesh_;
+    }
+
+    Mesh const *MeshHandle::operator->() const {
+        return &**this;
+    }
+
+    MeshHandle::operator bool() const {
+        return index_.has_value();
+    }
+}// namespace engine
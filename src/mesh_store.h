@@ -0,0 +1,77 @@
+#ifndef MESH_STORE_H
+#define MESH_STORE_H
+
+#include <optional>
+#include <vector>
+
+#include "graphics/mesh.h"
+#include "misc/singleton.h"
+
+namespace engine {
+    class MeshHandle;
+
+    class MeshStore final : public Singleton<MeshStore> {
+        struct Entry final {
+            std::optional<Mesh> mesh_{};
+            std::size_t         ref_count_{};
+        };
+
+        std::vector<Entry>       entries_;
+        std::vector<std::size_t> free_indices_;
+
+        friend class MeshHandle;
+
+        void acquire(std::size_t index);
+
+        void release(std::size_t index);
+
+    public:
+        MeshStore() = default;
+
+        [[nodiscard]]
+        MeshHandle add_mesh(Mesh &&mesh);
+
+        [[nodiscard]]
+        std::size_t get_mesh_count() const {
+            return entries_.size() - free_indices_.size();
+        }
+
+        void clear() {
+            entries_.clear();
+            free_indices_.clear();
+        }
+    };
+
+    // Shared, reference-counted reference to a mesh in the MeshStore.
+    // The mesh is destroyed once the last handle referring to it is.
+    class MeshHandle final {
+        std::optional<std::size_t> index_{};
+
+        friend class MeshStore;
+
+        explicit MeshHandle(std::size_t index);
+
+    public:
+        MeshHandle() = default;
+
+        MeshHandle(MeshHandle const &other);
+
+        MeshHandle(MeshHandle &&other) noexcept;
+
+        MeshHandle &operator=(MeshHandle const &other);
+
+        MeshHandle &operator=(MeshHandle &&other) noexcept;
+
+        ~MeshHandle();
+
+        [[nodiscard]]
+        Mesh const &operator*() const;
+
+        Mesh const *operator->() const;
+
+        [[nodiscard]]
+        explicit operator bool() const;
+    };
+}// namespace engine
+
+#endif//MESH_STORE_H
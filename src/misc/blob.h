@@ -0,0 +1,167 @@
+#ifndef BLOB_H
+#define BLOB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "shared_bytes.h"
+
+namespace engine {
+    // Blobs nested in other blobs start at this alignment, so that their arrays stay aligned wherever they're copied.
+    constexpr std::size_t blob_alignment = alignof(std::max_align_t);
+
+    // Appends trivially copyable values and arrays of them to a byte buffer, in their native layout. Arrays are
+    // aligned for their elements relative to the start of the buffer, so that BlobReader can view them in place when
+    // the buffer itself is suitably aligned, as file mappings and heap allocations are.
+    class BlobWriter final {
+        std::vector<uint8_t> bytes_;
+
+        void align(std::size_t alignment) {
+            bytes_.resize(
+                    (bytes_.size() + alignment - 1) / alignment * alignment
+            );
+        }
+
+    public:
+        void write_bytes(std::span<std::byte const> bytes) {
+            auto const *bytes_ptr =
+                    reinterpret_cast<uint8_t const *>(bytes.data());
+            bytes_.insert(bytes_.end(), bytes_ptr, bytes_ptr + bytes.size());
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void write(T const &value) {
+            write_bytes(std::as_bytes(std::span{&value, 1}));
+        }
+
+        // Writes the number of values followed by the values.
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void write_span(std::span<T const> values) {
+            write(static_cast<uint64_t>(values.size()));
+            align(alignof(T));
+            write_bytes(std::as_bytes(values));
+        }
+
+        void write_string(std::string_view text) {
+            write_span(std::span{text.data(), text.size()});
+        }
+
+        // Writes the bytes of another writer, which BlobReader::read_blob reads back as a reader of its own.
+        void write_blob(std::span<uint8_t const> blob) {
+            write(static_cast<uint64_t>(blob.size()));
+            align(blob_alignment);
+            write_bytes(std::as_bytes(blob));
+        }
+
+        [[nodiscard]]
+        std::vector<uint8_t> take() {
+            return std::move(bytes_);
+        }
+    };
+
+    // Reads back what a BlobWriter wrote, in the same order. Arrays are viewed where they are, nothing is copied.
+    // Reading past the end throws.
+    class BlobReader final {
+        SharedBytes bytes_;
+        std::size_t offset_{};
+
+        [[nodiscard]]
+        std::size_t get_remaining() const {
+            return bytes_.bytes_.size() - offset_;
+        }
+
+        [[nodiscard]]
+        uint8_t const *take(std::size_t size) {
+            if (size > get_remaining())
+                throw std::runtime_error{"Unexpected end of blob"};
+
+            auto const *bytes_ptr = bytes_.bytes_.data() + offset_;
+            offset_ += size;
+
+            return bytes_ptr;
+        }
+
+        void align(std::size_t alignment) {
+            std::size_t const padding =
+                    (alignment - offset_ % alignment) % alignment;
+            if (padding > get_remaining())
+                throw std::runtime_error{"Unexpected end of blob"};
+
+            offset_ += padding;
+        }
+
+    public:
+        explicit BlobReader(SharedBytes bytes)
+            : bytes_{std::move(bytes)} {
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        [[nodiscard]]
+        T read() {
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+
+            return value;
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        [[nodiscard]]
+        std::span<T const> read_span() {
+            auto const count = read<uint64_t>();
+            align(alignof(T));
+            if (count > get_remaining() / sizeof(T))
+                throw std::runtime_error{"Unexpected end of blob"};
+
+            return {reinterpret_cast<T const *>(take(count * sizeof(T))),
+                    static_cast<std::size_t>(count)};
+        }
+
+        [[nodiscard]]
+        std::string_view read_string() {
+            auto const text = read_span<char>();
+
+            return {text.data(), text.size()};
+        }
+
+        // Bytes written with write_span, sharing the owner of the blob so that they can outlive the reader.
+        [[nodiscard]]
+        SharedBytes read_shared_bytes() {
+            return SharedBytes{bytes_.owner_, read_span<uint8_t>()};
+        }
+
+        // A blob written with write_blob, sharing the owner of this one.
+        [[nodiscard]]
+        BlobReader read_blob() {
+            auto const size = read<uint64_t>();
+            align(blob_alignment);
+            auto const *bytes_ptr = take(size);
+
+            return BlobReader{SharedBytes{
+                    bytes_.owner_, {bytes_ptr, static_cast<std::size_t>(size)}
+            }};
+        }
+
+        // The bytes of the whole blob.
+        [[nodiscard]]
+        SharedBytes const &get_bytes() const {
+            return bytes_;
+        }
+
+        [[nodiscard]]
+        bool is_at_end() const {
+            return get_remaining() == 0;
+        }
+    };
+}// namespace engine
+
+#endif//BLOB_H
@@ -0,0 +1,269 @@
+#include "dynamic_aabb_tree.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace engine {
+    DynamicAabbTree::DynamicAabbTree(float margin)
+        : margin_{margin} {
+    }
+
+    DynamicAabbTree::ProxyId DynamicAabbTree::create_proxy(
+            math::Aabb const &bounds, uint32_t user_data
+    ) {
+        ProxyId const proxy_id = allocate_node();
+
+        auto &node      = nodes_[proxy_id];
+        node.bounds_    = bounds.fattened(margin_);
+        node.user_data_ = user_data;
+        node.height_    = 0;
+
+        insert_leaf(proxy_id);
+        ++proxy_count_;
+
+        return proxy_id;
+    }
+
+    void DynamicAabbTree::destroy_proxy(ProxyId proxy_id) {
+        assert(nodes_[proxy_id].is_leaf());
+
+        remove_leaf(proxy_id);
+        free_node(proxy_id);
+        --proxy_count_;
+    }
+
+    bool DynamicAabbTree::move_proxy(
+            ProxyId proxy_id, math::Aabb const &bounds
+    ) {
+        assert(nodes_[proxy_id].is_leaf());
+
+        if (nodes_[proxy_id].bounds_.contains(bounds))
+            return false;
+
+        remove_leaf(proxy_id);
+        nodes_[proxy_id].bounds_ = bounds.fattened(margin_);
+        insert_leaf(proxy_id);
+
+        return true;
+    }
+
+    DynamicAabbTree::ProxyId DynamicAabbTree::allocate_node() {
+        if (free_list_ == null_node) {
+            nodes_.emplace_back();
+            return static_cast<ProxyId>(nodes_.size() - 1);
+        }
+
+        ProxyId const node_id = free_list_;
+        free_list_            = nodes_[node_id].parent_or_next_;
+        nodes_[node_id]       = Node{};
+
+        return node_id;
+    }
+
+    void DynamicAabbTree::free_node(ProxyId node_id) {
+        nodes_[node_id]                 = Node{};
+        nodes_[node_id].parent_or_next_ = free_list_;
+        free_list_                      = node_id;
+    }
+
+    void DynamicAabbTree::insert_leaf(ProxyId leaf) {
+        if (root_ == null_node) {
+            root_                        = leaf;
+            nodes_[leaf].parent_or_next_ = null_node;
+            return;
+        }
+
+        // Descend to the sibling that increases the total surface area the least.
+        auto const leaf_bounds = nodes_[leaf].bounds_;
+        ProxyId    index       = root_;
+        while (!nodes_[index].is_leaf()) {
+            auto const &node = nodes_[index];
+
+            float const area          = node.bounds_.get_surface_area();
+            float const combined_area =
+                    node.bounds_.merged(leaf_bounds).get_surface_area();
+
+            // Cost of creating a new parent for this node and the leaf.
+            float const cost = 2.f * combined_area;
+            // Minimum cost of pushing the leaf further down the tree.
+            float const inheritance_cost = 2.f * (combined_area - area);
+
+            auto const child_cost = [&](ProxyId child_id) {
+                auto const &child = nodes_[child_id];
+                float const merged_area =
+                        child.bounds_.merged(leaf_bounds).get_surface_area();
+
+                if (child.is_leaf())
+                    return merged_area + inheritance_cost;
+
+                return merged_area - child.bounds_.get_surface_area() +
+                       inheritance_cost;
+            };
+
+            float const cost1 = child_cost(node.child1_);
+            float const cost2 = child_cost(node.child2_);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.child1_ : node.child2_;
+        }
+
+        ProxyId const sibling    = index;
+        ProxyId const new_parent = allocate_node();
+        ProxyId const old_parent = nodes_[sibling].parent_or_next_;
+
+        auto &parent_node           = nodes_[new_parent];
+        parent_node.parent_or_next_ = old_parent;
+        parent_node.bounds_ = leaf_bounds.merged(nodes_[sibling].bounds_);
+        parent_node.height_         = nodes_[sibling].height_ + 1;
+        parent_node.child1_         = sibling;
+        parent_node.child2_         = leaf;
+
+        if (old_parent != null_node) {
+            auto &old_parent_node = nodes_[old_parent];
+            if (old_parent_node.child1_ == sibling) {
+                old_parent_node.child1_ = new_parent;
+            } else {
+                old_parent_node.child2_ = new_parent;
+            }
+        } else {
+            root_ = new_parent;
+        }
+
+        nodes_[sibling].parent_or_next_ = new_parent;
+        nodes_[leaf].parent_or_next_    = new_parent;
+
+        refit_ancestors(nodes_[leaf].parent_or_next_);
+    }
+
+    void DynamicAabbTree::remove_leaf(ProxyId leaf) {
+        if (leaf == root_) {
+            root_ = null_node;
+            return;
+        }
+
+        ProxyId const parent       = nodes_[leaf].parent_or_next_;
+        ProxyId const grand_parent = nodes_[parent].parent_or_next_;
+        ProxyId const sibling      = nodes_[parent].child1_ == leaf
+                                           ? nodes_[parent].child2_
+                                           : nodes_[parent].child1_;
+
+        if (grand_parent != null_node) {
+            auto &grand_parent_node = nodes_[grand_parent];
+            if (grand_parent_node.child1_ == parent) {
+                grand_parent_node.child1_ = sibling;
+            } else {
+                grand_parent_node.child2_ = sibling;
+            }
+            nodes_[sibling].parent_or_next_ = grand_parent;
+            free_node(parent);
+
+            refit_ancestors(grand_parent);
+        } else {
+            root_                           = sibling;
+            nodes_[sibling].parent_or_next_ = null_node;
+            free_node(parent);
+        }
+    }
+
+    void DynamicAabbTree::refit_ancestors(ProxyId node_id) {
+        while (node_id != null_node) {
+            node_id = balance(node_id);
+
+            auto       &node   = nodes_[node_id];
+            auto const &child1 = nodes_[node.child1_];
+            auto const &child2 = nodes_[node.child2_];
+
+            node.height_ = 1 + std::max(child1.height_, child2.height_);
+            node.bounds_ = child1.bounds_.merged(child2.bounds_);
+
+            node_id = node.parent_or_next_;
+        }
+    }
+
+    // Rotates the taller child of `a_id` up if the subtree is imbalanced, returns the new root of the subtree.
+    DynamicAabbTree::ProxyId DynamicAabbTree::balance(ProxyId a_id) {
+        auto &a = nodes_[a_id];
+        if (a.is_leaf() || a.height_ < 2)
+            return a_id;
+
+        ProxyId const b_id = a.child1_;
+        ProxyId const c_id = a.child2_;
+        auto         &b    = nodes_[b_id];
+        auto         &c    = nodes_[c_id];
+
+        int32_t const imbalance = c.height_ - b.height_;
+
+        auto const replace_in_parent = [this, a_id](ProxyId new_child_id) {
+            ProxyId const parent_id = nodes_[new_child_id].parent_or_next_;
+            if (parent_id == null_node) {
+                root_ = new_child_id;
+                return;
+            }
+
+            auto &parent = nodes_[parent_id];
+            if (parent.child1_ == a_id) {
+                parent.child1_ = new_child_id;
+            } else {
+                parent.child2_ = new_child_id;
+            }
+        };
+
+        if (imbalance > 1) {
+            // Rotate c up.
+            ProxyId const f_id = c.child1_;
+            ProxyId const g_id = c.child2_;
+            auto         &f    = nodes_[f_id];
+            auto         &g    = nodes_[g_id];
+
+            c.child1_         = a_id;
+            c.parent_or_next_ = a.parent_or_next_;
+            a.parent_or_next_ = c_id;
+            replace_in_parent(c_id);
+
+            auto &kept  = f.height_ > g.height_ ? f : g;
+            auto &moved = f.height_ > g.height_ ? g : f;
+
+            c.child2_             = f.height_ > g.height_ ? f_id : g_id;
+            a.child2_             = f.height_ > g.height_ ? g_id : f_id;
+            moved.parent_or_next_ = a_id;
+
+            a.bounds_ = b.bounds_.merged(moved.bounds_);
+            c.bounds_ = a.bounds_.merged(kept.bounds_);
+            a.height_ = 1 + std::max(b.height_, moved.height_);
+            c.height_ = 1 + std::max(a.height_, kept.height_);
+
+            return c_id;
+        }
+
+        if (imbalance < -1) {
+            // Rotate b up.
+            ProxyId const d_id = b.child1_;
+            ProxyId const e_id = b.child2_;
+            auto         &d    = nodes_[d_id];
+            auto         &e    = nodes_[e_id];
+
+            b.child1_         = a_id;
+            b.parent_or_next_ = a.parent_or_next_;
+            a.parent_or_next_ = b_id;
+            replace_in_parent(b_id);
+
+            auto &kept  = d.height_ > e.height_ ? d : e;
+            auto &moved = d.height_ > e.height_ ? e : d;
+
+            b.child2_             = d.height_ > e.height_ ? d_id : e_id;
+            a.child1_             = d.height_ > e.height_ ? e_id : d_id;
+            moved.parent_or_next_ = a_id;
+
+            a.bounds_ = c.bounds_.merged(moved.bounds_);
+            b.bounds_ = a.bounds_.merged(kept.bounds_);
+            a.height_ = 1 + std::max(c.height_, moved.height_);
+            b.height_ = 1 + std::max(a.height_, kept.height_);
+
+            return b_id;
+        }
+
+        return a_id;
+    }
+}// namespace engine
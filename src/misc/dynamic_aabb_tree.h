@@ -0,0 +1,118 @@
+#ifndef DYNAMIC_AABB_TREE_H
+#define DYNAMIC_AABB_TREE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "math/aabb.h"
+
+namespace engine {
+    // Bounding volume hierarchy over boxes that move around.
+    // Leaves store fattened boxes so that small movements don't require touching the tree, and the tree is kept
+    // balanced with rotations as leaves are inserted and removed.
+    class DynamicAabbTree final {
+    public:
+        using ProxyId = int32_t;
+
+        static constexpr ProxyId null_node = -1;
+
+        explicit DynamicAabbTree(float margin = 0.1f);
+
+        [[nodiscard]]
+        ProxyId create_proxy(math::Aabb const &bounds, uint32_t user_data);
+
+        void destroy_proxy(ProxyId proxy_id);
+
+        // Returns true if the proxy had to be reinserted because it left its fat bounds.
+        bool move_proxy(ProxyId proxy_id, math::Aabb const &bounds);
+
+        [[nodiscard]]
+        uint32_t get_user_data(ProxyId proxy_id) const {
+            return nodes_[proxy_id].user_data_;
+        }
+
+        [[nodiscard]]
+        math::Aabb const &get_fat_bounds(ProxyId proxy_id) const {
+            return nodes_[proxy_id].bounds_;
+        }
+
+        [[nodiscard]]
+        int32_t get_height() const {
+            return root_ == null_node ? 0 : nodes_[root_].height_;
+        }
+
+        [[nodiscard]]
+        std::size_t get_proxy_count() const {
+            return proxy_count_;
+        }
+
+        // Calls `callback(user_data)` for every leaf whose fat bounds pass `overlaps(bounds)`.
+        // Subtrees whose bounds don't pass the test are skipped as a whole.
+        template<typename Overlaps, typename Callback>
+        void query(Overlaps &&overlaps, Callback &&callback) const {
+            if (root_ == null_node)
+                return;
+
+            query_stack_.clear();
+            query_stack_.push_back(root_);
+
+            while (!query_stack_.empty()) {
+                ProxyId const node_id = query_stack_.back();
+                query_stack_.pop_back();
+
+                auto const &node = nodes_[node_id];
+                if (!overlaps(node.bounds_))
+                    continue;
+
+                if (node.is_leaf()) {
+                    callback(node.user_data_);
+                    continue;
+                }
+
+                query_stack_.push_back(node.child1_);
+                query_stack_.push_back(node.child2_);
+            }
+        }
+
+    private:
+        struct Node final {
+            math::Aabb bounds_{};
+            uint32_t   user_data_{};
+            // Parent while the node is in the tree, next free node otherwise.
+            ProxyId    parent_or_next_{null_node};
+            ProxyId    child1_{null_node};
+            ProxyId    child2_{null_node};
+            // 0 for leaves, -1 for free nodes.
+            int32_t    height_{-1};
+
+            [[nodiscard]]
+            bool is_leaf() const {
+                return child1_ == null_node;
+            }
+        };
+
+        float                        margin_;
+        std::vector<Node>            nodes_;
+        ProxyId                      root_{null_node};
+        ProxyId                      free_list_{null_node};
+        std::size_t                  proxy_count_{};
+        mutable std::vector<ProxyId> query_stack_;
+
+        [[nodiscard]]
+        ProxyId allocate_node();
+
+        void free_node(ProxyId node_id);
+
+        void insert_leaf(ProxyId leaf);
+
+        void remove_leaf(ProxyId leaf);
+
+        // Walks from `node_id` to the root, rebalancing and refitting every ancestor.
+        void refit_ancestors(ProxyId node_id);
+
+        [[nodiscard]]
+        ProxyId balance(ProxyId node_id);
+    };
+}// namespace engine
+
+#endif//DYNAMIC_AABB_TREE_H
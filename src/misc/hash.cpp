@@ -0,0 +1,98 @@
+#include "hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace engine {
+    namespace {
+        constexpr uint64_t c1 = 0x87C37B91114253D5ull;
+        constexpr uint64_t c2 = 0x4CF5AD432745937Full;
+
+        [[nodiscard]]
+        uint64_t load_u64(uint8_t const *bytes_ptr) {
+            uint64_t value;
+            std::memcpy(&value, bytes_ptr, sizeof(value));
+            if constexpr (std::endian::native == std::endian::big)
+                value = std::byteswap(value);
+
+            return value;
+        }
+
+        [[nodiscard]]
+        uint64_t mix_k1(uint64_t k1) {
+            k1 *= c1;
+            k1  = std::rotl(k1, 31);
+
+            return k1 * c2;
+        }
+
+        [[nodiscard]]
+        uint64_t mix_k2(uint64_t k2) {
+            k2 *= c2;
+            k2  = std::rotl(k2, 33);
+
+            return k2 * c1;
+        }
+
+        [[nodiscard]]
+        uint64_t fmix(uint64_t k) {
+            k ^= k >> 33;
+            k *= 0xFF51AFD7ED558CCDull;
+            k ^= k >> 33;
+            k *= 0xC4CEB9FE1A85EC53ull;
+            k ^= k >> 33;
+
+            return k;
+        }
+    }// namespace
+
+    Hash128 hash_bytes(std::span<uint8_t const> bytes, uint64_t seed) {
+        constexpr std::size_t block_size = 16;
+
+        std::size_t const block_count = bytes.size() / block_size;
+        uint64_t          h1          = seed;
+        uint64_t          h2          = seed;
+
+        for (std::size_t block = 0; block < block_count; ++block) {
+            uint8_t const *block_ptr = bytes.data() + block * block_size;
+
+            h1 ^= mix_k1(load_u64(block_ptr));
+            h1  = std::rotl(h1, 27);
+            h1 += h2;
+            h1  = h1 * 5 + 0x52DCE729;
+
+            h2 ^= mix_k2(load_u64(block_ptr + 8));
+            h2  = std::rotl(h2, 31);
+            h2 += h1;
+            h2  = h2 * 5 + 0x38495AB5;
+        }
+
+        // The remaining bytes are read as little endian words, zero padded.
+        auto const tail = bytes.subspan(block_count * block_size);
+        uint64_t   k1{};
+        uint64_t   k2{};
+        for (std::size_t i = tail.size(); i > 8; --i) {
+            k2 = (k2 << 8) | tail[i - 1];
+        }
+        for (std::size_t i = std::min<std::size_t>(tail.size(), 8); i > 0;
+             --i) {
+            k1 = (k1 << 8) | tail[i - 1];
+        }
+        if (tail.size() > 8)
+            h2 ^= mix_k2(k2);
+        if (!tail.empty())
+            h1 ^= mix_k1(k1);
+
+        h1 ^= bytes.size();
+        h2 ^= bytes.size();
+        h1 += h2;
+        h2 += h1;
+        h1  = fmix(h1);
+        h2  = fmix(h2);
+        h1 += h2;
+        h2 += h1;
+
+        return Hash128{h1, h2};
+    }
+}// namespace engine
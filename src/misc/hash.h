@@ -0,0 +1,30 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace engine {
+    struct Hash128 final {
+        uint64_t low_{};
+        uint64_t high_{};
+
+        bool operator==(Hash128 const &) const = default;
+    };
+
+    // MurmurHash3 x64_128 of the bytes. Not cryptographic, but fast enough to hash whole files before deciding
+    // whether to decode them, and with 128 bits collisions between different contents are practically impossible.
+    [[nodiscard]]
+    Hash128 hash_bytes(std::span<uint8_t const> bytes, uint64_t seed = 0);
+
+    // The hash is already well mixed, so half of it makes a good hash for unordered containers.
+    struct Hash128Hasher final {
+        [[nodiscard]]
+        std::size_t operator()(Hash128 const &hash) const {
+            return static_cast<std::size_t>(hash.low_);
+        }
+    };
+}// namespace engine
+
+#endif//HASH_H
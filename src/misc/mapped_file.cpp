@@ -0,0 +1,82 @@
+#include "mapped_file.h"
+
+#include <memory>
+#include <stdexcept>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define ENGINE_MAPPED_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace engine {
+#ifdef ENGINE_MAPPED_FILE_MMAP
+    MappedFile::MappedFile(std::filesystem::path const &path) {
+        int const file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) {
+            throw std::runtime_error("Failed to open file: " + path.string());
+        }
+
+        struct stat status{};
+        if (::fstat(file, &status) != 0) {
+            ::close(file);
+            throw std::runtime_error("Failed to stat file: " + path.string());
+        }
+
+        // Empty files can't be mapped, they have no bytes to view anyway.
+        auto const size = static_cast<std::size_t>(status.st_size);
+        if (size > 0) {
+            void *const mapping_ptr =
+                    ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (mapping_ptr == MAP_FAILED) {
+                ::close(file);
+                throw std::runtime_error("Failed to map file: " + path.string()
+                );
+            }
+
+            bytes_     = {static_cast<uint8_t const *>(mapping_ptr), size};
+            is_mapped_ = true;
+        }
+
+        // The mapping stays valid after the file is closed.
+        ::close(file);
+    }
+
+    MappedFile::~MappedFile() {
+        if (is_mapped_) {
+            ::munmap(const_cast<uint8_t *>(bytes_.data()), bytes_.size());
+        }
+    }
+#else
+    MappedFile::MappedFile(std::filesystem::path const &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw std::runtime_error("Failed to open file: " + path.string());
+        }
+
+        buffer_.resize(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(
+                    reinterpret_cast<char *>(buffer_.data()),
+                    static_cast<std::streamsize>(buffer_.size())
+            )) {
+            throw std::runtime_error("Failed to read file: " + path.string());
+        }
+
+        bytes_ = buffer_;
+    }
+
+    MappedFile::~MappedFile() = default;
+#endif
+
+    SharedBytes map_file(std::filesystem::path const &path) {
+        auto       file  = std::make_shared<MappedFile const>(path);
+        auto const bytes = file->get_bytes();
+
+        return SharedBytes{std::move(file), bytes};
+    }
+}// namespace engine
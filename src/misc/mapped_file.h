@@ -0,0 +1,42 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "shared_bytes.h"
+
+namespace engine {
+    // Read-only view of the contents of a whole file. Where it's supported the file is memory mapped, so opening it
+    // copies nothing and repeated loads are served from the page cache. Elsewhere, e.g. under Emscripten, whose files
+    // are in memory already, it's read into a buffer.
+    class MappedFile final {
+        std::span<uint8_t const> bytes_;
+        // Holds the contents when the file isn't mapped.
+        std::vector<uint8_t>     buffer_;
+        bool                     is_mapped_{false};
+
+    public:
+        explicit MappedFile(std::filesystem::path const &path);
+
+        ~MappedFile();
+
+        MappedFile(MappedFile const &)            = delete;
+        MappedFile &operator=(MappedFile const &) = delete;
+        MappedFile(MappedFile &&)                 = delete;
+        MappedFile &operator=(MappedFile &&)      = delete;
+
+        [[nodiscard]]
+        std::span<uint8_t const> get_bytes() const {
+            return bytes_;
+        }
+    };
+
+    // The file stays mapped until the last copy of the bytes is gone.
+    [[nodiscard]]
+    SharedBytes map_file(std::filesystem::path const &path);
+}// namespace engine
+
+#endif//MAPPED_FILE_H
@@ -0,0 +1,68 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace engine {
+    // Stable LSD radix sort on a 64-bit key, one byte per pass.
+    // Passes in which every key has the same byte are skipped, which makes sorting keys that only use a few of their
+    // bits cheap. `scratch` is only used as temporary storage and can be reused between calls to avoid reallocating.
+    template<typename T, typename KeyFn>
+        requires std::is_trivially_copyable_v<T> &&
+                 std::convertible_to<std::invoke_result_t<KeyFn, T const &>,
+                                     uint64_t>
+    void
+    radix_sort(std::span<T> items, std::vector<T> &scratch, KeyFn &&key_of) {
+        constexpr std::size_t num_passes = sizeof(uint64_t);
+        constexpr std::size_t radix      = 256;
+
+        if (items.size() < 2)
+            return;
+
+        std::array<std::array<std::size_t, radix>, num_passes> histograms{};
+        for (auto const &item : items) {
+            auto const key = static_cast<uint64_t>(key_of(item));
+            for (std::size_t pass = 0; pass < num_passes; ++pass) {
+                ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+            }
+        }
+
+        scratch.resize(items.size());
+        T *src_ptr = items.data();
+        T *dst_ptr = scratch.data();
+
+        for (std::size_t pass = 0; pass < num_passes; ++pass) {
+            auto &histogram = histograms[pass];
+
+            auto const first_key = static_cast<uint64_t>(key_of(src_ptr[0]));
+            if (histogram[(first_key >> (pass * 8)) & 0xFF] == items.size())
+                continue;
+
+            std::size_t offset{};
+            for (auto &count : histogram) {
+                auto const bucket_size = count;
+                count                  = offset;
+                offset += bucket_size;
+            }
+
+            for (std::size_t i = 0; i < items.size(); ++i) {
+                auto const key = static_cast<uint64_t>(key_of(src_ptr[i]));
+                dst_ptr[histogram[(key >> (pass * 8)) & 0xFF]++] = src_ptr[i];
+            }
+
+            std::swap(src_ptr, dst_ptr);
+        }
+
+        if (src_ptr != items.data()) {
+            std::copy(src_ptr, src_ptr + items.size(), items.data());
+        }
+    }
+}// namespace engine
+
+#endif//RADIX_SORT_H
@@ -0,0 +1,65 @@
+#include "range_allocator.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace engine {
+    RangeAllocator::RangeAllocator(uint32_t capacity)
+        : capacity_{capacity}
+        , free_size_{capacity} {
+        if (capacity != 0)
+            free_ranges_.emplace(0, capacity);
+    }
+
+    std::optional<uint32_t> RangeAllocator::allocate(uint32_t size) {
+        if (size == 0 || size > free_size_)
+            return std::nullopt;
+
+        for (auto it = free_ranges_.begin(); it != free_ranges_.end(); ++it) {
+            auto const [offset, range_size] = *it;
+            if (range_size < size)
+                continue;
+
+            free_ranges_.erase(it);
+            if (range_size > size)
+                free_ranges_.emplace(offset + size, range_size - size);
+
+            free_size_ -= size;
+            return offset;
+        }
+
+        return std::nullopt;
+    }
+
+    void RangeAllocator::free(uint32_t offset, uint32_t size) {
+        if (size == 0)
+            return;
+
+        assert(offset + size <= capacity_);
+
+        uint32_t merged_offset = offset;
+        uint32_t merged_size   = size;
+
+        auto next = free_ranges_.lower_bound(offset);
+        assert(next == free_ranges_.end() || next->first >= offset + size);
+
+        if (next != free_ranges_.begin()) {
+            auto const prev = std::prev(next);
+            assert(prev->first + prev->second <= offset);
+
+            if (prev->first + prev->second == offset) {
+                merged_offset = prev->first;
+                merged_size += prev->second;
+                free_ranges_.erase(prev);
+            }
+        }
+
+        if (next != free_ranges_.end() && next->first == offset + size) {
+            merged_size += next->second;
+            free_ranges_.erase(next);
+        }
+
+        free_ranges_.emplace(merged_offset, merged_size);
+        free_size_ += size;
+    }
+}// namespace engine
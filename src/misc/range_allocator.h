@@ -0,0 +1,45 @@
+#ifndef RANGE_ALLOCATOR_H
+#define RANGE_ALLOCATOR_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace engine {
+    // Hands out ranges of [0, capacity) on a first-fit basis. Freed ranges are merged with adjacent free ranges, so
+    // the space can be reused for larger allocations later on.
+    class RangeAllocator final {
+    public:
+        explicit RangeAllocator(uint32_t capacity);
+
+        // Returns the offset of the range, or nothing if there is no free range of that size.
+        [[nodiscard]]
+        std::optional<uint32_t> allocate(uint32_t size);
+
+        // `offset` and `size` must be those of a range returned by allocate.
+        void free(uint32_t offset, uint32_t size);
+
+        [[nodiscard]]
+        uint32_t get_capacity() const {
+            return capacity_;
+        }
+
+        [[nodiscard]]
+        uint32_t get_free_size() const {
+            return free_size_;
+        }
+
+        [[nodiscard]]
+        std::size_t get_free_range_count() const {
+            return free_ranges_.size();
+        }
+
+    private:
+        uint32_t capacity_;
+        uint32_t free_size_;
+        // Offset to size, ordered by offset so that neighbours can be found when freeing.
+        std::map<uint32_t, uint32_t> free_ranges_;
+    };
+}// namespace engine
+
+#endif//RANGE_ALLOCATOR_H
@@ -0,0 +1,34 @@
+#ifndef SHARED_BYTES_H
+#define SHARED_BYTES_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace engine {
+    // A view of bytes together with whatever keeps them alive, e.g. a loaded glTF asset or a mip chain. Copies share
+    // the owner, so the bytes can be passed around and handed to bgfx without copying them.
+    struct SharedBytes final {
+        std::shared_ptr<void const> owner_;
+        std::span<uint8_t const>    bytes_;
+
+        [[nodiscard]]
+        static SharedBytes from_vector(std::vector<uint8_t> &&bytes) {
+            auto owner = std::make_shared<std::vector<uint8_t> const>(
+                    std::move(bytes)
+            );
+            std::span<uint8_t const> const view{*owner};
+
+            return SharedBytes{std::move(owner), view};
+        }
+
+        [[nodiscard]]
+        SharedBytes subspan(std::size_t offset) const {
+            return SharedBytes{owner_, bytes_.subspan(offset)};
+        }
+    };
+}// namespace engine
+
+#endif//SHARED_BYTES_H
@@ -0,0 +1,57 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace engine {
+    ThreadPool::ThreadPool()
+        : ThreadPool{std::max(std::thread::hardware_concurrency(), 2u) - 1} {
+    }
+
+    ThreadPool::ThreadPool(std::size_t worker_count) {
+        workers_.reserve(worker_count);
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard const lock{mutex_};
+            stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::enqueue(Job job) {
+        {
+            std::lock_guard const lock{mutex_};
+            jobs_.push_back(std::move(job));
+        }
+        condition_.notify_one();
+    }
+
+    void ThreadPool::work() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock{mutex_};
+                condition_.wait(lock, [this] {
+                    return stopping_ || !jobs_.empty();
+                });
+
+                // Jobs still in the queue are finished before stopping.
+                if (jobs_.empty())
+                    return;
+
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+
+            job();
+        }
+    }
+}// namespace engine
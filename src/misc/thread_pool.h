@@ -0,0 +1,112 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "singleton.h"
+
+namespace engine {
+    // Fixed set of worker threads that run jobs from a shared queue.
+    class ThreadPool final : public Singleton<ThreadPool> {
+    public:
+        using Job = std::function<void()>;
+
+        // Uses one worker per hardware thread, minus the calling thread.
+        ThreadPool();
+
+        explicit ThreadPool(std::size_t worker_count);
+
+        ~ThreadPool() override;
+
+        [[nodiscard]]
+        std::size_t get_worker_count() const {
+            return workers_.size();
+        }
+
+        // Runs the job on one of the workers at some point.
+        void enqueue(Job job);
+
+        // Calls `task(index)` for every index in [0, count) and returns once all calls are done. Index 0 always runs
+        // on the calling thread, which then takes further indices of this call until none are left, so nested calls
+        // can't deadlock and the caller never ends up running unrelated jobs. If a task throws, indices that haven't
+        // started are skipped and the first error is rethrown once the running ones are done.
+        template<typename Task>
+        void parallel_for(std::size_t count, Task &&task) {
+            if (count == 0)
+                return;
+
+            // Helpers that only start after the call returned find no index left and never touch the task.
+            struct State final {
+                std::atomic<std::size_t> next_index{1};
+                std::atomic<bool>        failed{};
+                std::mutex               done_mutex;
+                std::condition_variable  done_condition;
+                std::size_t              done_count{};
+                std::exception_ptr       error;
+            };
+            auto const state    = std::make_shared<State>();
+            auto      *task_ptr = &task;
+
+            auto const run_index = [state, task_ptr, count](std::size_t index) {
+                std::exception_ptr error;
+                if (!state->failed) {
+                    try {
+                        (*task_ptr)(index);
+                    } catch (...) {
+                        error = std::current_exception();
+                        state->failed = true;
+                    }
+                }
+
+                std::lock_guard const lock{state->done_mutex};
+                if (error && !state->error)
+                    state->error = error;
+                if (++state->done_count == count)
+                    state->done_condition.notify_all();
+            };
+            auto const run_indices = [state, run_index, count] {
+                for (auto index = state->next_index++; index < count;
+                     index      = state->next_index++) {
+                    run_index(index);
+                }
+            };
+
+            std::size_t const helper_count =
+                    std::min(count - 1, workers_.size());
+            for (std::size_t i = 0; i < helper_count; ++i) {
+                enqueue(run_indices);
+            }
+
+            run_index(0);
+            run_indices();
+
+            std::unique_lock lock{state->done_mutex};
+            state->done_condition.wait(lock, [&] {
+                return state->done_count == count;
+            });
+            if (state->error)
+                std::rethrow_exception(state->error);
+        }
+
+    private:
+        std::mutex               mutex_;
+        std::condition_variable  condition_;
+        std::deque<Job>          jobs_;
+        bool                     stopping_{};
+        std::vector<std::thread> workers_;
+
+        void work();
+    };
+}// namespace engine
+
+#endif//THREAD_POOL_H
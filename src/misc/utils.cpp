@@ -1,24 +1,24 @@
 #include "utils.h"
 
 #include <format>
-#include <fstream>
 #include <numbers>
-#include <vector>
+
+#include "mapped_file.h"
 
 namespace engine::utils {
     bgfx::Memory const *
     read_file_to_bgfx_memory(std::filesystem::path const &path) {
-        std::ifstream file(path, std::ios::binary);
-
-        if (!file) {
-            throw std::runtime_error("Failed to open file: " + path.string());
-        }
+        return make_bgfx_ref(map_file(path));
+    }
 
-        std::vector const buffer(
-                (std::istreambuf_iterator(file)),
-                std::istreambuf_iterator<char>()
+    bgfx::Memory const *make_bgfx_ref(SharedBytes const &bytes) {
+        return bgfx::makeRef(
+                bytes.bytes_.data(), static_cast<uint32_t>(bytes.bytes_.size()),
+                [](void *, void *user_data_ptr) {
+                    delete static_cast<SharedBytes *>(user_data_ptr);
+                },
+                new SharedBytes{bytes}
         );
-        return bgfx::copy(buffer.data(), buffer.size());
     }
 
     ShaderUPtr load_shader(std::string_view file_name) {
@@ -6,6 +6,7 @@
 #include <functional>
 #include <string_view>
 
+#include "misc/shared_bytes.h"
 #include "types.h"
 
 namespace bx {
@@ -13,9 +14,13 @@ namespace bx {
 }
 
 namespace engine::utils {
+    // References the mapped file, nothing is copied until bgfx uses it.
     bgfx::Memory const *
     read_file_to_bgfx_memory(std::filesystem::path const &path);
 
+    // Hands the bytes to bgfx without copying them, bgfx keeps their owner alive until it is done with them.
+    bgfx::Memory const *make_bgfx_ref(SharedBytes const &bytes);
+
     ShaderUPtr load_shader(std::string_view path);
 
     [[nodiscard]]
@@ -6,7 +6,6 @@
 #include <memory>
 
 #include "application.h"
-#include "constants.h"
 #include "emscripten_constants.h"
 #include "emscripten_input.h"
 #include "input/mouse_keyboard_input.h"
@@ -81,10 +80,6 @@ namespace engine::core {
                         static_cast<uint32_t>(app.get_height()),
                         BGFX_RESET_VSYNC
                 );
-                bgfx::setViewRect(
-                        constants::clear_view, 0, 0,
-                        bgfx::BackbufferRatio::Equal
-                );
             }
 
             main_loop_();
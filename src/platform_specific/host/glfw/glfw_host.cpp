@@ -6,7 +6,6 @@
 #include <memory>
 
 #include "application.h"
-#include "constants.h"
 #include "glfw_incl.h"
 #include "glfw_window.h"
 #include "presentation/game_host.h"
@@ -61,10 +60,6 @@ namespace engine::core {
                             static_cast<uint32_t>(app.get_height()),
                             BGFX_RESET_VSYNC
                     );
-                    bgfx::setViewRect(
-                            constants::clear_view, 0, 0,
-                            bgfx::BackbufferRatio::Equal
-                    );
                 }
 
                 main_loop_();
@@ -3,10 +3,12 @@
 #include "components/camera.h"
 #include "components/mesh_renderer.h"
 #include "components/player.h"
+#include "graphics/spatial_index.h"
 
 namespace engine {
     Scene::Scene() {
         registry_->ctx().emplace<Scene *>(this);
+        registry_->ctx().emplace<SpatialIndex>(*registry_);
     };
 
     Scene::Scene(Scene &&other) noexcept
@@ -37,6 +39,8 @@ namespace engine {
     }
 
     void Scene::render(Game const &game) const {
+        registry_->ctx().get<SpatialIndex>().update(*registry_);
+
         registry_->view<Camera>().each([&](auto const &camera) {
             camera.render(game);
         });
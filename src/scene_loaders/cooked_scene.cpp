@@ -0,0 +1,421 @@
+#include "cooked_scene.h"
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <limits>
+
+#include "misc/mapped_file.h"
+
+namespace engine {
+    namespace {
+        template<typename T>
+        void write_vector(BlobWriter &writer, std::vector<T> const &values) {
+            writer.write_span(std::span<T const>{values});
+        }
+
+        [[nodiscard]]
+        std::string to_hex(Hash128 const &hash) {
+            return std::format("{:016x}{:016x}", hash.high_, hash.low_);
+        }
+
+        [[nodiscard]]
+        std::optional<Hash128> from_hex(std::string_view text) {
+            constexpr std::size_t word_size = 16;
+            if (text.size() != 2 * word_size)
+                return std::nullopt;
+
+            Hash128    hash{};
+            auto const parse_word = [&](std::size_t offset, uint64_t &word) {
+                auto const *first = text.data() + offset;
+                auto const *last  = first + word_size;
+                auto const  result = std::from_chars(first, last, word, 16);
+
+                return result.ec == std::errc{} && result.ptr == last;
+            };
+            if (!parse_word(0, hash.high_) || !parse_word(word_size, hash.low_))
+                return std::nullopt;
+
+            return hash;
+        }
+
+        [[nodiscard]]
+        bool is_valid_primitive(
+                CookedPrimitive const &primitive, std::size_t image_count
+        ) {
+            using IndexFormat = Primitive::IndexFormat;
+
+            bool const has_format =
+                    primitive.format_ == IndexFormat::TriangleList ||
+                    primitive.format_ == IndexFormat::TriangleStrip;
+            bool const has_vertex_format =
+                    primitive.vertex_format_ == VertexFormat::Float ||
+                    primitive.vertex_format_ == VertexFormat::Packed;
+
+            return has_format && has_vertex_format &&
+                   (primitive.albedo_image_ == CookedPrimitive::no_image ||
+                    primitive.albedo_image_ < image_count);
+        }
+
+        // Indices past the vertices would be read, and written, out of bounds when the primitive is processed.
+        [[nodiscard]]
+        bool are_valid_indices(
+                std::span<Index const> indices, std::size_t vertex_count,
+                Primitive::IndexFormat format
+        ) {
+            if (format == Primitive::IndexFormat::TriangleList &&
+                indices.size() % 3 != 0)
+                return false;
+
+            return std::ranges::all_of(indices, [&](Index const index) {
+                return index < vertex_count;
+            });
+        }
+
+        // The levels have to be laid out like build_mip_chain lays them out, down to 1x1, since the texture is
+        // created with all of them from the level it starts at. Sizes are limited to what bgfx takes.
+        [[nodiscard]]
+        bool is_valid_mip_chain(
+                uint32_t channels,
+                std::span<texture_processing::MipLevel const> levels,
+                std::size_t                                   data_size
+        ) {
+            if (channels == 0 || channels > 4 || levels.empty())
+                return false;
+
+            constexpr uint32_t max_size = std::numeric_limits<uint16_t>::max();
+
+            uint32_t const width  = levels.front().width_;
+            uint32_t const height = levels.front().height_;
+            if (width == 0 || height == 0 || width > max_size ||
+                height > max_size ||
+                levels.size() !=
+                        texture_processing::get_mip_count(width, height))
+                return false;
+
+            std::size_t offset{};
+            for (std::size_t level = 0; level < levels.size(); ++level) {
+                auto const &mip = levels[level];
+                if (mip.width_ != std::max(width >> level, 1u) ||
+                    mip.height_ != std::max(height >> level, 1u) ||
+                    mip.offset_ != offset)
+                    return false;
+
+                offset += static_cast<std::size_t>(mip.width_) * mip.height_ *
+                          channels;
+            }
+
+            return offset <= data_size;
+        }
+    }// namespace
+
+    std::optional<FileStamp> get_file_stamp(std::filesystem::path const &path) {
+        std::error_code error;
+        auto const      size = std::filesystem::file_size(path, error);
+        if (error)
+            return std::nullopt;
+
+        auto const time = std::filesystem::last_write_time(path, error);
+        if (error)
+            return std::nullopt;
+
+        return FileStamp{
+                size, static_cast<int64_t>(time.time_since_epoch().count())
+        };
+    }
+
+    void write_cooked_header(BlobWriter &writer, Hash128 const &key) {
+        writer.write(CookedSceneHeader{.key_ = key});
+    }
+
+    void write_cooked_dependencies(
+            BlobWriter &writer, std::span<CookedDependency const> dependencies
+    ) {
+        writer.write(static_cast<uint64_t>(dependencies.size()));
+        for (auto const &dependency : dependencies) {
+            writer.write_string(dependency.path_.generic_string());
+            writer.write(dependency.kind_);
+            writer.write(dependency.hash_);
+            writer.write(dependency.stamp_);
+        }
+    }
+
+    void write_cooked_images(BlobWriter &writer, CookedImages const &images) {
+        writer.write(static_cast<uint64_t>(images.images_.size()));
+        for (auto const &[name, hash, image] : images.images_) {
+            writer.write_string(name);
+            writer.write(hash);
+
+            if (auto const *chain_ptr =
+                        std::get_if<MipChainView>(&image.data_)) {
+                writer.write(CookedImageKind::MipChain);
+                writer.write(chain_ptr->channels_);
+                write_vector(writer, chain_ptr->levels_);
+                writer.write_span(chain_ptr->data_.bytes_);
+            } else {
+                writer.write(CookedImageKind::Container);
+                writer.write_span(std::get<SharedBytes>(image.data_).bytes_);
+            }
+        }
+
+        write_vector(writer, images.image_indices_);
+    }
+
+    void write_cooked_meshes(
+            BlobWriter &writer, std::span<MeshToCook const> meshes
+    ) {
+        writer.write(static_cast<uint64_t>(meshes.size()));
+        for (auto const &mesh : meshes) {
+            writer.write_string(mesh.name_);
+            writer.write(static_cast<uint64_t>(mesh.primitives_.size()));
+
+            for (auto const &primitive : mesh.primitives_) {
+                auto cooked = primitive.primitive_;
+                cooked.lod_count_ =
+                        static_cast<uint32_t>(primitive.lods_.size());
+                cooked.vertex_format_ =
+                        std::holds_alternative<std::vector<PackedVertex>>(
+                                primitive.vertices_
+                        )
+                                ? VertexFormat::Packed
+                                : VertexFormat::Float;
+                writer.write(cooked);
+
+                std::visit(
+                        [&writer](auto const &vertices) {
+                            write_vector(writer, vertices);
+                        },
+                        primitive.vertices_
+                );
+                write_vector(writer, primitive.indices_);
+                for (auto const &lod : primitive.lods_) {
+                    writer.write(lod.error_);
+                    write_vector(writer, lod.indices_);
+                }
+            }
+        }
+    }
+
+    void write_cooked_nodes(
+            BlobWriter &writer, std::span<CookedNode const> nodes,
+            std::span<std::vector<uint32_t> const> children,
+            std::span<uint32_t const>              root_nodes
+    ) {
+        writer.write(static_cast<uint64_t>(nodes.size()));
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            writer.write(nodes[i]);
+            write_vector(writer, children[i]);
+        }
+
+        writer.write_span(root_nodes);
+    }
+
+    std::optional<std::vector<CookedDependency>>
+    read_cooked_prologue(BlobReader &reader, Hash128 const &key) {
+        auto const header = reader.read<CookedSceneHeader>();
+        if (header.magic_ != CookedSceneHeader::magic ||
+            header.version_ != CookedSceneHeader::version ||
+            header.key_ != key)
+            return std::nullopt;
+
+        auto const dependency_count = reader.read<uint64_t>();
+        std::vector<CookedDependency> dependencies;
+        for (uint64_t i = 0; i < dependency_count; ++i) {
+            std::filesystem::path path{reader.read_string()};
+            auto const            kind  = reader.read<CookedDependencyKind>();
+            auto const            hash  = reader.read<Hash128>();
+            auto const            stamp = reader.read<FileStamp>();
+            dependencies.push_back({std::move(path), kind, hash, stamp});
+        }
+
+        return dependencies;
+    }
+
+    std::optional<BlobReader> open_cooked_scene(
+            SharedBytes const &bytes, Hash128 const &key,
+            std::filesystem::path const &directory
+    ) {
+        // Anything that doesn't match, including a truncated file or a missing dependency, is a stale cache.
+        try {
+            BlobReader reader{bytes};
+
+            auto const dependencies = read_cooked_prologue(reader, key);
+            if (!dependencies)
+                return std::nullopt;
+
+            // Files that were touched without changing, e.g. by copying them, are hashed on every load until the
+            // scene is cooked again.
+            for (auto const &dependency : *dependencies) {
+                auto const path = directory / dependency.path_;
+                if (get_file_stamp(path) == dependency.stamp_)
+                    continue;
+                if (hash_bytes(map_file(path).bytes_) != dependency.hash_)
+                    return std::nullopt;
+            }
+
+            auto       body   = reader;
+            auto const images = read_cooked_images(body);
+            validate_cooked_geometry(body.read_blob(), images.images_.size());
+
+            return reader;
+        } catch (std::exception const &) {
+            return std::nullopt;
+        }
+    }
+
+    CookedImages read_cooked_images(BlobReader &reader) {
+        CookedImages images;
+
+        auto const image_count = reader.read<uint64_t>();
+        images.images_.reserve(image_count);
+        for (uint64_t i = 0; i < image_count; ++i) {
+            auto &image = images.images_.emplace_back();
+            image.name_ = reader.read_string();
+            image.hash_ = reader.read<Hash128>();
+
+            if (reader.read<CookedImageKind>() == CookedImageKind::MipChain) {
+                auto const channels = reader.read<uint32_t>();
+                auto const levels =
+                        reader.read_span<texture_processing::MipLevel>();
+                auto data = reader.read_shared_bytes();
+                if (!is_valid_mip_chain(channels, levels, data.bytes_.size()))
+                    throw std::runtime_error{"Cooked mip chain is invalid"};
+
+                image.image_.data_ = MipChainView{
+                        channels, {levels.begin(), levels.end()},
+                        std::move(data)
+                };
+            } else {
+                image.image_.data_ = reader.read_shared_bytes();
+            }
+        }
+
+        auto const image_indices = reader.read_span<uint32_t>();
+        images.image_indices_.assign(
+                image_indices.begin(), image_indices.end()
+        );
+        for (auto const index : images.image_indices_) {
+            if (index >= images.images_.size())
+                throw std::runtime_error{"Cooked image index is out of range"};
+        }
+
+        return images;
+    }
+
+    void
+    validate_cooked_geometry(BlobReader geometry, std::size_t image_count) {
+        auto const mesh_count = geometry.read<uint64_t>();
+        for (uint64_t mesh_index = 0; mesh_index < mesh_count; ++mesh_index) {
+            static_cast<void>(geometry.read_string());
+
+            auto const primitive_count = geometry.read<uint64_t>();
+            for (uint64_t i = 0; i < primitive_count; ++i) {
+                auto const primitive = geometry.read<CookedPrimitive>();
+                if (!is_valid_primitive(primitive, image_count))
+                    throw std::runtime_error{"Cooked primitive is invalid"};
+
+                std::size_t const vertex_count =
+                        primitive.vertex_format_ == VertexFormat::Packed
+                                ? geometry.read_span<PackedVertex>().size()
+                                : geometry.read_span<Vertex>().size();
+                if (!are_valid_indices(
+                            geometry.read_span<Index>(), vertex_count,
+                            primitive.format_
+                    ))
+                    throw std::runtime_error{"Cooked indices are invalid"};
+
+                // Levels of detail are always triangle lists.
+                for (uint32_t lod = 0; lod < primitive.lod_count_; ++lod) {
+                    static_cast<void>(geometry.read<float>());
+                    if (!are_valid_indices(
+                                geometry.read_span<Index>(), vertex_count,
+                                Primitive::IndexFormat::TriangleList
+                        ))
+                        throw std::runtime_error{
+                                "Cooked level of detail is invalid"
+                        };
+                }
+            }
+        }
+
+        // Children are only checked once every node was read, a damaged count isn't trusted before that.
+        auto const node_count = geometry.read<uint64_t>();
+        std::vector<std::span<uint32_t const>> children;
+        for (uint64_t i = 0; i < node_count; ++i) {
+            auto const node = geometry.read<CookedNode>();
+            if (node.mesh_ != CookedNode::no_mesh && node.mesh_ >= mesh_count)
+                throw std::runtime_error{"Cooked node mesh is out of range"};
+
+            children.push_back(geometry.read_span<uint32_t>());
+        }
+
+        // Every node is a root or the child of one other node, so instantiating them from the roots ends.
+        children.push_back(geometry.read_span<uint32_t>());
+        std::vector<uint32_t> reference_counts(node_count);
+        for (auto const node_indices : children) {
+            for (auto const node_index : node_indices) {
+                if (node_index >= node_count ||
+                    ++reference_counts[node_index] > 1)
+                    throw std::runtime_error{"Cooked nodes don't form a tree"};
+            }
+        }
+    }
+
+    // One line per scene: key, cooked path and source path, separated by tabs.
+    std::vector<CookedManifestEntry>
+    read_cooked_manifest(std::filesystem::path const &directory) {
+        std::vector<CookedManifestEntry> entries;
+
+        std::ifstream file{directory / cooked_manifest_name};
+        std::string   line;
+        while (std::getline(file, line)) {
+            auto const key_end    = line.find('\t');
+            auto const cooked_end = line.find('\t', key_end + 1);
+            if (key_end == std::string::npos || cooked_end == std::string::npos)
+                continue;
+
+            auto const key =
+                    from_hex(std::string_view{line}.substr(0, key_end));
+            if (!key)
+                continue;
+
+            entries.push_back(
+                    {*key, line.substr(key_end + 1, cooked_end - key_end - 1),
+                     line.substr(cooked_end + 1)}
+            );
+        }
+
+        return entries;
+    }
+
+    void write_cooked_manifest(
+            std::filesystem::path const         &directory,
+            std::span<CookedManifestEntry const> entries
+    ) {
+        std::filesystem::create_directories(directory);
+
+        // Written under another name first, so that a game that starts meanwhile reads the old manifest or the new
+        // one, never one that is partially written.
+        auto const manifest_path  = directory / cooked_manifest_name;
+        auto       temporary_path = manifest_path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream file{temporary_path, std::ios::trunc};
+            for (auto const &entry : entries) {
+                file << to_hex(entry.key_) << '\t'
+                     << entry.cooked_path_.generic_string() << '\t'
+                     << entry.source_path_.generic_string() << '\n';
+            }
+
+            if (!file) {
+                throw std::runtime_error{std::format(
+                        "Failed to write {}", temporary_path.string()
+                )};
+            }
+        }
+
+        std::filesystem::rename(temporary_path, manifest_path);
+    }
+}// namespace engine
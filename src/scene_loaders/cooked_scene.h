@@ -0,0 +1,189 @@
+#ifndef COOKED_SCENE_H
+#define COOKED_SCENE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "graphics/mesh.h"
+#include "graphics/texture.h"
+#include "misc/blob.h"
+#include "misc/hash.h"
+
+namespace engine {
+    // A scene after all loading work is done: processed vertex and index data, decoded or compressed images and the
+    // node hierarchy, written with BlobWriter so that it can be mapped and used in place. Scene caches store it as
+    //   header, dependencies, images, geometry
+    // where the geometry is a nested blob of meshes, nodes and root nodes, so that it can be copied as a whole into a
+    // scene that is cooked again. Scenes that aren't cached only cook their geometry.
+    struct CookedSceneHeader final {
+        static constexpr uint64_t magic   = 0x454E4543534B4F43;
+        // Bumped whenever the layout or the processing of cooked scenes changes.
+        static constexpr uint32_t version = 4;
+
+        uint64_t magic_{magic};
+        uint32_t version_{version};
+        uint32_t reserved_{};
+        // Hash of the glTF file and of the options that affect the cooked data.
+        Hash128  key_{};
+    };
+
+    enum class CookedDependencyKind : uint32_t {
+        // The geometry is made from the buffers.
+        Buffer,
+        Image,
+    };
+
+    // Size and modification time of a file, a file whose stamp didn't change isn't read to check its contents.
+    struct FileStamp final {
+        uint64_t size_{};
+        int64_t  modified_time_{};
+
+        bool operator==(FileStamp const &) const = default;
+    };
+
+    // A file the cooked scene was made from, with a hash of its contents and its stamp when it was cooked.
+    struct CookedDependency final {
+        std::filesystem::path path_;
+        CookedDependencyKind  kind_;
+        Hash128               hash_;
+        FileStamp             stamp_;
+    };
+
+    enum class CookedImageKind : uint32_t {
+        MipChain,
+        Container,
+    };
+
+    // Images that are read back refer to the cooked bytes.
+    struct CookedImage final {
+        std::string  name_;
+        // Hash of the bytes the image was decoded from.
+        Hash128      hash_;
+        DecodedImage image_;
+    };
+
+    struct CookedImages final {
+        std::vector<CookedImage> images_;
+        // Index in `images_` of every image of the glTF file, images with the same bytes are only stored once.
+        std::vector<uint32_t>    image_indices_;
+    };
+
+    struct CookedPrimitive final {
+        static constexpr uint32_t no_image = UINT32_MAX;
+
+        Primitive::IndexFormat format_;
+        VertexFormat           vertex_format_;
+        // Only used by packed vertices.
+        PositionQuantization   quantization_;
+        math::Aabb             bounds_;
+        math::Vec4             base_color_factor_;
+        uint32_t               albedo_image_{no_image};
+        uint32_t               double_sided_{};
+        // Masked or blended, which doesn't hide what is behind it.
+        uint32_t               transparent_{};
+        uint32_t               lod_count_{};
+    };
+
+    // A primitive with its vertices, in the format its header names, and its indices.
+    struct PrimitiveToCook final {
+        using Vertices =
+                std::variant<std::vector<Vertex>, std::vector<PackedVertex>>;
+
+        CookedPrimitive           primitive_;
+        Vertices                  vertices_;
+        std::vector<Index>        indices_;
+        std::vector<PrimitiveLod> lods_;
+    };
+
+    struct MeshToCook final {
+        std::string                  name_;
+        std::vector<PrimitiveToCook> primitives_;
+    };
+
+    struct CookedNode final {
+        static constexpr uint32_t no_mesh = UINT32_MAX;
+
+        math::Vec3 translation_;
+        // x, y, z and w of the rotation quaternion.
+        math::Vec4 rotation_;
+        math::Vec3 scale_;
+        uint32_t   mesh_{no_mesh};
+    };
+
+    // Written by the asset cooker next to the scenes it cooked, so that they're found by their key.
+    struct CookedManifestEntry final {
+        Hash128               key_;
+        // Relative to the directory of the manifest.
+        std::filesystem::path cooked_path_;
+        // Relative to the assets directory the cooker was given.
+        std::filesystem::path source_path_;
+    };
+
+    constexpr std::string_view cooked_manifest_name{"manifest.txt"};
+
+    // Nullopt if the file doesn't exist or can't be queried.
+    [[nodiscard]]
+    std::optional<FileStamp> get_file_stamp(std::filesystem::path const &path);
+
+    void write_cooked_header(BlobWriter &writer, Hash128 const &key);
+
+    void write_cooked_dependencies(
+            BlobWriter &writer, std::span<CookedDependency const> dependencies
+    );
+
+    void write_cooked_images(BlobWriter &writer, CookedImages const &images);
+
+    void write_cooked_meshes(
+            BlobWriter &writer, std::span<MeshToCook const> meshes
+    );
+
+    // `children` has the indices of the child nodes of every node.
+    void write_cooked_nodes(
+            BlobWriter &writer, std::span<CookedNode const> nodes,
+            std::span<std::vector<uint32_t> const> children,
+            std::span<uint32_t const>              root_nodes
+    );
+
+    // Reads the header and the dependencies without checking the files. Returns nullopt if it isn't a cooked scene of
+    // this version with the key.
+    [[nodiscard]]
+    std::optional<std::vector<CookedDependency>>
+    read_cooked_prologue(BlobReader &reader, Hash128 const &key);
+
+    // Returns the cooked scene positioned at its images if it was cooked with the key from files that are still the
+    // same. Dependencies are relative to `directory`, only those whose stamp changed are hashed. The images and the
+    // geometry are validated, so that reading them afterwards doesn't fail halfway through creating the scene.
+    [[nodiscard]]
+    std::optional<BlobReader> open_cooked_scene(
+            SharedBytes const &bytes, Hash128 const &key,
+            std::filesystem::path const &directory
+    );
+
+    // Throws if an image is truncated, or its levels aren't a full mip chain within its bytes.
+    [[nodiscard]]
+    CookedImages read_cooked_images(BlobReader &reader);
+
+    // Walks the meshes and nodes without creating anything. Throws if they're truncated, if indices of a primitive or
+    // of its levels of detail refer to vertices it doesn't have, if they refer to images, meshes or nodes that don't
+    // exist, or if the nodes don't form a tree.
+    void validate_cooked_geometry(BlobReader geometry, std::size_t image_count);
+
+    // Empty if there is no manifest in the directory.
+    [[nodiscard]]
+    std::vector<CookedManifestEntry>
+    read_cooked_manifest(std::filesystem::path const &directory);
+
+    // Replaces the manifest atomically. Throws if it can't be written.
+    void write_cooked_manifest(
+            std::filesystem::path const         &directory,
+            std::span<CookedManifestEntry const> entries
+    );
+}// namespace engine
+
+#endif//COOKED_SCENE_H
@@ -0,0 +1,282 @@
+#include "cooked_scene_loader.h"
+
+#include <memory>
+#include <type_traits>
+
+#include "components/mesh_renderer.h"
+#include "components/occluder.h"
+#include "components/transform.h"
+#include "mesh_processing/index_splitting.h"
+#include "mesh_processing/simplification.h"
+#include "mesh_store.h"
+#include "scene.h"
+
+namespace engine {
+    namespace {
+        [[nodiscard]]
+        math::Vec3
+        get_position(Vertex const &vertex, PositionQuantization const &) {
+            return math::Vec3{vertex.x_, vertex.y_, vertex.z_};
+        }
+
+        [[nodiscard]]
+        math::Vec3 get_position(
+                PackedVertex const         &vertex,
+                PositionQuantization const &quantization
+        ) {
+            return quantization.dequantize({vertex.x_, vertex.y_, vertex.z_});
+        }
+
+        // Occluders only need to cover roughly the same pixels, so they're built from the coarsest level of detail.
+        // Primitives without levels, which includes strips, are simplified to a quarter of their triangles.
+        template<typename V>
+        void add_occluder_triangles(
+                OccluderMesh &occluder_mesh, CookedPrimitive const &primitive,
+                std::span<V const> vertices, std::span<Index const> indices,
+                std::span<PrimitiveLod const> lods
+        ) {
+            std::vector<math::Vec3> positions;
+            positions.reserve(vertices.size());
+            for (auto const &vertex : vertices) {
+                positions.push_back(
+                        get_position(vertex, primitive.quantization_)
+                );
+            }
+
+            std::vector<Index> triangles;
+            if (!lods.empty()) {
+                triangles = lods.back().indices_;
+            } else {
+                // Occluders are rasterized double-sided, the winding of strips doesn't matter.
+                auto const full_detail =
+                        primitive.format_ ==
+                                        Primitive::IndexFormat::TriangleStrip
+                                ? mesh_processing::strip_to_list(indices)
+                                : std::vector<Index>(
+                                          indices.begin(), indices.end()
+                                  );
+                auto simplified = mesh_processing::simplify(
+                        full_detail, positions, full_detail.size() / 4 / 3 * 3
+                );
+                triangles = std::move(simplified.indices_);
+            }
+
+            auto const base_vertex =
+                    static_cast<Index>(occluder_mesh.positions_.size());
+            for (auto const &position : positions) {
+                occluder_mesh.positions_.push_back(position);
+                occluder_mesh.bounds_.expand(position);
+            }
+            for (auto const index : triangles) {
+                occluder_mesh.indices_.push_back(base_vertex + index);
+            }
+        }
+
+        [[nodiscard]]
+        Primitive read_primitive(
+                BlobReader &reader, std::span<TextureHandle const> textures,
+                OccluderMesh *occluder_mesh_ptr, math::Aabb &mesh_bounds
+        ) {
+            auto const cooked = reader.read<CookedPrimitive>();
+
+            TextureIndices texture_indices{};
+            if (cooked.albedo_image_ != CookedPrimitive::no_image)
+                texture_indices.albedo_ = textures[cooked.albedo_image_];
+
+            auto const read_with = [&]<typename V>(std::type_identity<V>) {
+                auto const vertices = reader.read_span<V>();
+                auto const indices  = reader.read_span<Index>();
+
+                // Levels are concatenated after the full detail when they're uploaded, so they're copied.
+                std::vector<PrimitiveLod> lods;
+                lods.reserve(cooked.lod_count_);
+                for (uint32_t lod = 0; lod < cooked.lod_count_; ++lod) {
+                    auto const error       = reader.read<float>();
+                    auto const lod_indices = reader.read_span<Index>();
+                    lods.push_back(
+                            {{lod_indices.begin(), lod_indices.end()}, error}
+                    );
+                }
+
+                // Cut-out and blended surfaces can be seen through.
+                if (occluder_mesh_ptr && cooked.transparent_ == 0)
+                    add_occluder_triangles(
+                            *occluder_mesh_ptr, cooked, vertices, indices,
+                            std::span<PrimitiveLod const>{lods}
+                    );
+                mesh_bounds = mesh_bounds.merged(cooked.bounds_);
+
+                bool const double_sided = cooked.double_sided_ != 0;
+                if constexpr (std::is_same_v<V, PackedVertex>) {
+                    return Primitive{
+                            cooked.format_, vertices, cooked.quantization_,
+                            indices, cooked.bounds_, texture_indices,
+                            cooked.base_color_factor_, double_sided, lods
+                    };
+                } else {
+                    return Primitive{
+                            cooked.format_, vertices, indices, cooked.bounds_,
+                            texture_indices, cooked.base_color_factor_,
+                            double_sided, lods
+                    };
+                }
+            };
+
+            if (cooked.vertex_format_ == VertexFormat::Packed)
+                return read_with(std::type_identity<PackedVertex>{});
+
+            return read_with(std::type_identity<Vertex>{});
+        }
+
+        struct CookedMesh final {
+            MeshHandle                          mesh_;
+            // Null for meshes that don't occlude.
+            std::shared_ptr<OccluderMesh const> occluder_mesh_;
+        };
+
+        [[nodiscard]]
+        std::vector<CookedMesh> read_meshes(
+                BlobReader &reader, std::span<TextureHandle const> textures,
+                OccluderPredicate const &is_occluder
+        ) {
+            auto &mesh_store = MeshStore::get_instance();
+
+            auto const              mesh_count = reader.read<uint64_t>();
+            std::vector<CookedMesh> meshes;
+            for (uint64_t mesh_index = 0; mesh_index < mesh_count;
+                 ++mesh_index) {
+                auto const name            = reader.read_string();
+                auto const primitive_count = reader.read<uint64_t>();
+
+                // The predicate is given the bounds of the mesh, which are only known after its primitives are read,
+                // so the triangles are collected in case it picks the mesh.
+                OccluderMesh occluder_mesh;
+                auto         bounds = math::Aabb::empty();
+
+                std::vector<Primitive> primitives;
+                primitives.reserve(primitive_count);
+                for (uint64_t i = 0; i < primitive_count; ++i) {
+                    primitives.push_back(read_primitive(
+                            reader, textures,
+                            is_occluder ? &occluder_mesh : nullptr, bounds
+                    ));
+                }
+
+                std::shared_ptr<OccluderMesh const> occluder_mesh_ptr{};
+                if (is_occluder && is_occluder(name, bounds)) {
+                    occluder_mesh_ptr = std::make_shared<OccluderMesh>(
+                            std::move(occluder_mesh)
+                    );
+                }
+
+                meshes.push_back(
+                        {mesh_store.add_mesh(Mesh{std::move(primitives)}),
+                         std::move(occluder_mesh_ptr)}
+                );
+            }
+
+            return meshes;
+        }
+
+        struct NodeInstantiation final {
+            Scene                                 &scene_;
+            std::span<CookedNode const>            nodes_;
+            std::vector<std::span<uint32_t const>> children_;
+            std::span<CookedMesh const>            meshes_;
+
+            void
+            instantiate(uint32_t node_index, GameObject const *parent_ptr) {
+                auto const &node = nodes_[node_index];
+
+                auto obj = scene_.create_game_object();
+                if (parent_ptr) {
+                    obj.set_parent(*parent_ptr);
+                }
+
+                auto &transform = obj.add_component<Transform>();
+                transform.set_position(node.translation_);
+                transform.set_rotation(
+                        node.rotation_[0], node.rotation_[1],
+                        node.rotation_[2], node.rotation_[3]
+                );
+                transform.set_scale(node.scale_);
+
+                for (auto const child_index : children_[node_index]) {
+                    instantiate(child_index, &obj);
+                }
+
+                if (node.mesh_ == CookedNode::no_mesh)
+                    return;
+
+                auto const &mesh = meshes_[node.mesh_];
+                obj.add_component<MeshRenderer>(mesh.mesh_);
+
+                if (mesh.occluder_mesh_)
+                    obj.add_component<Occluder>(mesh.occluder_mesh_);
+            }
+        };
+    }// namespace
+
+    std::vector<TextureHandle>
+    load_cooked_images(BlobReader &reader, bool stream_textures) {
+        auto &texture_store = TextureStore::get_instance();
+
+        auto cooked = read_cooked_images(reader);
+
+        std::vector<TextureHandle> unique_textures;
+        unique_textures.reserve(cooked.images_.size());
+        for (auto &[name, hash, image] : cooked.images_) {
+            // Cooked scenes are mapped, so their textures can drop levels and read them from the mapping again.
+            image.mapped_ = true;
+            if (auto const handle = texture_store.find_texture(hash)) {
+                unique_textures.push_back(*handle);
+            } else if (stream_textures) {
+                // Nothing is left to decode, streaming only spreads the uploads over several frames.
+                unique_textures.push_back(texture_store.stream_texture(
+                        name,
+                        [image = std::move(image)](ThreadPool &) {
+                            return image;
+                        },
+                        hash
+                ));
+            } else {
+                unique_textures.push_back(texture_store.add_texture(
+                        name, Texture{std::move(image), name}, hash
+                ));
+            }
+        }
+
+        std::vector<TextureHandle> textures;
+        textures.reserve(cooked.image_indices_.size());
+        for (auto const unique_index : cooked.image_indices_) {
+            textures.push_back(unique_textures.at(unique_index));
+        }
+
+        return textures;
+    }
+
+    void instantiate_cooked_scene(
+            Scene &scene, BlobReader &geometry,
+            std::span<TextureHandle const> textures, GameObject *parent_ptr,
+            OccluderPredicate const &is_occluder
+    ) {
+        auto const meshes = read_meshes(geometry, textures, is_occluder);
+
+        auto const              node_count = geometry.read<uint64_t>();
+        std::vector<CookedNode> nodes;
+        nodes.reserve(node_count);
+        std::vector<std::span<uint32_t const>> children;
+        children.reserve(node_count);
+        for (uint64_t i = 0; i < node_count; ++i) {
+            nodes.push_back(geometry.read<CookedNode>());
+            children.push_back(geometry.read_span<uint32_t>());
+        }
+
+        NodeInstantiation instantiation{
+                scene, nodes, std::move(children), meshes
+        };
+        for (auto const root_node : geometry.read_span<uint32_t>()) {
+            instantiation.instantiate(root_node, parent_ptr);
+        }
+    }
+}// namespace engine
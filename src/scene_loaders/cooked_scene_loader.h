@@ -0,0 +1,31 @@
+#ifndef COOKED_SCENE_LOADER_H
+#define COOKED_SCENE_LOADER_H
+
+#include <span>
+#include <vector>
+
+#include "cooked_scene.h"
+#include "gltf_loader.h"
+#include "texture_store.h"
+
+namespace engine {
+    class GameObject;
+    class Scene;
+
+    // Creates or streams in the textures of the cooked images, textures with the same hash as one that is already
+    // loaded are shared. Returns the texture of every image of the glTF file.
+    [[nodiscard]]
+    std::vector<TextureHandle>
+    load_cooked_images(BlobReader &reader, bool stream_textures);
+
+    // Uploads the meshes of the cooked geometry and creates a game object per node, materials refer to images by
+    // their index in `textures`. Meshes the predicate picks get an Occluder built from a coarse level of detail of
+    // their opaque primitives.
+    void instantiate_cooked_scene(
+            Scene &scene, BlobReader &geometry,
+            std::span<TextureHandle const> textures, GameObject *parent_ptr,
+            OccluderPredicate const &is_occluder
+    );
+}// namespace engine
+
+#endif//COOKED_SCENE_LOADER_H
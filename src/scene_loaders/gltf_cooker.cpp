@@ -0,0 +1,807 @@
+#include "gltf_cooker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fastgltf/tools.hpp>
+#include <fastgltf/types.hpp>
+#include <format>
+#include <fstream>
+#include <magic_enum.hpp>
+#include <optional>
+#include <unordered_map>
+
+#include "cooked_scene.h"
+#include "graphics/mesh.h"
+#include "mesh_processing/index_splitting.h"
+#include "mesh_processing/mesh_optimizer.h"
+#include "mesh_processing/simplification.h"
+#include "misc/mapped_file.h"
+#include "types.h"
+
+namespace engine {
+    constexpr std::string_view pos_attr{"POSITION"};
+    constexpr std::string_view texcoord_color_attr{"TEXCOORD_0"};
+
+    template<typename F>
+    bool read_accessor(
+            fastgltf::Asset const &asset, fastgltf::Primitive const &primitive,
+            std::string_view attr, F &&callback
+    ) {
+        auto const it = primitive.findAttribute(attr);
+        if (it == primitive.attributes.end()) {
+            throw std::runtime_error{
+                    "Mesh primitive does not contain " + std::string{attr} +
+                    " attribute"
+            };
+        }
+
+        auto const &accessor = asset.accessors[it->accessorIndex];
+        if (!accessor.bufferViewIndex.has_value()) {
+            return false;
+        }
+
+        callback(accessor);
+
+        return true;
+    }
+
+    namespace gltf_mesh_loading {
+        static void read_vertices(
+                fastgltf::Asset const    &asset,
+                fastgltf::Accessor const &posAccessor,
+                std::vector<Vertex> &vertices, math::Aabb &bounds
+        ) {
+            vertices.resize(posAccessor.count);
+
+            int visited = 0;
+            fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
+                    asset, posAccessor,
+                    [&](fastgltf::math::fvec3 const &pos, std::size_t idx) {
+                        auto &vertex = vertices.at(idx);
+
+                        bounds.expand(math::Vec3{pos.x(), pos.y(), pos.z()});
+
+                        vertex.x_ = pos.x();
+                        vertex.y_ = pos.y();
+                        vertex.z_ = pos.z();
+
+                        vertex.u_ = 0;
+                        vertex.v_ = 0;
+                        ++visited;
+                    }
+            );
+        }
+
+        static void read_uvs(
+                fastgltf::Asset const    &asset,
+                fastgltf::Accessor const &accessor,
+                std::vector<Vertex>      &vertices
+        ) {
+            fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec2>(
+                    asset, accessor,
+                    [&](fastgltf::math::fvec2 const &tex_coord,
+                        std::size_t                  idx) {
+                        auto &vertex = vertices[idx];
+                        vertex.u_    = tex_coord.x();
+                        vertex.v_    = tex_coord.y();
+                    }
+            );
+        }
+
+        [[nodiscard]]
+        std::vector<PrimitiveLod> build_lods(
+                std::span<Vertex const> vertices,
+                std::span<Index const> indices, GltfLoadOptions const &options
+        ) {
+            std::vector<math::Vec3> positions;
+            positions.reserve(vertices.size());
+            for (auto const &vertex : vertices) {
+                positions.emplace_back(vertex.x_, vertex.y_, vertex.z_);
+            }
+
+            std::vector<PrimitiveLod> lods;
+            for (auto &simplified : mesh_processing::generate_lods(
+                         indices, positions, options.lod_count_
+                 )) {
+                if (options.optimize_meshes_) {
+                    simplified.indices_ =
+                            mesh_processing::optimize_vertex_cache(
+                                    simplified.indices_, vertices.size()
+                            );
+                }
+                lods.push_back(
+                        {std::move(simplified.indices_), simplified.error_}
+                );
+            }
+
+            return lods;
+        }
+
+        // Materials refer to images by their index in the asset.
+        [[nodiscard]]
+        MeshToCook cook_mesh(
+                fastgltf::Asset const &asset, fastgltf::Mesh const &gltf_mesh,
+                GltfLoadOptions const                   &options,
+                mesh_processing::MeshOptimizationReport &optimization_report
+        ) {
+            MeshToCook mesh{std::string{gltf_mesh.name}, {}};
+
+            for (auto const &primitive : gltf_mesh.primitives) {
+                if (!primitive.indicesAccessor.has_value()) {
+                    throw std::runtime_error{
+                            "Mesh primitive does not contain indices"
+                    };
+                }
+
+                std::vector<Vertex> vertices;
+                math::Aabb          bounds = math::Aabb::empty();
+                auto                result = read_accessor(
+                        asset, primitive, pos_attr,
+                        [&](fastgltf::Accessor const &pos_accessor) {
+                            read_vertices(
+                                    asset, pos_accessor, vertices, bounds
+                            );
+                        }
+                );
+                if (!result)
+                    continue;
+
+                result = read_accessor(
+                        asset, primitive, texcoord_color_attr,
+                        [&asset,
+                         &vertices](fastgltf::Accessor const &tex_accessor) {
+                            read_uvs(asset, tex_accessor, vertices);
+                        }
+                );
+                if (!result)
+                    continue;
+
+                math::Vec4 base_color_factor{1.0f, 1.0f, 1.0f, 1.0f};
+                uint32_t   albedo_image{CookedPrimitive::no_image};
+                // The default material of glTF is single sided and opaque.
+                bool       double_sided{false};
+                bool       transparent{false};
+                if (primitive.materialIndex.has_value()) {
+                    auto const &mat =
+                            asset.materials[primitive.materialIndex.value()];
+                    double_sided = mat.doubleSided;
+                    transparent  = mat.alphaMode != fastgltf::AlphaMode::Opaque;
+
+                    auto &albedo_texture_info = mat.pbrData.baseColorTexture;
+                    if (albedo_texture_info.has_value()) {
+                        auto &texture = asset.textures[albedo_texture_info
+                                                               ->textureIndex];
+                        if (texture.imageIndex.has_value())
+                            albedo_image = static_cast<uint32_t>(
+                                    texture.imageIndex.value()
+                            );
+                        base_color_factor = math::Vec4{
+                                mat.pbrData.baseColorFactor[0],
+                                mat.pbrData.baseColorFactor[1],
+                                mat.pbrData.baseColorFactor[2],
+                                mat.pbrData.baseColorFactor[3]
+                        };
+                    }
+                }
+
+                auto const &index_accessor =
+                        asset.accessors[primitive.indicesAccessor.value()];
+                if (!index_accessor.bufferViewIndex.has_value())
+                    throw std::runtime_error{
+                            "Mesh primitive indices accessor does not "
+                            "contain a buffer view"
+                    };
+                std::vector<Index> indices(index_accessor.count);
+
+                if (index_accessor.componentType !=
+                            fastgltf::ComponentType::UnsignedByte &&
+                    index_accessor.componentType !=
+                            fastgltf::ComponentType::UnsignedShort &&
+                    index_accessor.componentType !=
+                            fastgltf::ComponentType::UnsignedInt)
+                    throw std::runtime_error{std::format(
+                            "Mesh primitive indices accessor has unsupported "
+                            "component type: {}",
+                            magic_enum::enum_name(index_accessor.componentType)
+                    )};
+
+                fastgltf::copyFromAccessor<Index>(
+                        asset, index_accessor, indices.data()
+                );
+                auto primitive_type = [&primitive] {
+                    switch (primitive.type) {
+                        case fastgltf::PrimitiveType::Triangles:
+                            return Primitive::IndexFormat::TriangleList;
+                        case fastgltf::PrimitiveType::TriangleStrip:
+                            return Primitive::IndexFormat::TriangleStrip;
+                        default:
+                            throw std::runtime_error{std::format(
+                                    "Unsupported primitive type: {}",
+                                    static_cast<int>(primitive.type)
+                            )};
+                    }
+                }();
+
+                if (options.optimize_meshes_) {
+                    // Triangles are reordered, which only works on lists.
+                    if (primitive_type ==
+                        Primitive::IndexFormat::TriangleStrip) {
+                        indices = mesh_processing::strip_to_list(indices);
+                        primitive_type = Primitive::IndexFormat::TriangleList;
+                    }
+
+                    optimization_report += mesh_processing::optimize_mesh(
+                            vertices, indices,
+                            [](Vertex const &vertex) {
+                                return math::Vec3{
+                                        vertex.x_, vertex.y_, vertex.z_
+                                };
+                            }
+                    );
+                }
+
+                auto const add_primitive =
+                        [&](Primitive::IndexFormat format,
+                            std::span<Vertex const> primitive_vertices,
+                            std::span<Index const>  primitive_indices,
+                            math::Aabb const       &primitive_bounds) {
+                            // Simplification only works on lists, strips keep a single level.
+                            std::vector<PrimitiveLod> lods;
+                            if (options.lod_count_ > 0 &&
+                                format == Primitive::IndexFormat::TriangleList)
+                                lods = build_lods(
+                                        primitive_vertices, primitive_indices,
+                                        options
+                                );
+
+                            PrimitiveToCook cooked{};
+                            auto           &header    = cooked.primitive_;
+                            header.format_            = format;
+                            header.bounds_            = primitive_bounds;
+                            header.base_color_factor_ = base_color_factor;
+                            header.albedo_image_      = albedo_image;
+                            header.double_sided_      = double_sided ? 1 : 0;
+                            header.transparent_       = transparent ? 1 : 0;
+                            cooked.indices_           = std::vector<Index>(
+                                    primitive_indices.begin(),
+                                    primitive_indices.end()
+                            );
+                            cooked.lods_ = std::move(lods);
+
+                            if (options.vertex_format_ ==
+                                VertexFormat::Packed) {
+                                auto const quantization =
+                                        PositionQuantization::from_bounds(
+                                                primitive_bounds
+                                        );
+
+                                header.quantization_ = quantization;
+                                cooked.vertices_     = pack_vertices(
+                                        primitive_vertices, quantization
+                                );
+                            } else {
+                                cooked.vertices_ = std::vector<Vertex>(
+                                        primitive_vertices.begin(),
+                                        primitive_vertices.end()
+                                );
+                            }
+
+                            mesh.primitives_.push_back(std::move(cooked));
+                        };
+
+                if (!options.split_for_16_bit_indices_ ||
+                    mesh_processing::fits_16_bit(indices)) {
+                    add_primitive(primitive_type, vertices, indices, bounds);
+                    continue;
+                }
+
+                // Split primitives are always lists, strips can't be cut at arbitrary triangles.
+                auto const triangle_list =
+                        primitive_type == Primitive::IndexFormat::TriangleStrip
+                                ? mesh_processing::strip_to_list(indices)
+                                : indices;
+
+                for (auto const &subset : mesh_processing::split_triangle_list(
+                             triangle_list, vertices.size()
+                     )) {
+                    std::vector<Vertex> subset_vertices;
+                    subset_vertices.reserve(subset.vertex_remap_.size());
+                    auto subset_bounds = math::Aabb::empty();
+
+                    for (uint32_t const vertex_index : subset.vertex_remap_) {
+                        auto const &vertex = vertices[vertex_index];
+                        subset_vertices.push_back(vertex);
+                        subset_bounds.expand(
+                                math::Vec3{vertex.x_, vertex.y_, vertex.z_}
+                        );
+                    }
+
+                    add_primitive(
+                            Primitive::IndexFormat::TriangleList,
+                            subset_vertices, subset.indices_, subset_bounds
+                    );
+                }
+            }
+
+            return mesh;
+        }
+    };// namespace gltf_mesh_loading
+
+    // Bytes of data that fastgltf loaded into memory. GLB and embedded buffers always are, external ones because
+    // LoadExternalBuffers is set.
+    [[nodiscard]]
+    std::span<stbi_uc const> get_loaded_bytes(fastgltf::DataSource const &data
+    ) {
+        return std::visit(
+                fastgltf::visitor{
+                        [](auto const &) -> std::span<stbi_uc const> {
+                            throw std::runtime_error{"Unhandled data source"};
+                        },
+                        [](fastgltf::sources::Array const &array) {
+                            return std::span{
+                                    reinterpret_cast<stbi_uc const *>(
+                                            array.bytes.data()
+                                    ),
+                                    array.bytes.size()
+                            };
+                        },
+                        [](fastgltf::sources::Vector const &vector) {
+                            return std::span{
+                                    reinterpret_cast<stbi_uc const *>(
+                                            vector.bytes.data()
+                                    ),
+                                    vector.bytes.size()
+                            };
+                        },
+                        [](fastgltf::sources::ByteView const &view) {
+                            return std::span{
+                                    reinterpret_cast<stbi_uc const *>(
+                                            view.bytes.data()
+                                    ),
+                                    view.bytes.size()
+                            };
+                        }
+                },
+                data
+        );
+    }
+
+    std::span<stbi_uc const> get_embedded_image(
+            fastgltf::Asset const &asset, fastgltf::DataSource const &data
+    ) {
+        if (auto const *view_ptr =
+                    std::get_if<fastgltf::sources::BufferView>(&data)) {
+            auto const &buffer_view =
+                    asset.bufferViews[view_ptr->bufferViewIndex];
+
+            return get_loaded_bytes(asset.buffers[buffer_view.bufferIndex].data)
+                    .subspan(buffer_view.byteOffset, buffer_view.byteLength);
+        }
+
+        return get_loaded_bytes(data);
+    }
+
+    DecodedImage decode_image(
+            fastgltf::Asset const &asset, fastgltf::DataSource const &data,
+            std::filesystem::path const &cwd, bool compress
+    ) {
+        if (auto const *file_path_ptr =
+                    std::get_if<fastgltf::sources::URI>(&data)) {
+            auto const path = cwd / file_path_ptr->uri.string();
+            if (!compress)
+                return DecodedImage::from_file(path);
+
+            return compress_image(map_file(path).bytes_);
+        }
+
+        auto const image = get_embedded_image(asset, data);
+
+        return compress ? compress_image(image)
+                        : DecodedImage::from_memory(image);
+    }
+
+    Hash128 hash_image(
+            fastgltf::Asset const &asset, fastgltf::DataSource const &data,
+            std::filesystem::path const &cwd
+    ) {
+        if (auto const *file_path_ptr =
+                    std::get_if<fastgltf::sources::URI>(&data)) {
+            return hash_bytes(
+                    map_file(cwd / file_path_ptr->uri.string()).bytes_
+            );
+        }
+
+        return hash_bytes(get_embedded_image(asset, data));
+    }
+
+    // Lets fastgltf parse a mapped file. Reads that need padding point into the mapping while enough of the file
+    // follows them, only reads at its end are copied into a padded buffer.
+    class MappedGltfData final : public fastgltf::GltfDataGetter {
+        SharedBytes            file_;
+        std::size_t            offset_{};
+        std::vector<std::byte> padded_;
+
+        // Advances past `count` bytes and returns where they start.
+        [[nodiscard]]
+        uint8_t const *take(std::size_t count) {
+            if (count > file_.bytes_.size() - offset_)
+                throw std::runtime_error{"Unexpected end of glTF file"};
+
+            auto const *bytes_ptr = file_.bytes_.data() + offset_;
+            offset_ += count;
+
+            return bytes_ptr;
+        }
+
+    public:
+        explicit MappedGltfData(SharedBytes file)
+            : file_{std::move(file)} {
+        }
+
+        void read(void *ptr, std::size_t count) override {
+            std::memcpy(ptr, take(count), count);
+        }
+
+        fastgltf::span<std::byte>
+        read(std::size_t count, std::size_t padding) override {
+            auto const *bytes_ptr = take(count);
+            if (offset_ + padding <= file_.bytes_.size()) {
+                // Only ever read, mappings are read-only.
+                return fastgltf::span<std::byte>{
+                        reinterpret_cast<std::byte *>(
+                                const_cast<uint8_t *>(bytes_ptr)
+                        ),
+                        count
+                };
+            }
+
+            padded_.assign(count + padding, std::byte{0});
+            std::memcpy(padded_.data(), bytes_ptr, count);
+
+            return fastgltf::span<std::byte>{padded_.data(), count};
+        }
+
+        void reset() override {
+            offset_ = 0;
+        }
+
+        std::size_t bytesRead() override {
+            return offset_;
+        }
+
+        std::size_t totalSize() override {
+            return file_.bytes_.size();
+        }
+    };
+
+    fastgltf::Asset parse_gltf(
+            SharedBytes const &file, std::filesystem::path const &cwd,
+            fastgltf::Options options
+    ) {
+        MappedGltfData data{file};
+
+        fastgltf::Parser parser;
+        auto             loaded_asset = parser.loadGltf(data, cwd, options);
+        if (loaded_asset.error() != fastgltf::Error::None) {
+            throw std::runtime_error{
+                    "Failed to load glTF file: " +
+                    std::string{fastgltf::getErrorName(loaded_asset.error())}
+            };
+        }
+
+        return std::move(loaded_asset.get());
+    }
+
+    void cook_geometry(
+            BlobWriter &writer, fastgltf::Asset const &asset,
+            GltfLoadOptions const &options
+    ) {
+        using Report = mesh_processing::MeshOptimizationReport;
+
+        std::size_t const       mesh_count = asset.meshes.size();
+        std::vector<MeshToCook> meshes(mesh_count);
+        std::vector<Report>     reports(mesh_count);
+        for_each_parallel(mesh_count, [&](std::size_t index) {
+            meshes[index] = gltf_mesh_loading::cook_mesh(
+                    asset, asset.meshes[index], options, reports[index]
+            );
+        });
+
+        // Reported in order and on the calling thread.
+        if (options.optimize_meshes_ && options.report_optimization_) {
+            for (std::size_t index = 0; index < mesh_count; ++index) {
+                options.report_optimization_(
+                        asset.meshes[index].name, reports[index]
+                );
+            }
+        }
+
+        write_cooked_meshes(writer, meshes);
+
+        std::vector<CookedNode>            nodes;
+        std::vector<std::vector<uint32_t>> children;
+        nodes.reserve(asset.nodes.size());
+        children.reserve(asset.nodes.size());
+        for (auto const &node : asset.nodes) {
+            auto const &[translation, rotation, scale] =
+                    std::get<fastgltf::TRS>(node.transform);
+
+            nodes.push_back(
+                    {math::Vec3{
+                             translation.x(), translation.y(), translation.z()
+                     },
+                     math::Vec4{
+                             rotation.x(), rotation.y(), rotation.z(),
+                             rotation.w()
+                     },
+                     math::Vec3{scale.x(), scale.y(), scale.z()},
+                     node.meshIndex.has_value()
+                             ? static_cast<uint32_t>(node.meshIndex.value())
+                             : CookedNode::no_mesh}
+            );
+
+            auto &node_children = children.emplace_back();
+            for (auto const child_index : node.children) {
+                node_children.push_back(static_cast<uint32_t>(child_index));
+            }
+        }
+
+        std::vector<uint32_t> root_nodes;
+        for (auto const node_index :
+             asset.scenes[asset.defaultScene.value_or(0)].nodeIndices) {
+            root_nodes.push_back(static_cast<uint32_t>(node_index));
+        }
+
+        write_cooked_nodes(writer, nodes, children, root_nodes);
+    }
+
+    // External buffers and images of the glTF file, relative to its directory. A file that is used as both is only
+    // listed as a buffer.
+    [[nodiscard]]
+    std::vector<CookedDependency> get_dependencies(
+            SharedBytes const &file, std::filesystem::path const &cwd
+    ) {
+        // Parsed again without loading buffers, which replaces their URIs.
+        auto const asset = parse_gltf(file, cwd, gltf_parse_options);
+
+        std::vector<CookedDependency> dependencies;
+        auto const add_dependency = [&](fastgltf::DataSource const &data,
+                                        CookedDependencyKind        kind) {
+            auto const *file_path_ptr =
+                    std::get_if<fastgltf::sources::URI>(&data);
+            if (!file_path_ptr)
+                return;
+
+            std::filesystem::path path{file_path_ptr->uri.string()};
+            if (std::ranges::none_of(dependencies, [&](auto const &dependency) {
+                    return dependency.path_ == path;
+                }))
+                dependencies.push_back({std::move(path), kind, {}});
+        };
+        for (auto const &buffer : asset.buffers) {
+            add_dependency(buffer.data, CookedDependencyKind::Buffer);
+        }
+        for (auto const &image : asset.images) {
+            add_dependency(image.data, CookedDependencyKind::Image);
+        }
+
+        // The stamp is taken first, so that a file that changes while it's hashed is hashed again next time.
+        for_each_parallel(dependencies.size(), [&](std::size_t index) {
+            auto      &dependency = dependencies[index];
+            auto const path       = cwd / dependency.path_;
+            dependency.stamp_     = get_file_stamp(path).value_or(FileStamp{});
+            dependency.hash_      = hash_bytes(map_file(path).bytes_);
+        });
+
+        return dependencies;
+    }
+
+    Hash128
+    get_cache_key(Hash128 const &file_hash, GltfLoadOptions const &options) {
+        BlobWriter writer;
+        writer.write(file_hash);
+        writer.write(options.vertex_format_);
+        writer.write(options.split_for_16_bit_indices_);
+        writer.write(options.optimize_meshes_);
+        writer.write(static_cast<uint64_t>(options.lod_count_));
+        writer.write(options.compress_textures_);
+
+        return hash_bytes(writer.take());
+    }
+
+    // What a cooked scene with the same key contributes to cooking it again after some of its files changed.
+    struct PreviousCook final {
+        std::vector<CookedDependency>                            dependencies_;
+        std::unordered_map<Hash128, DecodedImage, Hash128Hasher> images_;
+        std::optional<BlobReader>                                geometry_;
+    };
+
+    [[nodiscard]]
+    PreviousCook
+    read_previous_cook(SharedBytes const &bytes, Hash128 const &key) {
+        if (bytes.bytes_.empty())
+            return {};
+
+        // A damaged file contributes nothing.
+        try {
+            BlobReader reader{bytes};
+
+            auto dependencies = read_cooked_prologue(reader, key);
+            if (!dependencies)
+                return {};
+
+            auto         images = read_cooked_images(reader);
+            PreviousCook previous{
+                    std::move(*dependencies), {}, reader.read_blob()
+            };
+            for (auto &image : images.images_) {
+                previous.images_.emplace(image.hash_, std::move(image.image_));
+            }
+
+            return previous;
+        } catch (std::exception const &) {
+            return {};
+        }
+    }
+
+    // The key covers the glTF file, so the geometry only changes with the buffers.
+    [[nodiscard]]
+    bool can_reuse_geometry(
+            PreviousCook const                 &previous,
+            std::span<CookedDependency const> dependencies
+    ) {
+        if (!previous.geometry_)
+            return false;
+
+        return std::ranges::all_of(dependencies, [&](auto const &dependency) {
+            return dependency.kind_ != CookedDependencyKind::Buffer ||
+                   std::ranges::any_of(
+                           previous.dependencies_,
+                           [&](auto const &previous_dependency) {
+                               return previous_dependency.path_ ==
+                                              dependency.path_ &&
+                                      previous_dependency.hash_ ==
+                                              dependency.hash_;
+                           }
+                   );
+        });
+    }
+
+    // Decodes every distinct image on the thread pool, compressed if the options ask for it. Images with the same
+    // bytes as one of the previous cook reuse it instead.
+    [[nodiscard]]
+    CookedImages cook_images(
+            fastgltf::Asset const &asset, std::filesystem::path const &cwd,
+            GltfLoadOptions const &options, PreviousCook const &previous
+    ) {
+        std::size_t const    image_count = asset.images.size();
+        std::vector<Hash128> hashes(image_count);
+        for_each_parallel(image_count, [&](std::size_t index) {
+            hashes[index] = hash_image(asset, asset.images[index].data, cwd);
+        });
+
+        CookedImages cooked;
+        cooked.image_indices_.resize(image_count);
+        // The first image with each hash is the one that's decoded.
+        std::vector<std::size_t> source_indices;
+        std::unordered_map<Hash128, uint32_t, Hash128Hasher> unique_indices;
+        for (std::size_t index = 0; index < image_count; ++index) {
+            auto const [it, inserted] = unique_indices.emplace(
+                    hashes[index], static_cast<uint32_t>(source_indices.size())
+            );
+            if (inserted) {
+                cooked.images_.push_back(
+                        {std::string{asset.images[index].name}, hashes[index],
+                         {}}
+                );
+                source_indices.push_back(index);
+            }
+            cooked.image_indices_[index] = it->second;
+        }
+
+        for_each_parallel(cooked.images_.size(), [&](std::size_t i) {
+            auto &image = cooked.images_[i];
+            if (auto const it = previous.images_.find(image.hash_);
+                it != previous.images_.end()) {
+                image.image_ = it->second;
+                return;
+            }
+
+            image.image_ = decode_image(
+                    asset, asset.images[source_indices[i]].data, cwd,
+                    options.compress_textures_
+            );
+        });
+
+        return cooked;
+    }
+
+    // The file is written under another name first, so that a partially written one is never loaded.
+    [[nodiscard]]
+    bool write_cooked_file(
+            std::filesystem::path const &cooked_path,
+            std::span<uint8_t const>     bytes
+    ) {
+        std::error_code error;
+        std::filesystem::create_directories(cooked_path.parent_path(), error);
+
+        auto temporary_path = cooked_path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream file{
+                    temporary_path, std::ios::binary | std::ios::trunc
+            };
+            file.write(
+                    reinterpret_cast<char const *>(bytes.data()),
+                    static_cast<std::streamsize>(bytes.size())
+            );
+            if (!file)
+                return false;
+        }
+
+        std::filesystem::rename(temporary_path, cooked_path, error);
+
+        return !error;
+    }
+
+    // Cooks the whole scene, images included.
+    [[nodiscard]]
+    std::vector<uint8_t> cook_scene(
+            SharedBytes const &file, std::filesystem::path const &cwd,
+            Hash128 const &key, GltfLoadOptions const &options,
+            PreviousCook const &previous
+    ) {
+        // External images stay paths, they're decoded, or compressed, from their files.
+        auto const asset        = parse_gltf(file, cwd, gltf_options);
+        auto const dependencies = get_dependencies(file, cwd);
+
+        BlobWriter writer;
+        write_cooked_header(writer, key);
+        write_cooked_dependencies(writer, dependencies);
+        write_cooked_images(
+                writer, cook_images(asset, cwd, options, previous)
+        );
+
+        if (can_reuse_geometry(previous, dependencies)) {
+            writer.write_blob(previous.geometry_->get_bytes().bytes_);
+        } else {
+            BlobWriter geometry;
+            cook_geometry(geometry, asset, options);
+            writer.write_blob(geometry.take());
+        }
+
+        return writer.take();
+    }
+
+    CookedSceneFile cook_gltf_scene(
+            std::filesystem::path const &scene_file_path,
+            std::filesystem::path const &cooked_path,
+            GltfLoadOptions const       &options
+    ) {
+        auto const cwd  = scene_file_path.parent_path();
+        auto const file = map_file(scene_file_path);
+        auto const key  = get_cache_key(hash_bytes(file.bytes_), options);
+
+        std::vector<uint8_t> bytes;
+        {
+            // Released before the file is replaced, which fails on some platforms while it's mapped.
+            SharedBytes previous_bytes{};
+            if (std::filesystem::exists(cooked_path)) {
+                previous_bytes = map_file(cooked_path);
+                if (open_cooked_scene(previous_bytes, key, cwd))
+                    return {previous_bytes, key, CookStatus::UpToDate};
+            }
+
+            bytes = cook_scene(
+                    file, cwd, key, options,
+                    read_previous_cook(previous_bytes, key)
+            );
+        }
+
+        if (write_cooked_file(cooked_path, bytes))
+            return {map_file(cooked_path), key, CookStatus::Cooked};
+
+        return {SharedBytes::from_vector(std::move(bytes)), key,
+                CookStatus::NotWritten};
+    }
+}// namespace engine
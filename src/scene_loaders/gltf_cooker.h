@@ -0,0 +1,117 @@
+#ifndef GLTF_COOKER_H
+#define GLTF_COOKER_H
+
+#include <cstddef>
+#include <exception>
+#include <fastgltf/core.hpp>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "gltf_loader.h"
+#include "graphics/texture.h"
+#include "misc/blob.h"
+#include "misc/hash.h"
+#include "misc/shared_bytes.h"
+#include "misc/thread_pool.h"
+
+namespace engine {
+    constexpr fastgltf::Options gltf_parse_options{
+            fastgltf::Options::DecomposeNodeMatrices |
+            fastgltf::Options::DontRequireValidAssetMember |
+            fastgltf::Options::AllowDouble |
+            fastgltf::Options::GenerateMeshIndices
+    };
+
+    constexpr fastgltf::Options gltf_options{
+            gltf_parse_options | fastgltf::Options::LoadExternalBuffers
+    };
+
+    enum class CookStatus {
+        UpToDate,
+        Cooked,
+        // Cooked, but the file couldn't be written.
+        NotWritten,
+    };
+
+    struct CookedSceneFile final {
+        // Mapped from the cooked file, or kept in memory if it couldn't be written.
+        SharedBytes bytes_;
+        Hash128     key_;
+        CookStatus  status_;
+    };
+
+    // Runs the task for every index on the thread pool and rethrows the error of the first index that failed.
+    template<typename F>
+    void for_each_parallel(std::size_t count, F &&task) {
+        std::vector<std::exception_ptr> errors(count);
+
+        ThreadPool::get_instance().parallel_for(
+                count,
+                [&](std::size_t index) {
+                    try {
+                        task(index);
+                    } catch (...) {
+                        errors[index] = std::current_exception();
+                    }
+                }
+        );
+
+        for (auto const &error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+    // GLB files are parsed straight from the mapping, their binary chunk is the only part that's copied.
+    [[nodiscard]]
+    fastgltf::Asset parse_gltf(
+            SharedBytes const &file, std::filesystem::path const &cwd,
+            fastgltf::Options options
+    );
+
+    // Bytes of an image stored in the glTF file or in one of its buffers, which is where GLB files keep their images.
+    // Points into the asset, nothing is copied.
+    [[nodiscard]]
+    std::span<stbi_uc const> get_embedded_image(
+            fastgltf::Asset const &asset, fastgltf::DataSource const &data
+    );
+
+    // Only reads the asset, so images can be decoded in parallel. Compressed images are kept in memory, nothing is
+    // written next to the source images.
+    [[nodiscard]]
+    DecodedImage decode_image(
+            fastgltf::Asset const &asset, fastgltf::DataSource const &data,
+            std::filesystem::path const &cwd, bool compress
+    );
+
+    // Hash of the bytes the image is decoded from, external images are mapped to hash them.
+    [[nodiscard]]
+    Hash128 hash_image(
+            fastgltf::Asset const &asset, fastgltf::DataSource const &data,
+            std::filesystem::path const &cwd
+    );
+
+    // Processes the meshes on the thread pool and writes them, followed by the node hierarchy of the default scene.
+    void cook_geometry(
+            BlobWriter &writer, fastgltf::Asset const &asset,
+            GltfLoadOptions const &options
+    );
+
+    // Everything that changes what a scene cooks to: the glTF file and the options that affect its processing.
+    [[nodiscard]]
+    Hash128
+    get_cache_key(Hash128 const &file_hash, GltfLoadOptions const &options);
+
+    // Cooks the scene into `cooked_path` unless the scene there was cooked with the same options from files that are
+    // still the same. If it's outdated, its images and geometry are reused where the files they were made from didn't
+    // change, so that changing one image only decodes that image again.
+    [[nodiscard]]
+    CookedSceneFile cook_gltf_scene(
+            std::filesystem::path const &scene_file_path,
+            std::filesystem::path const &cooked_path,
+            GltfLoadOptions const       &options
+    );
+}// namespace engine
+
+#endif//GLTF_COOKER_H
@@ -1,358 +1,217 @@
 #include "gltf_loader.h"
 
+#include <algorithm>
 #include <fastgltf/core.hpp>
-#include <fastgltf/tools.hpp>
-#include <fastgltf/types.hpp>
 #include <format>
-#include <magic_enum.hpp>
-#include <span>
-
-#include "components/mesh_renderer.h"
-#include "components/transform.h"
-#include "graphics/mesh.h"
-#include "scene.h"
-#include "types.h"
+#include <memory>
+#include <optional>
+#include <unordered_set>
+
+#include "cooked_scene.h"
+#include "cooked_scene_loader.h"
+#include "gltf_cooker.h"
+#include "misc/blob.h"
+#include "misc/hash.h"
+#include "misc/mapped_file.h"
+#include "misc/shared_bytes.h"
+#include "texture_store.h"
 
 namespace engine {
-    constexpr std::string_view pos_attr{"POSITION"};
-    constexpr std::string_view texcoord_color_attr{"TEXCOORD_0"};
-
-    template<typename F>
-    bool read_accessor(
-            fastgltf::Asset const &asset, fastgltf::Primitive const &primitive,
-            std::string_view attr, F &&callback
+    // The decoder runs after loading returns, so it owns everything it needs. Embedded images keep the asset alive
+    // until they're decoded instead of being copied.
+    [[nodiscard]]
+    TextureStore::Decoder get_streamed_decoder(
+            std::shared_ptr<fastgltf::Asset const> const &asset,
+            fastgltf::DataSource const &data, std::filesystem::path const &cwd
     ) {
-        auto const it = primitive.findAttribute(attr);
-        if (it == primitive.attributes.end()) {
-            throw std::runtime_error{
-                    "Mesh primitive does not contain " + std::string{attr} +
-                    " attribute"
-            };
-        }
-
-        auto const &accessor = asset.accessors[it->accessorIndex];
-        if (!accessor.bufferViewIndex.has_value()) {
-            return false;
+        if (auto const *file_path_ptr =
+                    std::get_if<fastgltf::sources::URI>(&data)) {
+            return [path = cwd / file_path_ptr->uri.string()](
+                           ThreadPool &thread_pool
+                   ) { return DecodedImage::from_file(path, thread_pool); };
         }
 
-        callback(accessor);
-
-        return true;
+        return [image = SharedBytes{asset, get_embedded_image(*asset, data)}](
+                       ThreadPool &thread_pool
+               ) {
+            return DecodedImage::from_memory(image.bytes_, thread_pool);
+        };
     }
 
-    namespace gltf_mesh_loading {
-        static void read_vertices(
-                fastgltf::Asset const    &asset,
-                fastgltf::Accessor const &posAccessor,
-                std::vector<Vertex> &vertices, math::Vec3 &min_pos,
-                math::Vec3 &max_pos
-        ) {
-            vertices.resize(posAccessor.count);
-
-            int visited = 0;
-            fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
-                    asset, posAccessor,
-                    [&](fastgltf::math::fvec3 const &pos, std::size_t idx) {
-                        auto &vertex = vertices.at(idx);
+    // Streamed images are keyed by the file they come from instead of by their bytes, which would have to be read on
+    // the loading thread. Embedded images are keyed by the scene file and their index. The size and modification time
+    // of the file are part of the key, so that a file that changed gets a texture of its own.
+    [[nodiscard]]
+    Hash128 get_streamed_image_key(
+            fastgltf::DataSource const  &data,
+            std::filesystem::path const &scene_file_path, std::size_t index
+    ) {
+        auto const *file_path_ptr = std::get_if<fastgltf::sources::URI>(&data);
+        auto        path          = scene_file_path;
+        if (file_path_ptr != nullptr)
+            path = scene_file_path.parent_path() / file_path_ptr->uri.string();
+
+        // A missing file only fails once it's decoded, like any other image that can't be read.
+        std::error_code error;
+        auto const      size = std::filesystem::file_size(path, error);
+        auto const      time = std::filesystem::last_write_time(path, error);
+
+        auto key = std::format(
+                "{}|{}|{}",
+                std::filesystem::absolute(path, error)
+                        .lexically_normal()
+                        .string(),
+                size, time.time_since_epoch().count()
+        );
+        if (file_path_ptr == nullptr)
+            key += std::format("|{}", index);
 
-                        if (pos.x() < min_pos.get_x())
-                            min_pos.set_x(pos.x());
-                        if (pos.y() < min_pos.get_y())
-                            min_pos.set_y(pos.y());
-                        if (pos.z() < min_pos.get_z())
-                            min_pos.set_z(pos.z());
-                        if (pos.x() > max_pos.get_x())
-                            max_pos.set_x(pos.x());
-                        if (pos.y() > max_pos.get_y())
-                            max_pos.set_y(pos.y());
-                        if (pos.z() > max_pos.get_z())
-                            max_pos.set_z(pos.z());
+        return hash_bytes(std::span{
+                reinterpret_cast<uint8_t const *>(key.data()), key.size()
+        });
+    }
 
-                        vertex.x_ = pos.x();
-                        vertex.y_ = pos.y();
-                        vertex.z_ = pos.z();
+    // Images whose bytes were loaded before, by this asset or another one, share the texture that is already there.
+    // Streamed images are keyed by their file instead and stream in, the others are hashed and decoded on the thread
+    // pool before their textures are created here. Returns the texture of every image.
+    [[nodiscard]]
+    std::vector<TextureHandle> load_images(
+            std::shared_ptr<fastgltf::Asset const> const &asset_ptr,
+            std::filesystem::path const &scene_file_path,
+            GltfLoadOptions const       &options
+    ) {
+        auto const &asset         = *asset_ptr;
+        auto       &texture_store = TextureStore::get_instance();
+        auto const  cwd           = scene_file_path.parent_path();
+
+        std::size_t const          image_count = asset.images.size();
+        std::vector<Hash128>       hashes(image_count);
+        std::vector<TextureHandle> textures(image_count);
+
+        if (options.stream_textures_) {
+            for (std::size_t index = 0; index < image_count; ++index) {
+                auto const &image = asset.images[index];
+                textures[index]   = texture_store.stream_texture(
+                        std::string{image.name},
+                        get_streamed_decoder(asset_ptr, image.data, cwd),
+                        get_streamed_image_key(
+                                image.data, scene_file_path, index
+                        )
+                );
+            }
 
-                        vertex.u_ = 0;
-                        vertex.v_ = 0;
-                        ++visited;
-                    }
-            );
+            return textures;
         }
 
-        static void read_uvs(
-                fastgltf::Asset const    &asset,
-                fastgltf::Accessor const &accessor,
-                std::vector<Vertex>      &vertices
-        ) {
-            fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec2>(
-                    asset, accessor,
-                    [&](fastgltf::math::fvec2 const &tex_coord,
-                        std::size_t                  idx) {
-                        auto &vertex = vertices[idx];
-                        vertex.u_    = tex_coord.x();
-                        vertex.v_    = tex_coord.y();
-                    }
-            );
+        for_each_parallel(image_count, [&](std::size_t index) {
+            hashes[index] = hash_image(asset, asset.images[index].data, cwd);
+        });
+
+        // Images that are decoded, one per hash that isn't loaded yet.
+        std::vector<std::size_t>                   decoded_indices;
+        std::unordered_set<Hash128, Hash128Hasher> decoded_hashes;
+        for (std::size_t index = 0; index < image_count; ++index) {
+            if (auto const handle = texture_store.find_texture(hashes[index]))
+                textures[index] = *handle;
+            else if (decoded_hashes.insert(hashes[index]).second)
+                decoded_indices.push_back(index);
         }
 
-        [[nodiscard]]
-        Mesh load_mesh(
-                fastgltf::Asset const &asset, fastgltf::Mesh const &gltf_mesh
-        ) {
-            Mesh mesh{{}};
-
-            for (auto const &primitive : gltf_mesh.primitives) {
-                if (!primitive.indicesAccessor.has_value()) {
-                    throw std::runtime_error{
-                            "Mesh primitive does not contain indices"
-                    };
-                }
-
-                std::vector<Vertex> vertices;
-                auto const          lowest_float = {
-                        std::numeric_limits<float>::lowest()
-                };
-                math::Vec3 min_pos, max_pos{};
-                auto       result = read_accessor(
-                        asset, primitive, pos_attr,
-                        [&](fastgltf::Accessor const &pos_accessor) {
-                            read_vertices(
-                                    asset, pos_accessor, vertices, min_pos,
-                                    max_pos
-                            );
-                        }
-                );
-                if (!result)
-                    continue;
-
-                result = read_accessor(
-                        asset, primitive, texcoord_color_attr,
-                        [&asset,
-                         &vertices](fastgltf::Accessor const &tex_accessor) {
-                            read_uvs(asset, tex_accessor, vertices);
-                        }
-                );
-                if (!result)
-                    continue;
-
-                math::Vec4     base_color_factor{1.0f, 1.0f, 1.0f, 1.0f};
-                TextureIndices texture_indices{};
-                if (primitive.materialIndex.has_value()) {
-                    auto const &mat =
-                            asset.materials[primitive.materialIndex.value()];
-
-                    auto &albedo_texture_info = mat.pbrData.baseColorTexture;
-                    if (albedo_texture_info.has_value()) {
-                        auto &texture = asset.textures[albedo_texture_info
-                                                               ->textureIndex];
-                        if (texture.imageIndex.has_value())
-                            texture_indices.albedo_ =
-                                    TextureHandle{texture.imageIndex.value()};
-                        base_color_factor = math::Vec4{
-                                mat.pbrData.baseColorFactor[0],
-                                mat.pbrData.baseColorFactor[1],
-                                mat.pbrData.baseColorFactor[2],
-                                mat.pbrData.baseColorFactor[3]
-                        };
-                    }
-                }
-
-                auto const &index_accessor =
-                        asset.accessors[primitive.indicesAccessor.value()];
-                if (!index_accessor.bufferViewIndex.has_value())
-                    throw std::runtime_error{
-                            "Mesh primitive indices accessor does not "
-                            "contain a buffer view"
-                    };
-                std::vector<Index> indices(index_accessor.count);
-
-                if (index_accessor.componentType !=
-                            fastgltf::ComponentType::UnsignedByte &&
-                    index_accessor.componentType !=
-                            fastgltf::ComponentType::UnsignedShort &&
-                    index_accessor.componentType !=
-                            fastgltf::ComponentType::UnsignedInt)
-                    throw std::runtime_error{std::format(
-                            "Mesh primitive indices accessor has unsupported "
-                            "component type: {}",
-                            magic_enum::enum_name(index_accessor.componentType)
-                    )};
-
-                fastgltf::copyFromAccessor<Index>(
-                        asset, index_accessor, indices.data()
-                );
-                auto const primitive_type = [&primitive] {
-                    switch (primitive.type) {
-                        case fastgltf::PrimitiveType::Triangles:
-                            return Primitive::IndexFormat::TriangleList;
-                        case fastgltf::PrimitiveType::TriangleStrip:
-                            return Primitive::IndexFormat::TriangleStrip;
-                        default:
-                            throw std::runtime_error{std::format(
-                                    "Unsupported primitive type: {}",
-                                    static_cast<int>(primitive.type)
-                            )};
-                    }
-                }();
+        std::vector<DecodedImage> decoded_images(decoded_indices.size());
+        for_each_parallel(decoded_indices.size(), [&](std::size_t i) {
+            decoded_images[i] = decode_image(
+                    asset, asset.images[decoded_indices[i]].data, cwd, false
+            );
+        });
 
-                mesh.primitives_.emplace_back(
-                        primitive_type, vertices, indices, texture_indices,
-                        base_color_factor
-                );
-            }
+        for (std::size_t i = 0; i < decoded_indices.size(); ++i) {
+            std::size_t const index = decoded_indices[i];
+            std::string const name{asset.images[index].name};
 
-            return mesh;
+            textures[index] = texture_store.add_texture(
+                    name, Texture{std::move(decoded_images[i]), name},
+                    hashes[index]
+            );
         }
-    };// namespace gltf_mesh_loading
-
-    [[nodiscard]]
-    Texture load_image_data(
-            std::string const &img_name, fastgltf::Asset &asset,
-            fastgltf::DataSource data, std::filesystem::path const &cwd
-    ) {
-        return std::visit(
-                fastgltf::visitor{
-                        [](auto &) -> Texture {
-                            throw std::runtime_error{"Unhandled image format"};
-                        },
-                        [&](fastgltf::sources::URI const &file_path)
-                                -> Texture {
-                            auto const path = cwd / file_path.uri.string();
 
-                            return Texture{path, img_name};
-                        },
-                        [&](fastgltf::sources::Array &array) {
-                            return Texture{
-                                    std::span{
-                                            reinterpret_cast<stbi_uc const *>(
-                                                    array.bytes.data()
-                                            ),
-                                            array.bytes.size()
-                                    },
-                                    img_name
-                            };
-                        },
-                        [&](fastgltf::sources::BufferView &view) {
-                            auto &buffer_view =
-                                    asset.bufferViews[view.bufferViewIndex];
-                            auto const &buffer =
-                                    asset.buffers[buffer_view.bufferIndex];
-
-                            auto array{std::get<fastgltf::sources::Array>(
-                                    buffer.data
-                            )};
+        // Images with the same bytes as an earlier image of the asset.
+        for (std::size_t index = 0; index < image_count; ++index) {
+            if (!textures[index])
+                textures[index] = *texture_store.find_texture(hashes[index]);
+        }
 
-                            return Texture{
-                                    std::span{
-                                            reinterpret_cast<stbi_uc const *>(
-                                                    array.bytes.data() +
-                                                    buffer_view.byteOffset
-                                            ),
-                                            buffer_view.byteLength
-                                    },
-                                    img_name
-                            };
-                        }
-                },
-                data
-        );
+        return textures;
     }
 
-    void load_image(
-            fastgltf::Asset &asset, fastgltf::Image &image,
-            std::filesystem::path const &cwd
+    // Only scenes the asset cooker cooked are used, loading never cooks. Returns nullopt if the scene isn't in the
+    // manifest or its files changed since it was cooked.
+    [[nodiscard]]
+    std::optional<BlobReader> find_cooked_scene(
+            std::filesystem::path const &scene_file_path,
+            GltfLoadOptions const       &options
     ) {
-        std::string const img_name{image.name};
+        auto const &cache_directory = options.cache_directory_;
 
-        auto texture = load_image_data(img_name, asset, image.data, cwd);
+        auto const manifest = read_cooked_manifest(cache_directory);
+        if (manifest.empty())
+            return std::nullopt;
 
-        TextureStore::get_instance().add_texture(img_name, std::move(texture));
+        auto const key = get_cache_key(
+                hash_bytes(map_file(scene_file_path).bytes_), options
+        );
+        auto const it =
+                std::ranges::find(manifest, key, &CookedManifestEntry::key_);
+        if (it == manifest.end() ||
+            !std::filesystem::exists(cache_directory / it->cooked_path_))
+            return std::nullopt;
+
+        return open_cooked_scene(
+                map_file(cache_directory / it->cooked_path_), key,
+                scene_file_path.parent_path()
+        );
     }
 
-    constexpr fastgltf::Options gltf_options{
-            fastgltf::Options::DecomposeNodeMatrices |
-            fastgltf::Options::DontRequireValidAssetMember |
-            fastgltf::Options::AllowDouble |
-            fastgltf::Options::LoadExternalBuffers |
-            fastgltf::Options::LoadExternalImages |
-            fastgltf::Options::GenerateMeshIndices
-    };
-
     void load_gltf_scene(
             Scene &scene, std::filesystem::path const &scene_file_path,
-            GameObject *parent_ptr
+            GameObject *parent_ptr, GltfLoadOptions const &options
     ) {
-        auto buffer = fastgltf::GltfDataBuffer::FromPath(scene_file_path);
-        if (!buffer) {
-            throw std::runtime_error{std::format(
-                    "Failed to read glTF file: {} for reason: {}",
-                    scene_file_path.string(),
-                    fastgltf::getErrorName(buffer.error())
-            )};
-        }
-
-        fastgltf::Parser parser;
-        auto             asset = parser.loadGltf(
-                buffer.get(), scene_file_path.parent_path(), gltf_options
-        );
-        if (asset.error() != fastgltf::Error::None) {
-            throw std::runtime_error{
-                    "Failed to load glTF file: " +
-                    std::string{fastgltf::getErrorName(asset.error())}
-            };
-        }
-        for (auto &image : asset->images) {
-            load_image(asset.get(), image, scene_file_path.parent_path());
-        }
-
-        std::vector<Mesh> meshes;
-        meshes.reserve(asset->meshes.size());
-        for (auto const &gltf_mesh : asset->meshes) {
-            meshes.emplace_back(
-                    gltf_mesh_loading::load_mesh(asset.get(), gltf_mesh)
-            );
-        }
-
-        auto const scene_index = asset->defaultScene.value_or(0);
-
-        auto &gltf_scene = asset->scenes[scene_index];
-
-        auto fn = [&](auto node_index, auto &self,
-                      GameObject const *parent_ptr = nullptr) -> void {
-            fastgltf::Node &node = asset->nodes[node_index];
-
-            auto obj = scene.create_game_object();
-            if (parent_ptr) {
-                obj.set_parent(*parent_ptr);
-            }
-
-            auto const &[translation, rotation, scale] =
-                    std::get<fastgltf::TRS>(node.transform);
-
-            auto &transform = obj.add_component<Transform>();
-            transform.set_position(
-                    translation.x(), translation.y(), translation.z()
-            );
-            transform.set_rotation(
-                    rotation.x(), rotation.y(), rotation.z(), rotation.w()
-            );
-            transform.set_scale(scale.x(), scale.y(), scale.z());
-
-            for (auto const child_index : node.children) {
-                self(child_index, self, &obj);
-            }
+        auto mesh_options = options;
+        if ((bgfx::getCaps()->supported & BGFX_CAPS_VERTEX_ATTRIB_HALF) == 0)
+            mesh_options.vertex_format_ = VertexFormat::Float;
+
+        if (!options.cache_directory_.empty()) {
+            if (auto reader =
+                        find_cooked_scene(scene_file_path, mesh_options)) {
+                auto textures =
+                        load_cooked_images(*reader, options.stream_textures_);
+                auto geometry = reader->read_blob();
+                instantiate_cooked_scene(
+                        scene, geometry, textures, parent_ptr,
+                        options.is_occluder_
+                );
 
-            if (!node.meshIndex.has_value())
                 return;
-
-            auto &mesh = meshes.at(node.meshIndex.value());
-            obj.add_component<MeshRenderer>(
-                    std::make_unique<Mesh>(std::move(mesh))
-            );
-        };
-
-        for (auto const scene_node : gltf_scene.nodeIndices) {
-            fn(scene_node, fn, parent_ptr);
+            }
         }
+
+        auto const cwd = scene_file_path.parent_path();
+        // External images stay paths when they're streamed, they're read when they're decoded.
+        auto const parse_options =
+                options.stream_textures_
+                        ? gltf_options
+                        : gltf_options | fastgltf::Options::LoadExternalImages;
+        auto const asset = std::make_shared<fastgltf::Asset const>(
+                parse_gltf(map_file(scene_file_path), cwd, parse_options)
+        );
+        auto const textures =
+                load_images(asset, scene_file_path, mesh_options);
+
+        // Only the geometry is cooked, in memory, so that both paths create the scene the same way.
+        BlobWriter writer;
+        cook_geometry(writer, *asset, mesh_options);
+        BlobReader geometry{SharedBytes::from_vector(writer.take())};
+        instantiate_cooked_scene(
+                scene, geometry, textures, parent_ptr, options.is_occluder_
+        );
     }
 }// namespace engine
@@ -2,14 +2,61 @@
 #define GLTF_LOADER_H
 
 #include <fastgltf/core.hpp>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
+#include "math/aabb.h"
+#include "mesh_processing/mesh_optimizer.h"
+#include "types.h"
 
 namespace engine {
     class GameObject;
     class Scene;
 
+    // Given the name of a mesh and its bounds in the space of the mesh.
+    using OccluderPredicate =
+            std::function<bool(std::string_view, math::Aabb const &)>;
+
+    // Given the name of a mesh and the combined report of its primitives.
+    using MeshOptimizationCallback = std::function<void(
+            std::string_view, mesh_processing::MeshOptimizationReport const &
+    )>;
+
+    struct GltfLoadOptions final {
+        // Decides which meshes also get an Occluder, none do if it's empty.
+        OccluderPredicate        is_occluder_{};
+        // Packed vertices fall back to floats if the GPU can't read half float attributes.
+        VertexFormat             vertex_format_{VertexFormat::Packed};
+        // Splits primitives with too many vertices for 16-bit indices into several that each fit.
+        bool                     split_for_16_bit_indices_{false};
+        // Welds duplicate vertices and reorders triangles and vertices for the vertex cache, overdraw and vertex
+        // fetch. Strips are converted to lists.
+        bool                     optimize_meshes_{false};
+        // Only called for meshes that are processed, which cooked scenes aren't.
+        MeshOptimizationCallback report_optimization_{};
+        // Up to this many coarser levels of detail are generated for every triangle list, each with about half the
+        // triangles of the previous one.
+        std::size_t              lod_count_{0};
+        // Images are block compressed when the scene is cooked and stored in the cooked scene. Scenes loaded from
+        // their glTF file use their images as they are.
+        bool                     compress_textures_{false};
+        // Textures start out as placeholders and are decoded in the background, TextureStore uploads them as they
+        // finish. Nothing is read while loading, so streamed images only share textures with images of the same file.
+        bool                     stream_textures_{false};
+        // Scenes the asset cooker cooked into this directory, with their processed meshes, images and nodes, are
+        // mapped instead of parsing and processing the glTF file. A scene is loaded from its glTF file if it isn't
+        // listed in the manifest there, was cooked with other options, or one of its files changed since. Loading
+        // never cooks or writes anything.
+        std::filesystem::path    cache_directory_{};
+    };
+
+    // Loads .gltf and .glb files alike, images embedded in either are decoded from the loaded buffers in place.
+    // Occluders are picked when the scene is loaded, also for cached scenes.
     void load_gltf_scene(
             Scene &scene, std::filesystem::path const &scene_file_path,
-            GameObject *parent_ptr = nullptr
+            GameObject            *parent_ptr = nullptr,
+            GltfLoadOptions const &options    = {}
     );
 }// namespace engine
 
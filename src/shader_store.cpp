@@ -0,0 +1,61 @@
+#include "shader_store.h"
+
+#include "misc/utils.h"
+
+namespace engine {
+    std::shared_ptr<ShaderUPtr const>
+    ShaderStore::get_shader(ShaderKey const &key) {
+        if (auto const it = shaders_.find(key); it != shaders_.end()) {
+            if (auto shader_ptr = it->second.lock())
+                return shader_ptr;
+        }
+
+        auto shader_ptr =
+                std::make_shared<ShaderUPtr const>(utils::load_shader(key.name_)
+                );
+        shaders_.insert_or_assign(key, shader_ptr);
+
+        return shader_ptr;
+    }
+
+    ProgramHandle ShaderStore::get_program(
+            std::string_view vert_name, std::string_view frag_name
+    ) {
+        auto const       renderer_type = bgfx::getRendererType();
+        ProgramKey const key{
+                {std::string{vert_name}, renderer_type},
+                {std::string{frag_name}, renderer_type}
+        };
+
+        if (auto const it = programs_.find(key); it != programs_.end()) {
+            if (auto program_ptr = it->second.lock())
+                return ProgramHandle{std::move(program_ptr)};
+        }
+
+        auto vert_shader_ptr = get_shader(key.vert_);
+        auto frag_shader_ptr = get_shader(key.frag_);
+
+        ProgramUPtr program_uptr{utils::verify_bgfx_handle(
+                bgfx::createProgram(
+                        vert_shader_ptr->get(), frag_shader_ptr->get(), false
+                ),
+                "failed to create program"
+        )};
+
+        auto program_ptr = std::make_shared<Program const>(Program{
+                std::move(vert_shader_ptr), std::move(frag_shader_ptr),
+                std::move(program_uptr)
+        });
+        programs_.insert_or_assign(key, program_ptr);
+
+        return ProgramHandle{std::move(program_ptr)};
+    }
+
+    bgfx::ProgramHandle ProgramHandle::get() const {
+        return program_ptr_->program_uptr_.get();
+    }
+
+    ProgramHandle::operator bool() const {
+        return program_ptr_ != nullptr;
+    }
+}// namespace engine
@@ -0,0 +1,86 @@
+#ifndef SHADER_STORE_H
+#define SHADER_STORE_H
+
+#include <compare>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "misc/singleton.h"
+#include "types.h"
+
+namespace engine {
+    class ProgramHandle;
+
+    // Loads every shader binary and links every program at most once per renderer type.
+    // The store itself only keeps weak references, so a program (and the shaders it was linked from) is destroyed as
+    // soon as the last ProgramHandle referring to it goes away.
+    class ShaderStore final : public Singleton<ShaderStore> {
+        struct ShaderKey final {
+            std::string              name_;
+            bgfx::RendererType::Enum renderer_type_;
+
+            [[nodiscard]]
+            auto operator<=>(ShaderKey const &) const = default;
+        };
+
+        struct ProgramKey final {
+            ShaderKey vert_;
+            ShaderKey frag_;
+
+            [[nodiscard]]
+            auto operator<=>(ProgramKey const &) const = default;
+        };
+
+        struct Program final {
+            std::shared_ptr<ShaderUPtr const> vert_shader_ptr_;
+            std::shared_ptr<ShaderUPtr const> frag_shader_ptr_;
+            // Declared last so the program is destroyed before the shaders it was linked from.
+            ProgramUPtr program_uptr_;
+        };
+
+        std::map<ShaderKey, std::weak_ptr<ShaderUPtr const>> shaders_;
+        std::map<ProgramKey, std::weak_ptr<Program const>>   programs_;
+
+        friend class ProgramHandle;
+
+        [[nodiscard]]
+        std::shared_ptr<ShaderUPtr const> get_shader(ShaderKey const &key);
+
+    public:
+        ShaderStore() = default;
+
+        [[nodiscard]]
+        ProgramHandle
+        get_program(std::string_view vert_name, std::string_view frag_name);
+
+        void clear() {
+            programs_.clear();
+            shaders_.clear();
+        }
+    };
+
+    class ProgramHandle final {
+        std::shared_ptr<ShaderStore::Program const> program_ptr_{};
+
+        friend class ShaderStore;
+
+        explicit ProgramHandle(
+                std::shared_ptr<ShaderStore::Program const> program_ptr
+        )
+            : program_ptr_{std::move(program_ptr)} {
+        }
+
+    public:
+        ProgramHandle() = default;
+
+        [[nodiscard]]
+        bgfx::ProgramHandle get() const;
+
+        [[nodiscard]]
+        explicit operator bool() const;
+    };
+}// namespace engine
+
+#endif//SHADER_STORE_H
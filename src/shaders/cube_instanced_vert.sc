@@ -0,0 +1,13 @@
+$input a_position, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+$output v_color0, v_texcoord0
+
+#include <bgfx_shader.sh>
+
+void main()
+{
+    mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+    vec4 world_pos = mul(model, vec4(a_position, 1.0));
+    gl_Position = mul(u_viewProj, world_pos);
+    v_color0 = vec4(1.0, 1.0, 1.0, 1.0);
+    v_texcoord0 = a_texcoord0;
+}
\ No newline at end of file
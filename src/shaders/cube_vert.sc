@@ -5,7 +5,9 @@ $output v_color0, v_texcoord0
 
 void main()
 {
-    gl_Position = mul(u_modelViewProj, vec4(a_position, 1.0));
+    // Transformed in two steps like the instanced and depth shaders, so all of them produce the same depth.
+    vec4 world_pos = mul(u_model[0], vec4(a_position, 1.0));
+    gl_Position = mul(u_viewProj, world_pos);
     v_color0 = vec4(1.0, 1.0, 1.0, 1.0);
     v_texcoord0 = a_texcoord0;
 }
\ No newline at end of file
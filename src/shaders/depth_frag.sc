@@ -0,0 +1,7 @@
+#include <bgfx_shader.sh>
+
+void main()
+{
+    // Color writes are disabled, only the depth of the fragment is used.
+    gl_FragColor = vec4_splat(0.0);
+}
\ No newline at end of file
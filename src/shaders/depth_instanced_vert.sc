@@ -0,0 +1,10 @@
+$input a_position, i_data0, i_data1, i_data2, i_data3
+
+#include <bgfx_shader.sh>
+
+void main()
+{
+    mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+    vec4 world_pos = mul(model, vec4(a_position, 1.0));
+    gl_Position = mul(u_viewProj, world_pos);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+$input a_position
+
+#include <bgfx_shader.sh>
+
+void main()
+{
+    // Same math as cube_vert, the opaque pass only draws fragments whose depth is exactly equal.
+    vec4 world_pos = mul(u_model[0], vec4(a_position, 1.0));
+    gl_Position = mul(u_viewProj, world_pos);
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <misc/blob.h>
+#include <span>
+#include <vector>
+
+SCENARIO("Writing and reading blobs") {
+    GIVEN("A blob with values, arrays and a string") {
+        engine::BlobWriter writer;
+        writer.write(uint8_t{7});
+        std::vector<float> const floats{1.f, 2.f, 3.f};
+        writer.write_span(std::span{floats});
+        writer.write_string("name");
+        std::vector<uint8_t> const bytes{4, 5};
+        writer.write_span(std::span{bytes});
+        writer.write(uint64_t{42});
+
+        auto const blob = engine::SharedBytes::from_vector(writer.take());
+
+        WHEN("We read it back in the same order") {
+            engine::BlobReader reader{blob};
+
+            THEN("The values match and arrays are viewed in place") {
+                REQUIRE(reader.read<uint8_t>() == 7);
+
+                auto const read_floats = reader.read_span<float>();
+                REQUIRE(read_floats.size() == 3);
+                REQUIRE(read_floats[2] == 3.f);
+                auto const address =
+                        reinterpret_cast<std::uintptr_t>(read_floats.data());
+                REQUIRE(address % alignof(float) == 0);
+                REQUIRE(address > reinterpret_cast<std::uintptr_t>(
+                                          blob.bytes_.data()
+                                  ));
+
+                REQUIRE(reader.read_string() == "name");
+
+                auto const read_bytes = reader.read_shared_bytes();
+                REQUIRE(read_bytes.owner_ == blob.owner_);
+                REQUIRE(read_bytes.bytes_.size() == 2);
+                REQUIRE(read_bytes.bytes_[1] == 5);
+
+                REQUIRE(reader.read<uint64_t>() == 42);
+                REQUIRE(reader.is_at_end());
+            }
+        }
+
+        WHEN("We read past its end") {
+            engine::BlobReader reader{blob.subspan(blob.bytes_.size() - 4)};
+
+            THEN("Reading throws") {
+                REQUIRE_THROWS(reader.read<uint64_t>());
+            }
+        }
+    }
+
+    GIVEN("A blob nested in another one after an odd number of bytes") {
+        engine::BlobWriter inner;
+        std::vector<double> const doubles{0.5, 1.5};
+        inner.write_span(std::span{doubles});
+
+        engine::BlobWriter outer;
+        outer.write(uint8_t{1});
+        outer.write_blob(inner.take());
+        outer.write(uint32_t{9});
+
+        auto const blob = engine::SharedBytes::from_vector(outer.take());
+
+        WHEN("We read the nested blob") {
+            engine::BlobReader reader{blob};
+            REQUIRE(reader.read<uint8_t>() == 1);
+            auto nested = reader.read_blob();
+
+            THEN("Its arrays are aligned and the outer blob continues after it"
+            ) {
+                auto const read_doubles = nested.read_span<double>();
+                REQUIRE(read_doubles.size() == 2);
+                REQUIRE(read_doubles[1] == 1.5);
+                REQUIRE(reinterpret_cast<std::uintptr_t>(read_doubles.data()) %
+                                alignof(double) ==
+                        0);
+                REQUIRE(nested.is_at_end());
+                REQUIRE(nested.get_bytes().owner_ == blob.owner_);
+
+                REQUIRE(reader.read<uint32_t>() == 9);
+                REQUIRE(reader.is_at_end());
+            }
+        }
+    }
+}
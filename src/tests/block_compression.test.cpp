@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <texture_processing/block_compression.h>
+#include <texture_processing/ktx.h>
+#include <vector>
+
+using engine::texture_processing::BlockFormat;
+using engine::texture_processing::BlockTexels;
+
+namespace {
+    constexpr std::array formats{
+            BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC5,
+            BlockFormat::BC7
+    };
+
+    // Channels each format keeps, BC1 drops alpha and BC5 keeps red and green.
+    [[nodiscard]]
+    std::size_t get_channel_count(BlockFormat format) {
+        switch (format) {
+            case BlockFormat::BC1:
+                return 3;
+            case BlockFormat::BC5:
+                return 2;
+            default:
+                return 4;
+        }
+    }
+
+    [[nodiscard]]
+    BlockTexels round_trip(BlockFormat format, BlockTexels const &texels) {
+        std::vector<uint8_t> block(
+                engine::texture_processing::get_block_byte_size(format)
+        );
+        engine::texture_processing::compress_block(format, texels, block);
+
+        BlockTexels decoded{};
+        engine::texture_processing::decompress_block(format, block, decoded);
+
+        return decoded;
+    }
+
+    [[nodiscard]]
+    int get_max_error(
+            BlockFormat format, BlockTexels const &expected,
+            BlockTexels const &actual
+    ) {
+        int error{};
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (i % 4 < get_channel_count(format))
+                error = std::max(error, std::abs(expected[i] - actual[i]));
+        }
+
+        return error;
+    }
+
+    // Every channel ramps along its own direction through the block.
+    [[nodiscard]]
+    BlockTexels make_gradient() {
+        BlockTexels texels{};
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                auto *const texel = texels.data() + (y * 4 + x) * 4;
+                texel[0]          = static_cast<uint8_t>(40 + x * 50);
+                texel[1]          = static_cast<uint8_t>(200 - x * 40);
+                texel[2]          = static_cast<uint8_t>(10 + x * 20);
+                texel[3]          = static_cast<uint8_t>(255 - x * 60);
+            }
+        }
+
+        return texels;
+    }
+}// namespace
+
+SCENARIO("Compressing single blocks") {
+    GIVEN("A block of a single color") {
+        BlockTexels texels{};
+        for (std::size_t i = 0; i < texels.size(); i += 4) {
+            texels[i]     = 180;
+            texels[i + 1] = 90;
+            texels[i + 2] = 30;
+            texels[i + 3] = 128;
+        }
+
+        WHEN("We compress and decompress it in every format") {
+            THEN("The color only changes by quantization") {
+                for (auto const format : formats) {
+                    REQUIRE(get_max_error(
+                                    format, texels, round_trip(format, texels)
+                            ) <= 4);
+                }
+            }
+        }
+    }
+
+    GIVEN("A block with a gradient along a line in color space") {
+        auto const texels = make_gradient();
+
+        WHEN("We compress and decompress it in every format") {
+            THEN("The interpolated colors stay close to the original ones") {
+                for (auto const format : formats) {
+                    REQUIRE(get_max_error(
+                                    format, texels, round_trip(format, texels)
+                            ) <= 24);
+                }
+            }
+        }
+
+        WHEN("We compress it as BC7") {
+            std::array<uint8_t, 16> block{};
+            engine::texture_processing::compress_block(
+                    BlockFormat::BC7, make_gradient(), block
+            );
+
+            THEN("It is a mode 6 block with its finer steps") {
+                REQUIRE(block[0] == 1 << 6);
+                REQUIRE(get_max_error(
+                                BlockFormat::BC7, texels,
+                                round_trip(BlockFormat::BC7, texels)
+                        ) <= 8);
+            }
+        }
+    }
+}
+
+SCENARIO("Compressing a texture into a KTX file") {
+    GIVEN("The mip chain of an RGB image that doesn't fill whole blocks") {
+        std::vector<uint8_t> pixels(10 * 6 * 3);
+        for (std::size_t i = 0; i < pixels.size(); ++i) {
+            pixels[i] = static_cast<uint8_t>(i * 7);
+        }
+        auto const chain = engine::texture_processing::build_mip_chain(
+                pixels, 10, 6, 3,
+                engine::texture_processing::ColorSpace::Linear
+        );
+
+        WHEN("We compress it") {
+            auto const texture = engine::texture_processing::compress_texture(
+                    chain, BlockFormat::BC1
+            );
+
+            THEN("Every level is rounded up to whole blocks") {
+                REQUIRE(texture.levels_.size() == chain.levels_.size());
+                REQUIRE(texture.get_level_data(0).size() == 3 * 2 * 8);
+                REQUIRE(texture.get_level_data(1).size() == 2 * 1 * 8);
+                REQUIRE(texture.get_level_data(3).size() == 8);
+            }
+
+            AND_WHEN("We write it as KTX and read it back") {
+                auto const file =
+                        engine::texture_processing::encode_ktx(texture);
+                auto const decoded =
+                        engine::texture_processing::decode_ktx(file);
+
+                THEN("It has the KTX header and the same levels") {
+                    REQUIRE(engine::texture_processing::is_ktx(file));
+                    // glInternalFormat, after the identifier and four fields.
+                    REQUIRE(file[12 + 4 * 4] == 0xF1);
+                    REQUIRE(file[12 + 4 * 4 + 1] == 0x83);
+
+                    REQUIRE(decoded.format_ == BlockFormat::BC1);
+                    REQUIRE(decoded.levels_.size() == texture.levels_.size());
+                    REQUIRE(decoded.levels_[0].width_ == 10);
+                    REQUIRE(decoded.levels_[0].height_ == 6);
+                    REQUIRE(decoded.data_ == texture.data_);
+                }
+            }
+
+            AND_WHEN("The file is truncated") {
+                auto file = engine::texture_processing::encode_ktx(texture);
+                file.resize(file.size() - 1);
+
+                THEN("Reading it fails") {
+                    REQUIRE_THROWS(
+                            engine::texture_processing::decode_ktx(file)
+                    );
+                }
+            }
+        }
+    }
+}
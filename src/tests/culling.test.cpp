@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+#include <graphics/culling.h>
+#include <vector>
+
+#include "test_scene.h"
+
+using test_scene::make_box;
+using test_scene::projection;
+
+SCENARIO("Culling bounding boxes against a view frustum") {
+    auto const frustum =
+            engine::Frustum::from_view_projection(projection, false);
+
+    GIVEN("Boxes in front of, behind, beside and beyond the camera") {
+        engine::BoundsCuller culler;
+
+        auto const in_front =
+                culler.add(make_box(engine::math::Vec3{0.f, 0.f, 10.f}, 1.f));
+        auto const behind =
+                culler.add(make_box(engine::math::Vec3{0.f, 0.f, -10.f}, 1.f));
+        auto const beside =
+                culler.add(make_box(engine::math::Vec3{-30.f, 0.f, 10.f}, 1.f));
+        auto const beyond =
+                culler.add(make_box(engine::math::Vec3{0.f, 0.f, 200.f}, 1.f));
+        auto const straddling =
+                culler.add(make_box(engine::math::Vec3{-10.f, 0.f, 10.f}, 2.f));
+
+        WHEN("We cull them without a size cutoff") {
+            std::vector<uint8_t> visible;
+            culler.cull(frustum, {}, visible);
+
+            THEN("Only the boxes that intersect the frustum are visible") {
+                REQUIRE(visible.size() == culler.get_count());
+                REQUIRE(visible[in_front] == 1);
+                REQUIRE(visible[behind] == 0);
+                REQUIRE(visible[beside] == 0);
+                REQUIRE(visible[beyond] == 0);
+                REQUIRE(visible[straddling] == 1);
+            }
+        }
+    }
+
+    GIVEN("A small box close by and the same box far away") {
+        engine::BoundsCuller culler;
+
+        auto const close =
+                culler.add(make_box(engine::math::Vec3{0.f, 0.f, 2.f}, .1f));
+        auto const far_away =
+                culler.add(make_box(engine::math::Vec3{0.f, 0.f, 90.f}, .1f));
+
+        WHEN("We cull them with a minimum projected size") {
+            std::vector<uint8_t> visible;
+            culler.cull(frustum, {projection[5], 0.01f}, visible);
+
+            THEN("Only the box that is large enough on screen is visible") {
+                REQUIRE(visible[close] == 1);
+                REQUIRE(visible[far_away] == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <misc/dynamic_aabb_tree.h>
+#include <random>
+#include <vector>
+
+#include "test_scene.h"
+
+using test_scene::make_box;
+
+namespace {
+    std::vector<uint32_t> query_tree(
+            engine::DynamicAabbTree const &tree, engine::math::Aabb const &area
+    ) {
+        std::vector<uint32_t> result;
+        tree.query(
+                [&](engine::math::Aabb const &bounds) {
+                    return bounds.overlaps(area);
+                },
+                [&](uint32_t user_data) { result.push_back(user_data); }
+        );
+        std::ranges::sort(result);
+
+        return result;
+    }
+
+    std::vector<uint32_t> query_brute_force(
+            engine::DynamicAabbTree const                       &tree,
+            std::vector<engine::DynamicAabbTree::ProxyId> const &proxies,
+            engine::math::Aabb const                            &area
+    ) {
+        std::vector<uint32_t> result;
+        for (auto const proxy : proxies) {
+            if (tree.get_fat_bounds(proxy).overlaps(area)) {
+                result.push_back(tree.get_user_data(proxy));
+            }
+        }
+        std::ranges::sort(result);
+
+        return result;
+    }
+}// namespace
+
+SCENARIO("Querying a dynamic AABB tree") {
+    GIVEN("A tree with many randomly placed boxes") {
+        std::mt19937                          rng{42};
+        std::uniform_real_distribution<float> position_dist{-100.f, 100.f};
+
+        auto const random_position = [&] {
+            return engine::math::Vec3{
+                    position_dist(rng), position_dist(rng), position_dist(rng)
+            };
+        };
+
+        engine::DynamicAabbTree                       tree;
+        std::vector<engine::DynamicAabbTree::ProxyId> proxies;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            proxies.push_back(
+                    tree.create_proxy(make_box(random_position(), 2.f), i)
+            );
+        }
+
+        auto const query_area = make_box(engine::math::Vec3{}, 60.f);
+
+        THEN("The tree stays balanced") {
+            REQUIRE(tree.get_proxy_count() == 1000);
+            REQUIRE(tree.get_height() <=
+                    2 * static_cast<int>(std::ceil(std::log2(1000.f))));
+        }
+
+        THEN("A query finds the same boxes as testing every box") {
+            auto const found = query_tree(tree, query_area);
+
+            REQUIRE_FALSE(found.empty());
+            REQUIRE(found == query_brute_force(tree, proxies, query_area));
+        }
+
+        WHEN("Boxes move around and some are removed") {
+            for (auto const proxy : proxies) {
+                tree.move_proxy(proxy, make_box(random_position(), 2.f));
+            }
+            for (std::size_t i = 0; i < proxies.size(); i += 3) {
+                tree.destroy_proxy(proxies[i]);
+            }
+            std::erase_if(proxies, [&, i = 0](auto) mutable {
+                return i++ % 3 == 0;
+            });
+
+            THEN("Queries still match testing every remaining box") {
+                REQUIRE(tree.get_proxy_count() == proxies.size());
+                REQUIRE(query_tree(tree, query_area) ==
+                        query_brute_force(tree, proxies, query_area));
+            }
+        }
+    }
+
+    GIVEN("A box that moves slightly within its margin") {
+        engine::DynamicAabbTree tree{0.5f};
+        auto const              proxy =
+                tree.create_proxy(make_box(engine::math::Vec3{}, 1.f), 7);
+
+        WHEN("We move it") {
+            bool const reinserted = tree.move_proxy(
+                    proxy, make_box(engine::math::Vec3{0.1f, 0.f, 0.f}, 1.f)
+            );
+
+            THEN("The tree does not have to be updated") {
+                REQUIRE_FALSE(reinserted);
+                REQUIRE(tree.get_user_data(proxy) == 7);
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <misc/hash.h>
+#include <span>
+#include <string_view>
+
+namespace {
+    [[nodiscard]]
+    engine::Hash128 hash_string(std::string_view text, uint64_t seed = 0) {
+        return engine::hash_bytes(
+                std::span{
+                        reinterpret_cast<uint8_t const *>(text.data()),
+                        text.size()
+                },
+                seed
+        );
+    }
+}// namespace
+
+SCENARIO("Hashing bytes with MurmurHash3 x64_128") {
+    GIVEN("Inputs with known reference hashes") {
+        THEN("Empty input hashes to zero") {
+            REQUIRE(hash_string("") == engine::Hash128{0, 0});
+        }
+
+        THEN("Inputs shorter than a block match the reference") {
+            REQUIRE(hash_string("hello") ==
+                    engine::Hash128{0xCBD8A7B341BD9B02, 0x5B1E906A48AE1D19});
+        }
+
+        THEN("Inputs of exactly one block match the reference") {
+            REQUIRE(hash_string("0123456789abcdef") ==
+                    engine::Hash128{0x4BE06D94CF4AD1A7, 0x87C35B5C63A708DA});
+        }
+
+        THEN("Inputs with a tail longer than a word match the reference") {
+            REQUIRE(hash_string("0123456789abcdef0123456") ==
+                    engine::Hash128{0x0CC16E1A910058B0, 0x20AF29C6E8B01ED9});
+        }
+
+        THEN("Inputs of several blocks match the reference") {
+            auto const hash =
+                    hash_string("The quick brown fox jumps over the lazy dog");
+            REQUIRE(hash ==
+                    engine::Hash128{0xE34BBC7BBC071B6C, 0x7A433CA9C49A9347});
+        }
+
+        THEN("The seed changes the hash") {
+            REQUIRE(hash_string("hello", 42) ==
+                    engine::Hash128{0xC4B8B3C960AF6F08, 0x2334B875B0EFBC7A});
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <mesh_processing/index_splitting.h>
+#include <vector>
+
+SCENARIO("Choosing and narrowing 16-bit indices") {
+    GIVEN("Indices below the 16-bit limit") {
+        std::vector<uint32_t> const indices{0, 1, 2, 65000, 3, 65534};
+
+        THEN("They fit and narrow without changing") {
+            REQUIRE(engine::mesh_processing::fits_16_bit(indices));
+
+            auto const narrowed =
+                    engine::mesh_processing::narrow_indices(indices);
+            REQUIRE(std::vector<uint32_t>(narrowed.begin(), narrowed.end()) ==
+                    indices);
+        }
+    }
+
+    GIVEN("Indices that reach the strip restart value") {
+        std::vector<uint32_t> const indices{0, 1, 65535};
+
+        THEN("They don't fit") {
+            REQUIRE_FALSE(engine::mesh_processing::fits_16_bit(indices));
+        }
+    }
+}
+
+SCENARIO("Converting triangle strips to lists") {
+    GIVEN("A strip of four triangles with a degenerate one") {
+        std::vector<uint32_t> const strip{0, 1, 2, 3, 3, 4};
+
+        WHEN("We convert it") {
+            auto const list = engine::mesh_processing::strip_to_list(strip);
+
+            THEN("Odd triangles are flipped and degenerate ones dropped") {
+                REQUIRE(list == std::vector<uint32_t>{0, 1, 2, 2, 1, 3});
+            }
+        }
+    }
+}
+
+SCENARIO("Splitting triangle lists to limit their vertex count") {
+    GIVEN("A grid of quads referencing many vertices") {
+        constexpr uint32_t    columns = 40;
+        constexpr uint32_t    rows    = 40;
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y < rows; ++y) {
+            for (uint32_t x = 0; x < columns; ++x) {
+                uint32_t const corner = y * (columns + 1) + x;
+                uint32_t const below  = corner + columns + 1;
+                indices.insert(
+                        indices.end(),
+                        {corner, below, corner + 1, corner + 1, below,
+                         below + 1}
+                );
+            }
+        }
+        std::size_t const vertex_count = (columns + 1) * (rows + 1);
+
+        WHEN("We split it into parts of at most 256 vertices") {
+            auto const subsets = engine::mesh_processing::split_triangle_list(
+                    indices, vertex_count, 256
+            );
+
+            THEN("It was split into several parts within the limit") {
+                REQUIRE(subsets.size() > 1);
+                for (auto const &subset : subsets) {
+                    REQUIRE(subset.vertex_remap_.size() <= 256);
+                    REQUIRE(subset.indices_.size() % 3 == 0);
+                }
+            }
+
+            THEN("Remapping the parts gives back the original triangles") {
+                std::vector<uint32_t> remapped;
+                for (auto const &subset : subsets) {
+                    for (uint32_t const index : subset.indices_) {
+                        remapped.push_back(subset.vertex_remap_[index]);
+                    }
+                }
+
+                REQUIRE(remapped == indices);
+            }
+        }
+
+        WHEN("The limit is above its vertex count") {
+            auto const subsets = engine::mesh_processing::split_triangle_list(
+                    indices, vertex_count
+            );
+
+            THEN("It is kept in one piece") {
+                REQUIRE(subsets.size() == 1);
+                REQUIRE(subsets.front().indices_.size() == indices.size());
+            }
+        }
+    }
+}
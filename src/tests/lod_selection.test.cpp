@@ -0,0 +1,55 @@
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <graphics/lod_selection.h>
+
+namespace {
+    constexpr std::array<float, 3> errors{0.f, 0.01f, 0.1f};
+
+    // One pixel of error at a distance of 100 for the first coarser level.
+    constexpr engine::LodSelection selection{10000.f, 1.f, 0.25f};
+}// namespace
+
+SCENARIO("Selecting a level of detail by its projected error") {
+    GIVEN("A primitive close to the camera") {
+        THEN("It is drawn in full detail") {
+            REQUIRE(engine::select_lod(errors, 10.f, 0, selection) == 0);
+        }
+    }
+
+    GIVEN("A primitive far away from the camera") {
+        THEN("The coarsest level is drawn") {
+            REQUIRE(engine::select_lod(errors, 10000.f, 0, selection) == 2);
+        }
+    }
+
+    GIVEN("No projection to measure errors with") {
+        THEN("It is drawn in full detail") {
+            REQUIRE(engine::select_lod(errors, 10000.f, 0, {}) == 0);
+        }
+    }
+
+    GIVEN("A primitive just beyond the distance where the first level fits") {
+        constexpr float distance = 110.f;
+
+        WHEN("It was drawn in full detail") {
+            THEN("It stays in full detail until the error is clearly small") {
+                REQUIRE(engine::select_lod(errors, distance, 0, selection) ==
+                        0);
+                REQUIRE(engine::select_lod(errors, 140.f, 0, selection) == 1);
+            }
+        }
+
+        WHEN("It was drawn with the first level") {
+            THEN("It keeps that level") {
+                REQUIRE(engine::select_lod(errors, distance, 1, selection) ==
+                        1);
+            }
+        }
+
+        WHEN("It moves closer than the distance where the level fits") {
+            THEN("It switches back to full detail") {
+                REQUIRE(engine::select_lod(errors, 90.f, 1, selection) == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <misc/mapped_file.h>
+#include <vector>
+
+namespace {
+    [[nodiscard]]
+    std::filesystem::path
+    write_temp_file(char const *name, std::vector<uint8_t> const &bytes) {
+        auto const path = std::filesystem::temp_directory_path() / name;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(
+                reinterpret_cast<char const *>(bytes.data()),
+                static_cast<std::streamsize>(bytes.size())
+        );
+
+        return path;
+    }
+}// namespace
+
+SCENARIO("Mapping files") {
+    GIVEN("A file with some bytes") {
+        std::vector<uint8_t> contents(10000);
+        for (std::size_t i = 0; i < contents.size(); ++i) {
+            contents[i] = static_cast<uint8_t>(i * 7);
+        }
+        auto const path = write_temp_file("mapped_file_test.bin", contents);
+
+        WHEN("We map it") {
+            engine::MappedFile const file{path};
+
+            THEN("It views the contents of the file") {
+                REQUIRE(std::ranges::equal(file.get_bytes(), contents));
+            }
+        }
+
+        WHEN("We share its mapping") {
+            auto const bytes = engine::map_file(path).subspan(100);
+
+            THEN("The bytes stay valid after the call") {
+                REQUIRE(bytes.bytes_.size() == contents.size() - 100);
+                REQUIRE(bytes.bytes_[0] == contents[100]);
+                REQUIRE(bytes.bytes_.back() == contents.back());
+            }
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    GIVEN("An empty file") {
+        auto const path = write_temp_file("mapped_file_empty.bin", {});
+
+        THEN("Mapping it gives no bytes") {
+            REQUIRE(engine::MappedFile{path}.get_bytes().empty());
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    GIVEN("A file that doesn't exist") {
+        THEN("Mapping it throws") {
+            REQUIRE_THROWS(engine::MappedFile{"does/not/exist.bin"});
+        }
+    }
+}
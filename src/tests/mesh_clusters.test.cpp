@@ -0,0 +1,161 @@
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <graphics/mesh_clusters.h>
+#include <vector>
+
+#include "test_scene.h"
+
+using test_scene::projection;
+
+namespace {
+    constexpr uint32_t grid_width  = 8;
+    constexpr uint32_t grid_height = 256;
+
+    // A tall grid of quads at depth `z`, centered on the view axis. Its triangles face the camera at the origin unless
+    // they're flipped.
+    void make_grid(
+            float z, bool flipped, std::vector<engine::math::Vec3> &positions,
+            std::vector<uint32_t> &indices
+    ) {
+        for (uint32_t y = 0; y <= grid_height; ++y) {
+            for (uint32_t x = 0; x <= grid_width; ++x) {
+                positions.emplace_back(
+                        static_cast<float>(x) - grid_width / 2.f,
+                        static_cast<float>(y) - grid_height / 2.f, z
+                );
+            }
+        }
+
+        for (uint32_t y = 0; y < grid_height; ++y) {
+            for (uint32_t x = 0; x < grid_width; ++x) {
+                uint32_t const corner = y * (grid_width + 1) + x;
+                uint32_t const below  = corner + grid_width + 1;
+                if (flipped) {
+                    indices.insert(
+                            indices.end(), {corner, corner + 1, below,
+                                            corner + 1, below + 1, below}
+                    );
+                } else {
+                    indices.insert(
+                            indices.end(), {corner, below, corner + 1,
+                                            corner + 1, below, below + 1}
+                    );
+                }
+            }
+        }
+    }
+
+    [[nodiscard]]
+    uint32_t count_indices(std::vector<engine::IndexRange> const &ranges) {
+        uint32_t count{};
+        for (auto const &range : ranges) {
+            count += range.index_count_;
+        }
+
+        return count;
+    }
+}// namespace
+
+SCENARIO("Splitting a triangle list into clusters") {
+    GIVEN("A large grid") {
+        std::vector<engine::math::Vec3> positions;
+        std::vector<uint32_t>           indices;
+        make_grid(10.f, false, positions, indices);
+
+        WHEN("We build its clusters") {
+            auto const clusters =
+                    engine::MeshClusters::build(indices, positions, false);
+
+            THEN("They cover all triangles in order and aren't too large") {
+                REQUIRE(clusters.get_count() > 1);
+
+                uint32_t next_index{};
+                for (std::size_t i = 0; i < clusters.get_count(); ++i) {
+                    auto const range = clusters.get_index_range(i);
+                    REQUIRE(range.first_index_ == next_index);
+                    REQUIRE(range.index_count_ <=
+                            engine::MeshClusters::max_triangles * 3);
+                    next_index += range.index_count_;
+                }
+                REQUIRE(next_index == indices.size());
+            }
+        }
+    }
+}
+
+SCENARIO("Culling clusters") {
+    auto const frustum =
+            engine::Frustum::from_view_projection(projection, false);
+    engine::math::Vec3 const camera_position{};
+
+    GIVEN("A grid facing the camera that is taller than the frustum") {
+        std::vector<engine::math::Vec3> positions;
+        std::vector<uint32_t>           indices;
+        make_grid(10.f, false, positions, indices);
+        auto const clusters =
+                engine::MeshClusters::build(indices, positions, false);
+
+        WHEN("We cull its clusters") {
+            std::vector<engine::IndexRange> visible;
+            clusters.cull(frustum, camera_position, visible);
+
+            THEN("Only the clusters inside the frustum are left") {
+                REQUIRE(count_indices(visible) > 0);
+                REQUIRE(count_indices(visible) < indices.size());
+            }
+
+            THEN("Clusters that follow each other are merged") {
+                REQUIRE(visible.size() == 1);
+            }
+        }
+
+        WHEN("We move it away with its model matrix and cull in its space") {
+            constexpr std::array<float, 4 * 4> model{
+                    1.f, 0.f, 0.f,   0.f,//
+                    0.f, 1.f, 0.f,   0.f,//
+                    0.f, 0.f, 1.f,   0.f,//
+                    0.f, 0.f, 200.f, 1.f
+            };
+
+            std::vector<engine::IndexRange> visible;
+            clusters.cull(
+                    frustum.to_local_space(model),
+                    engine::math::Vec3{0.f, 0.f, -200.f}, visible
+            );
+
+            THEN("Everything is beyond the far plane") {
+                REQUIRE(visible.empty());
+            }
+        }
+    }
+
+    GIVEN("A grid facing away from the camera") {
+        std::vector<engine::math::Vec3> positions;
+        std::vector<uint32_t>           indices;
+        make_grid(10.f, true, positions, indices);
+        auto const clusters =
+                engine::MeshClusters::build(indices, positions, false);
+
+        WHEN("We cull its clusters") {
+            std::vector<engine::IndexRange> visible;
+            clusters.cull(frustum, camera_position, visible);
+
+            THEN("All of them are back-facing") {
+                REQUIRE(visible.empty());
+            }
+        }
+
+        WHEN("Its clusters are double sided") {
+            auto const double_sided =
+                    engine::MeshClusters::build(indices, positions, true);
+
+            std::vector<engine::IndexRange> visible;
+            double_sided.cull(frustum, camera_position, visible);
+
+            THEN("Their back faces are visible") {
+                REQUIRE(count_indices(visible) > 0);
+            }
+        }
+    }
+}
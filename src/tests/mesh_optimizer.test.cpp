@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <math/vec.h>
+#include <mesh_processing/mesh_optimizer.h>
+#include <random>
+#include <vector>
+
+namespace {
+    using Triangle = std::array<uint32_t, 3>;
+
+    // Triangles with their corners rotated so that the smallest index comes first, to compare triangle sets.
+    [[nodiscard]]
+    std::vector<Triangle> get_sorted_triangles(
+            std::vector<uint32_t> const &indices,
+            std::vector<uint32_t> const &vertex_ids
+    ) {
+        std::vector<Triangle> triangles;
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            Triangle triangle{
+                    vertex_ids[indices[i]], vertex_ids[indices[i + 1]],
+                    vertex_ids[indices[i + 2]]
+            };
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            triangles.push_back(triangle);
+        }
+        std::ranges::sort(triangles);
+
+        return triangles;
+    }
+
+    struct GridVertex final {
+        float    x_, y_, z_;
+        uint32_t id_;
+    };
+}// namespace
+
+SCENARIO("Simulating the vertex cache") {
+    GIVEN("Two triangles sharing an edge") {
+        std::vector<uint32_t> const indices{0, 1, 2, 2, 1, 3};
+
+        WHEN("We analyze them") {
+            auto const statistics =
+                    engine::mesh_processing::analyze_vertex_cache(indices, 4);
+
+            THEN("Every vertex is transformed once") {
+                REQUIRE(statistics.vertices_transformed_ == 4);
+                REQUIRE(statistics.get_acmr() == 2.f);
+                REQUIRE(statistics.get_atvr() == 1.f);
+            }
+        }
+    }
+}
+
+SCENARIO("Welding duplicate vertices") {
+    GIVEN("Vertices with duplicates") {
+        using engine::math::Vec3;
+        std::vector<Vec3> const positions{
+                Vec3{0.f, 0.f, 0.f}, Vec3{1.f, 0.f, 0.f}, Vec3{0.f, 0.f, 0.f},
+                Vec3{0.f, 1.f, 0.f}, Vec3{1.f, 0.f, 0.f},
+        };
+
+        WHEN("We weld them") {
+            auto const remap = engine::mesh_processing::weld_vertices(
+                    std::as_bytes(std::span{positions}), sizeof(Vec3)
+            );
+
+            THEN("The duplicates map to the first occurrence") {
+                REQUIRE(remap.vertex_count_ == 3);
+                REQUIRE(remap.remap_ == std::vector<uint32_t>{0, 1, 0, 2, 1});
+            }
+        }
+    }
+}
+
+SCENARIO("Reordering vertices for fetching") {
+    GIVEN("Indices that use vertices out of order and skip one") {
+        std::vector<uint32_t> indices{3, 1, 4, 4, 1, 0};
+
+        WHEN("We remap them") {
+            auto const remap =
+                    engine::mesh_processing::remap_for_fetch(indices, 5);
+            engine::mesh_processing::remap_indices(indices, remap);
+
+            THEN("Vertices are numbered by first use and the unused one is "
+                 "removed") {
+                REQUIRE(remap.vertex_count_ == 4);
+                REQUIRE(remap.remap_[2] ==
+                        engine::mesh_processing::VertexRemap::removed_vertex);
+                REQUIRE(indices == std::vector<uint32_t>{0, 1, 2, 2, 1, 3});
+            }
+        }
+    }
+}
+
+SCENARIO("Optimizing a mesh") {
+    GIVEN("A grid with its triangles in random order") {
+        constexpr uint32_t      size = 32;
+        std::vector<GridVertex> vertices;
+        for (uint32_t y = 0; y <= size; ++y) {
+            for (uint32_t x = 0; x <= size; ++x) {
+                vertices.push_back(
+                        {static_cast<float>(x), static_cast<float>(y), 0.f,
+                         static_cast<uint32_t>(vertices.size())}
+                );
+            }
+        }
+
+        std::vector<Triangle> triangles;
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                uint32_t const corner = y * (size + 1) + x;
+                uint32_t const below  = corner + size + 1;
+                triangles.push_back({corner, below, corner + 1});
+                triangles.push_back({corner + 1, below, below + 1});
+            }
+        }
+        std::ranges::shuffle(triangles, std::mt19937{42});
+
+        std::vector<uint32_t> indices;
+        for (auto const &triangle : triangles) {
+            indices.insert(indices.end(), triangle.begin(), triangle.end());
+        }
+
+        std::vector<uint32_t> original_ids(vertices.size());
+        for (auto const &vertex : vertices) {
+            original_ids[vertex.id_] = vertex.id_;
+        }
+        auto const original_triangles =
+                get_sorted_triangles(indices, original_ids);
+
+        WHEN("We optimize it") {
+            auto const report = engine::mesh_processing::optimize_mesh(
+                    vertices, indices,
+                    [](GridVertex const &vertex) {
+                        return engine::math::Vec3{
+                                vertex.x_, vertex.y_, vertex.z_
+                        };
+                    }
+            );
+
+            THEN("The vertex cache is used much better") {
+                REQUIRE(report.cache_after_.get_acmr() <
+                        report.cache_before_.get_acmr() * 0.5f);
+                REQUIRE(report.cache_after_.get_acmr() < 1.f);
+            }
+
+            THEN("The same triangles are drawn") {
+                std::vector<uint32_t> vertex_ids;
+                for (auto const &vertex : vertices) {
+                    vertex_ids.push_back(vertex.id_);
+                }
+
+                REQUIRE(get_sorted_triangles(indices, vertex_ids) ==
+                        original_triangles);
+            }
+
+            THEN("Vertices are stored in the order they're first used") {
+                auto const remap = engine::mesh_processing::remap_for_fetch(
+                        indices, vertices.size()
+                );
+                for (uint32_t vertex = 0; vertex < remap.remap_.size();
+                     ++vertex) {
+                    REQUIRE(remap.remap_[vertex] == vertex);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <texture_processing/mip_chain.h>
+#include <vector>
+
+using engine::texture_processing::ColorSpace;
+
+namespace {
+    // RGBA texels alternating between black and white, with alternating alpha.
+    [[nodiscard]]
+    std::vector<uint8_t> make_checkerboard(uint32_t size) {
+        std::vector<uint8_t> pixels;
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                uint8_t const value = (x + y) % 2 == 0 ? 0 : 255;
+                pixels.insert(pixels.end(), {value, value, value, value});
+            }
+        }
+
+        return pixels;
+    }
+}// namespace
+
+SCENARIO("Building the mip chain of an image") {
+    GIVEN("An image with odd, different sizes") {
+        std::vector<uint8_t> const pixels(5 * 3 * 3, 100);
+
+        WHEN("We build its mip chain") {
+            auto const chain = engine::texture_processing::build_mip_chain(
+                    pixels, 5, 3, 3, ColorSpace::Srgb
+            );
+
+            THEN("The levels halve down to 1x1 and are stored back to back") {
+                REQUIRE(engine::texture_processing::get_mip_count(5, 3) == 3);
+                REQUIRE(chain.levels_.size() == 3);
+                REQUIRE(chain.levels_[1].width_ == 2);
+                REQUIRE(chain.levels_[1].height_ == 1);
+                REQUIRE(chain.levels_[2].width_ == 1);
+                REQUIRE(chain.levels_[2].height_ == 1);
+                REQUIRE(chain.levels_[1].offset_ == 5 * 3 * 3);
+                REQUIRE(chain.data_.size() == (5 * 3 + 2 + 1) * 3);
+            }
+
+            THEN("The first level is the image itself") {
+                auto const first = chain.get_level_data(0);
+                REQUIRE(std::vector(first.begin(), first.end()) == pixels);
+            }
+        }
+    }
+
+    GIVEN("Uniform images of every value") {
+        THEN("Every level keeps that value") {
+            for (uint32_t value = 0; value < 256; ++value) {
+                std::vector<uint8_t> const pixels(
+                        8 * 8 * 4, static_cast<uint8_t>(value)
+                );
+                auto const chain = engine::texture_processing::build_mip_chain(
+                        pixels, 8, 8, 4, ColorSpace::Srgb
+                );
+
+                REQUIRE(std::ranges::all_of(chain.data_, [&](uint8_t texel) {
+                    return texel == value;
+                }));
+            }
+        }
+    }
+
+    GIVEN("A black and white checkerboard") {
+        auto const pixels = make_checkerboard(64);
+
+        WHEN("Its colors are sRGB encoded") {
+            auto const chain = engine::texture_processing::build_mip_chain(
+                    pixels, 64, 64, 4, ColorSpace::Srgb
+            );
+
+            THEN("Colors average to half the light and alpha to half") {
+                auto const last =
+                        chain.get_level_data(chain.levels_.size() - 1);
+                REQUIRE(last[0] == 188);
+                REQUIRE(last[1] == 188);
+                REQUIRE(last[2] == 188);
+                REQUIRE(last[3] == 128);
+            }
+        }
+
+        WHEN("Its colors are linear") {
+            auto const chain = engine::texture_processing::build_mip_chain(
+                    pixels, 64, 64, 4, ColorSpace::Linear
+            );
+
+            THEN("All channels average to half") {
+                REQUIRE(std::ranges::all_of(
+                        chain.get_level_data(1),
+                        [](uint8_t texel) { return texel == 128; }
+                ));
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+#include <graphics/occlusion_buffer.h>
+#include <vector>
+
+#include "test_scene.h"
+
+using test_scene::identity;
+using test_scene::make_box;
+using test_scene::projection;
+
+SCENARIO("Occlusion culling against a rasterized wall") {
+    GIVEN("A wall covering the middle of the screen at a distance of 10") {
+        std::vector<engine::math::Vec3> const wall_positions{
+                engine::math::Vec3{-5.f, -5.f, 10.f},
+                engine::math::Vec3{5.f, -5.f, 10.f},
+                engine::math::Vec3{5.f, 5.f, 10.f},
+                engine::math::Vec3{-5.f, 5.f, 10.f}
+        };
+        std::vector<uint32_t> const wall_indices{0, 1, 2, 0, 2, 3};
+
+        engine::OcclusionBuffer buffer{64, 32};
+        buffer.begin(projection);
+        buffer.rasterize(wall_positions, wall_indices, identity);
+        buffer.build_hierarchy();
+
+        THEN("The wall is written into the depth buffer") {
+            REQUIRE(buffer.get_depth(32, 16) < 1.f);
+            REQUIRE(buffer.get_depth(0, 0) == 1.f);
+        }
+
+        THEN("A box behind the wall is occluded") {
+            REQUIRE(buffer.is_occluded(
+                    make_box(engine::math::Vec3{0.f, 0.f, 20.f}, 2.f)
+            ));
+        }
+
+        THEN("A box in front of the wall is not occluded") {
+            REQUIRE_FALSE(buffer.is_occluded(
+                    make_box(engine::math::Vec3{0.f, 0.f, 5.f}, 2.f)
+            ));
+        }
+
+        THEN("A box behind the wall but sticking out from it is not occluded") {
+            REQUIRE_FALSE(buffer.is_occluded(
+                    make_box(engine::math::Vec3{8.f, 0.f, 20.f}, 4.f)
+            ));
+        }
+
+        THEN("A box crossing the near plane is not occluded") {
+            REQUIRE_FALSE(buffer.is_occluded(
+                    make_box(engine::math::Vec3{0.f, 0.f, 0.f}, 2.f)
+            ));
+        }
+    }
+}
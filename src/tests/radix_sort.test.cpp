@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <misc/radix_sort.h>
+#include <random>
+#include <vector>
+
+namespace {
+    struct Item final {
+        uint64_t key;
+        uint32_t original_index;
+    };
+}// namespace
+
+SCENARIO("Radix sorting items by a 64-bit key") {
+    GIVEN("Items with random keys, many of them duplicated") {
+        std::mt19937_64                         rng{1234};
+        std::uniform_int_distribution<uint64_t> key_dist{0, 64};
+
+        std::vector<Item> items(1000);
+        for (uint32_t i = 0; i < items.size(); ++i) {
+            // Spread the few distinct values over high and low bytes.
+            auto const value = key_dist(rng);
+            items[i]         = Item{(value << 40) | (value & 0x7), i};
+        }
+
+        WHEN("We radix sort them") {
+            std::vector<Item> scratch;
+            engine::radix_sort(
+                    std::span{items}, scratch,
+                    [](Item const &item) { return item.key; }
+            );
+
+            THEN("The keys are in ascending order") {
+                REQUIRE(std::ranges::is_sorted(items, {}, &Item::key));
+            }
+
+            AND_THEN("Items with equal keys keep their original order") {
+                for (std::size_t i = 1; i < items.size(); ++i) {
+                    if (items[i - 1].key == items[i].key) {
+                        REQUIRE(items[i - 1].original_index <
+                                items[i].original_index);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("Items that all share the same key") {
+        std::vector<Item> items{{42, 0}, {42, 1}, {42, 2}};
+
+        WHEN("We radix sort them") {
+            std::vector<Item> scratch;
+            engine::radix_sort(
+                    std::span{items}, scratch,
+                    [](Item const &item) { return item.key; }
+            );
+
+            THEN("Their order is unchanged") {
+                REQUIRE(items[0].original_index == 0);
+                REQUIRE(items[1].original_index == 1);
+                REQUIRE(items[2].original_index == 2);
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <misc/range_allocator.h>
+
+SCENARIO("Allocating ranges from a range allocator") {
+    GIVEN("An allocator with a capacity of 100") {
+        engine::RangeAllocator allocator{100};
+
+        WHEN("We allocate a few ranges") {
+            auto const first  = allocator.allocate(10);
+            auto const second = allocator.allocate(20);
+            auto const third  = allocator.allocate(30);
+
+            THEN("They are laid out back to back") {
+                REQUIRE(first == 0u);
+                REQUIRE(second == 10u);
+                REQUIRE(third == 30u);
+                REQUIRE(allocator.get_free_size() == 40);
+            }
+
+            AND_WHEN("We allocate more than is left") {
+                THEN("The allocation fails") {
+                    REQUIRE_FALSE(allocator.allocate(41).has_value());
+                }
+            }
+
+            AND_WHEN("We free the middle range") {
+                allocator.free(*second, 20);
+
+                THEN("A smaller allocation reuses its space") {
+                    REQUIRE(allocator.allocate(15) == 10u);
+                }
+
+                THEN("A larger allocation goes after the last range") {
+                    REQUIRE(allocator.allocate(25) == 60u);
+                }
+            }
+
+            AND_WHEN("We free all ranges in a different order") {
+                allocator.free(*first, 10);
+                allocator.free(*third, 30);
+                allocator.free(*second, 20);
+
+                THEN("The free space is merged back into a single range") {
+                    REQUIRE(allocator.get_free_size() == 100);
+                    REQUIRE(allocator.get_free_range_count() == 1);
+                    REQUIRE(allocator.allocate(100) == 0u);
+                }
+            }
+        }
+
+        WHEN("We allocate an empty range") {
+            THEN("The allocation fails") {
+                REQUIRE_FALSE(allocator.allocate(0).has_value());
+            }
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <math/vec.h>
+#include <mesh_processing/simplification.h>
+#include <numbers>
+#include <vector>
+
+namespace {
+    // Triangles that don't repeat an index and only use existing vertices.
+    [[nodiscard]]
+    bool is_valid(
+            std::vector<uint32_t> const &indices, std::size_t vertex_count
+    ) {
+        if (indices.size() % 3 != 0)
+            return false;
+
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            uint32_t const a = indices[i];
+            uint32_t const b = indices[i + 1];
+            uint32_t const c = indices[i + 2];
+            if (a == b || b == c || a == c || a >= vertex_count ||
+                b >= vertex_count || c >= vertex_count)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Closed latitude-longitude sphere with single vertices at the poles.
+    void make_sphere(
+            float radius, std::vector<engine::math::Vec3> &positions,
+            std::vector<uint32_t> &indices
+    ) {
+        constexpr uint32_t rings    = 32;
+        constexpr uint32_t segments = 64;
+        constexpr float    pi       = std::numbers::pi_v<float>;
+
+        positions.emplace_back(0.f, radius, 0.f);
+        for (uint32_t ring = 1; ring < rings; ++ring) {
+            float const polar = pi * static_cast<float>(ring) / rings;
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                float const azimuth =
+                        2.f * pi * static_cast<float>(segment) / segments;
+                positions.emplace_back(
+                        radius * std::sin(polar) * std::cos(azimuth),
+                        radius * std::cos(polar),
+                        radius * std::sin(polar) * std::sin(azimuth)
+                );
+            }
+        }
+        positions.emplace_back(0.f, -radius, 0.f);
+
+        auto const ring_vertex = [](uint32_t ring, uint32_t segment) {
+            return 1 + (ring - 1) * segments + segment % segments;
+        };
+        auto const bottom = static_cast<uint32_t>(positions.size() - 1);
+
+        for (uint32_t segment = 0; segment < segments; ++segment) {
+            indices.insert(
+                    indices.end(),
+                    {0, ring_vertex(1, segment + 1), ring_vertex(1, segment)}
+            );
+            indices.insert(
+                    indices.end(), {bottom, ring_vertex(rings - 1, segment),
+                                    ring_vertex(rings - 1, segment + 1)}
+            );
+        }
+        for (uint32_t ring = 1; ring + 1 < rings; ++ring) {
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                uint32_t const a = ring_vertex(ring, segment);
+                uint32_t const b = ring_vertex(ring, segment + 1);
+                uint32_t const c = ring_vertex(ring + 1, segment);
+                uint32_t const d = ring_vertex(ring + 1, segment + 1);
+                indices.insert(indices.end(), {a, b, c, b, d, c});
+            }
+        }
+    }
+}// namespace
+
+SCENARIO("Simplifying a flat grid") {
+    GIVEN("A grid of quads in a plane") {
+        constexpr uint32_t              size = 32;
+        std::vector<engine::math::Vec3> positions;
+        std::vector<uint32_t>           indices;
+        for (uint32_t y = 0; y <= size; ++y) {
+            for (uint32_t x = 0; x <= size; ++x) {
+                positions.emplace_back(
+                        static_cast<float>(x), static_cast<float>(y), 0.f
+                );
+            }
+        }
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                uint32_t const corner = y * (size + 1) + x;
+                uint32_t const below  = corner + size + 1;
+                indices.insert(
+                        indices.end(), {corner, below, corner + 1, corner + 1,
+                                        below, below + 1}
+                );
+            }
+        }
+
+        WHEN("We simplify it to a quarter of its triangles") {
+            auto const simplified = engine::mesh_processing::simplify(
+                    indices, positions, indices.size() / 4
+            );
+
+            THEN("The interior collapses without error") {
+                REQUIRE(is_valid(simplified.indices_, positions.size()));
+                REQUIRE(simplified.indices_.size() <= indices.size() / 4);
+                REQUIRE(simplified.error_ < 1e-3f);
+            }
+
+            THEN("The corners of the border are kept") {
+                for (uint32_t const corner :
+                     {0u, size, size * (size + 1), (size + 1) * (size + 1) - 1
+                     }) {
+                    REQUIRE(std::ranges::find(simplified.indices_, corner) !=
+                            simplified.indices_.end());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Simplifying a curved surface") {
+    GIVEN("A closed sphere") {
+        constexpr float                 radius = 10.f;
+        std::vector<engine::math::Vec3> positions;
+        std::vector<uint32_t>           indices;
+        make_sphere(radius, positions, indices);
+
+        WHEN("We simplify it with an error limit") {
+            auto const simplified = engine::mesh_processing::simplify(
+                    indices, positions, 0, 0.1f
+            );
+
+            THEN("It stops before the error gets too large") {
+                REQUIRE(is_valid(simplified.indices_, positions.size()));
+                REQUIRE(simplified.indices_.size() < indices.size());
+                REQUIRE(simplified.error_ <= 0.1f);
+            }
+        }
+
+        WHEN("We generate levels of detail") {
+            auto const lods = engine::mesh_processing::generate_lods(
+                    indices, positions, 4
+            );
+
+            THEN("Each level is coarser and less accurate than the previous") {
+                REQUIRE(lods.size() == 4);
+
+                std::size_t previous_size  = indices.size();
+                float       previous_error = 0.f;
+                for (auto const &lod : lods) {
+                    REQUIRE(is_valid(lod.indices_, positions.size()));
+                    REQUIRE(lod.indices_.size() < previous_size);
+                    REQUIRE(lod.error_ >= previous_error);
+                    REQUIRE(lod.error_ < radius / 2.f);
+
+                    previous_size  = lod.indices_.size();
+                    previous_error = lod.error_;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef TEST_SCENE_H
+#define TEST_SCENE_H
+
+#include <array>
+#include <math/aabb.h>
+
+// Camera and geometry shared by the culling tests.
+namespace test_scene {
+    // Left-handed perspective projection with a 90 degree field of view and [0, 1] depth, laid out like bx::mtxProj.
+    inline constexpr float near_plane = 0.1f;
+    inline constexpr float far_plane  = 100.f;
+
+    inline constexpr std::array<float, 4 * 4> projection{
+            1.f, 0.f, 0.f, 0.f,//
+            0.f, 1.f, 0.f, 0.f,//
+            0.f, 0.f, far_plane / (far_plane - near_plane), 1.f,//
+            0.f, 0.f, -near_plane * far_plane / (far_plane - near_plane), 0.f
+    };
+
+    inline constexpr std::array<float, 4 * 4> identity{
+            1.f, 0.f, 0.f, 0.f,//
+            0.f, 1.f, 0.f, 0.f,//
+            0.f, 0.f, 1.f, 0.f,//
+            0.f, 0.f, 0.f, 1.f
+    };
+
+    [[nodiscard]]
+    inline engine::math::Aabb
+    make_box(engine::math::Vec3 const &center, float size) {
+        engine::math::Vec3 const half_size{size / 2.f, size / 2.f, size / 2.f};
+
+        return {center - half_size, center + half_size};
+    }
+}// namespace test_scene
+
+#endif//TEST_SCENE_H
@@ -0,0 +1,109 @@
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <graphics/texture_residency.h>
+
+namespace {
+    // A 1024x1024 RGBA8 texture with all of its levels.
+    constexpr std::size_t full_size = 1024 * 1024 * 4 * 4 / 3;
+    constexpr uint32_t    mip_count = 11;
+}// namespace
+
+SCENARIO("Estimating the levels a texture needs on screen") {
+    GIVEN("A 1024x1024 texture") {
+        THEN("Drawing it larger than its size needs every level") {
+            REQUIRE(engine::get_required_first_mip(
+                            1024, 1024, mip_count, 2000.f
+                    ) == 0);
+        }
+
+        THEN("Drawing it at a quarter of its size needs the third level on") {
+            REQUIRE(engine::get_required_first_mip(
+                            1024, 1024, mip_count, 256.f
+                    ) == 2);
+        }
+
+        THEN("Sizes in between keep the sharper level") {
+            REQUIRE(engine::get_required_first_mip(
+                            1024, 1024, mip_count, 300.f
+                    ) == 1);
+        }
+
+        THEN("Drawing it below a pixel only needs the smallest level") {
+            REQUIRE(engine::get_required_first_mip(
+                            1024, 1024, mip_count, 0.5f
+                    ) == mip_count - 1);
+        }
+    }
+}
+
+SCENARIO("Keeping the levels of a texture as its size on screen changes") {
+    GIVEN("A 1024x1024 texture with its second level on resident") {
+        THEN("Levels it needs are added right away") {
+            REQUIRE(engine::get_kept_first_mip(
+                            1024, 1024, mip_count, 1, 2000.f, false
+                    ) == 0);
+        }
+
+        THEN("Levels aren't dropped before it may drop them") {
+            REQUIRE(engine::get_kept_first_mip(
+                            1024, 1024, mip_count, 1, 100.f, false
+                    ) == 1);
+        }
+
+        THEN("Levels aren't dropped just past the size that needs them") {
+            REQUIRE(engine::get_kept_first_mip(
+                            1024, 1024, mip_count, 1, 250.f, true
+                    ) == 1);
+        }
+
+        THEN("Levels are dropped once it is clearly smaller") {
+            REQUIRE(engine::get_kept_first_mip(
+                            1024, 1024, mip_count, 1, 100.f, true
+                    ) == 2);
+        }
+    }
+}
+
+SCENARIO("Fitting textures into a residency budget") {
+    GIVEN("Three textures last used in different frames") {
+        std::array<engine::TextureResidency, 3> textures{
+                engine::TextureResidency{full_size, mip_count, 0, 10},
+                engine::TextureResidency{full_size, mip_count, 0, 5},
+                engine::TextureResidency{full_size, mip_count, 0, 10}
+        };
+
+        WHEN("They fit into the budget") {
+            auto const total =
+                    engine::fit_residency_budget(textures, 3 * full_size);
+
+            THEN("They keep all of their levels") {
+                REQUIRE(total == 3 * full_size);
+                for (auto const &texture : textures) {
+                    REQUIRE(texture.first_mip_ == 0);
+                }
+            }
+        }
+
+        WHEN("One of them has to shrink") {
+            auto const total =
+                    engine::fit_residency_budget(textures, 5 * full_size / 2);
+
+            THEN("The least recently used one drops its largest level") {
+                REQUIRE(total <= 5 * full_size / 2);
+                REQUIRE(textures[1].first_mip_ == 1);
+                REQUIRE(textures[0].first_mip_ == 0);
+                REQUIRE(textures[2].first_mip_ == 0);
+            }
+        }
+
+        WHEN("The budget is too small for anything but the smallest levels") {
+            engine::fit_residency_budget(textures, 0);
+
+            THEN("Every texture keeps its smallest level") {
+                for (auto const &texture : textures) {
+                    REQUIRE(texture.first_mip_ == mip_count - 1);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <latch>
+#include <misc/thread_pool.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+SCENARIO("Running tasks on a thread pool") {
+    GIVEN("A pool with a few workers") {
+        engine::ThreadPool pool{3};
+
+        REQUIRE(pool.get_worker_count() == 3);
+
+        WHEN("We run a parallel for over many indices") {
+            std::vector<int> calls(1000);
+            pool.parallel_for(calls.size(), [&](std::size_t index) {
+                ++calls[index];
+            });
+
+            THEN("Every index was visited exactly once") {
+                REQUIRE(std::ranges::all_of(calls, [](int count) {
+                    return count == 1;
+                }));
+            }
+        }
+
+        WHEN("Tasks of a parallel for run nested parallel fors") {
+            std::atomic<int> total{};
+            pool.parallel_for(8, [&](std::size_t) {
+                pool.parallel_for(8, [&](std::size_t) { ++total; });
+            });
+
+            THEN("All nested tasks ran without deadlocking") {
+                REQUIRE(total == 64);
+            }
+        }
+
+        WHEN("The task of the calling thread throws") {
+            std::atomic<int> running{};
+            std::atomic<int> finished{};
+
+            auto const run = [&] {
+                pool.parallel_for(64, [&](std::size_t index) {
+                    ++running;
+                    if (index == 0) {
+                        --running;
+                        throw std::runtime_error{"Task failed"};
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds{50});
+                    ++finished;
+                    --running;
+                });
+            };
+
+            THEN("The error is rethrown once no task is running anymore") {
+                REQUIRE_THROWS_AS(run(), std::runtime_error);
+                REQUIRE(running == 0);
+
+                auto const finished_on_return = finished.load();
+                pool.parallel_for(8, [](std::size_t) {});
+                REQUIRE(finished == finished_on_return);
+            }
+        }
+
+        WHEN("Another job is queued while the calling thread waits") {
+            std::thread::id  unrelated_thread;
+            std::atomic<int> total{};
+            {
+                std::latch         release{1};
+                engine::ThreadPool single_pool{1};
+
+                single_pool.enqueue([&release] { release.wait(); });
+                single_pool.enqueue([&unrelated_thread] {
+                    unrelated_thread = std::this_thread::get_id();
+                });
+
+                single_pool.parallel_for(16, [&](std::size_t) { ++total; });
+                release.count_down();
+            }
+
+            THEN("Only the tasks of the call run on the calling thread") {
+                REQUIRE(total == 16);
+                REQUIRE(unrelated_thread != std::thread::id{});
+                REQUIRE(unrelated_thread != std::this_thread::get_id());
+            }
+        }
+
+        WHEN("We enqueue jobs and destroy the pool") {
+            std::atomic<int> total{};
+            {
+                engine::ThreadPool scoped_pool{2};
+                for (int i = 0; i < 100; ++i) {
+                    scoped_pool.enqueue([&total] { ++total; });
+                }
+            }
+
+            THEN("The queued jobs were finished first") {
+                REQUIRE(total == 100);
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <array>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <graphics/vertex_packing.h>
+#include <limits>
+
+SCENARIO("Converting floats to half floats") {
+    GIVEN("Values that are exactly representable as a half") {
+        constexpr std::array values{
+                0.f, 1.f, -2.f, 0.5f, 65504.f, 0.000061035156f
+        };
+
+        THEN("They survive a round trip unchanged") {
+            for (float const value : values) {
+                REQUIRE(engine::half_to_float(engine::float_to_half(value)) ==
+                        value);
+            }
+        }
+    }
+
+    GIVEN("Known bit patterns") {
+        THEN("The conversion matches them") {
+            REQUIRE(engine::float_to_half(1.f) == 0x3c00);
+            REQUIRE(engine::float_to_half(-2.f) == 0xc000);
+            REQUIRE(engine::float_to_half(65504.f) == 0x7bff);
+            // The smallest subnormal half.
+            REQUIRE(engine::float_to_half(5.9604645e-8f) == 0x0001);
+        }
+    }
+
+    GIVEN("Values out of the range of a half") {
+        THEN("They become infinities or NaN") {
+            REQUIRE(engine::float_to_half(70000.f) == 0x7c00);
+            REQUIRE(engine::float_to_half(-70000.f) == 0xfc00);
+            REQUIRE(std::isnan(engine::half_to_float(engine::float_to_half(
+                    std::numeric_limits<float>::quiet_NaN()
+            ))));
+        }
+    }
+
+    GIVEN("Texture coordinates in [0, 1]") {
+        THEN("The round trip error stays within half precision") {
+            for (int i = 0; i <= 1000; ++i) {
+                float const value = static_cast<float>(i) / 1000.f;
+                float const round_trip =
+                        engine::half_to_float(engine::float_to_half(value));
+
+                REQUIRE(std::abs(round_trip - value) <= 0.00049f);
+            }
+        }
+    }
+}
+
+SCENARIO("Quantizing positions to the bounds of a primitive") {
+    GIVEN("The quantization of some bounds") {
+        engine::math::Aabb const bounds{
+                engine::math::Vec3{-10.f, 0.f, 5.f},
+                engine::math::Vec3{30.f, 2.f, 5.f}
+        };
+        auto const quantization =
+                engine::PositionQuantization::from_bounds(bounds);
+
+        WHEN("We quantize the corners of the bounds") {
+            auto const min = quantization.quantize(bounds.min_);
+            auto const max = quantization.quantize(bounds.max_);
+
+            THEN("They map to the ends of the 16-bit range") {
+                REQUIRE(min[0] == -32767);
+                REQUIRE(min[1] == -32767);
+                REQUIRE(max[0] == 32767);
+                REQUIRE(max[1] == 32767);
+            }
+
+            THEN("The flat axis maps to zero") {
+                REQUIRE(min[2] == 0);
+                REQUIRE(max[2] == 0);
+            }
+        }
+
+        WHEN("We quantize and dequantize a position inside the bounds") {
+            engine::math::Vec3 const position{3.3f, 1.7f, 5.f};
+            auto const               round_trip = quantization.dequantize(
+                    quantization.quantize(position)
+            );
+
+            THEN("The error is within half a quantization step") {
+                REQUIRE(round_trip.get_x() ==
+                        Catch::Approx(position.get_x()).margin(20.f / 32767.f));
+                REQUIRE(round_trip.get_y() ==
+                        Catch::Approx(position.get_y()).margin(1.f / 32767.f));
+                REQUIRE(round_trip.get_z() == Catch::Approx(position.get_z()));
+            }
+        }
+
+        WHEN("We fold the dequantization into a model matrix") {
+            // Scales by 2 and translates by (1, 2, 3), laid out like bx matrices.
+            constexpr std::array<float, 4 * 4> model{
+                    2.f, 0.f, 0.f, 0.f,//
+                    0.f, 2.f, 0.f, 0.f,//
+                    0.f, 0.f, 2.f, 0.f,//
+                    1.f, 2.f, 3.f, 1.f
+            };
+            auto const combined = quantization.apply(model);
+
+            std::array<int16_t, 3> const quantized{16000, -8000, 0};
+            auto const normalized = engine::math::Vec3{
+                    engine::dequantize_snorm16(quantized[0]),
+                    engine::dequantize_snorm16(quantized[1]),
+                    engine::dequantize_snorm16(quantized[2])
+            };
+            auto const expected =
+                    quantization.dequantize(quantized) * 2.f +
+                    engine::math::Vec3{1.f, 2.f, 3.f};
+
+            THEN("Transforming normalized positions by it matches "
+                 "dequantizing first") {
+                for (std::size_t col = 0; col < 3; ++col) {
+                    float const transformed =
+                            normalized.get_x() * combined[col] +
+                            normalized.get_y() * combined[4 + col] +
+                            normalized.get_z() * combined[8 + col] +
+                            combined[12 + col];
+
+                    REQUIRE(transformed == Catch::Approx(expected[col]));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,777 @@
+#include "block_compression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "math/vec.h"
+
+namespace engine::texture_processing {
+    namespace {
+        constexpr std::size_t texel_count = block_texels * block_texels;
+        constexpr uint32_t    block_rows_per_job = 8;
+        constexpr int         power_iterations   = 8;
+        constexpr int         refinements        = 2;
+
+        template<std::size_t N>
+        using Color = math::Vec<float, N>;
+
+        template<std::size_t N>
+        using BlockColors = std::array<Color<N>, texel_count>;
+
+        // Weights of the second endpoint for each index.
+        constexpr std::array<float, 4> bc1_weights{
+                0.f, 1.f, 1.f / 3.f, 2.f / 3.f
+        };
+        constexpr std::array<int, 16>  bc7_weights{
+                0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+        };
+        constexpr uint32_t bc7_mode6_bits = 1u << 6;
+
+        template<std::size_t N>
+        [[nodiscard]]
+        BlockColors<N> get_colors(BlockTexels const &texels) {
+            BlockColors<N> colors;
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                for (std::size_t channel = 0; channel < N; ++channel) {
+                    colors[i][channel] = texels[i * 4 + channel];
+                }
+            }
+
+            return colors;
+        }
+
+        template<std::size_t N>
+        [[nodiscard]]
+        Color<N> clamp_color(Color<N> color) {
+            for (std::size_t channel = 0; channel < N; ++channel) {
+                color[channel] = std::clamp(color[channel], 0.f, 255.f);
+            }
+
+            return color;
+        }
+
+        // The ends of the principal axis of the colors, where it leaves their extent. The first one lies at the
+        // positive end of the axis.
+        template<std::size_t N>
+        [[nodiscard]]
+        std::pair<Color<N>, Color<N>>
+        fit_endpoints(BlockColors<N> const &colors) {
+            Color<N> mean{};
+            Color<N> min_color{colors[0]};
+            Color<N> max_color{colors[0]};
+            for (auto const &color : colors) {
+                mean += color;
+                for (std::size_t channel = 0; channel < N; ++channel) {
+                    min_color[channel] =
+                            std::min(min_color[channel], color[channel]);
+                    max_color[channel] =
+                            std::max(max_color[channel], color[channel]);
+                }
+            }
+            mean /= static_cast<float>(texel_count);
+
+            std::array<std::array<float, N>, N> covariance{};
+            for (auto const &color : colors) {
+                auto const offset = color - mean;
+                for (std::size_t row = 0; row < N; ++row) {
+                    for (std::size_t column = 0; column < N; ++column) {
+                        covariance[row][column] += offset[row] * offset[column];
+                    }
+                }
+            }
+
+            // Power iteration, starting from the diagonal of the bounding box.
+            auto axis = max_color - min_color;
+            if (axis.get_magnitude_squared() == 0.f)
+                return {mean, mean};
+
+            for (int iteration = 0; iteration < power_iterations; ++iteration) {
+                Color<N> next{};
+                for (std::size_t row = 0; row < N; ++row) {
+                    for (std::size_t column = 0; column < N; ++column) {
+                        next[row] += covariance[row][column] * axis[column];
+                    }
+                }
+
+                float const length = next.get_magnitude();
+                if (length == 0.f)
+                    break;
+                axis = next / length;
+            }
+            axis.normalize();
+
+            float min_offset = std::numeric_limits<float>::max();
+            float max_offset = std::numeric_limits<float>::lowest();
+            for (auto const &color : colors) {
+                float const offset = (color - mean).dot(axis);
+                min_offset         = std::min(min_offset, offset);
+                max_offset         = std::max(max_offset, offset);
+            }
+
+            return {clamp_color(mean + axis * max_offset),
+                    clamp_color(mean + axis * min_offset)};
+        }
+
+        // Least squares endpoints for the texels, given the weight of the second endpoint for each of them. Returns
+        // false if the weights don't determine both endpoints.
+        template<std::size_t N>
+        [[nodiscard]]
+        bool fit_to_weights(
+                BlockColors<N> const               &colors,
+                std::array<float, texel_count> const &weights,
+                Color<N> &first, Color<N> &second
+        ) {
+            float    aa{};
+            float    ab{};
+            float    bb{};
+            Color<N> ax{};
+            Color<N> bx{};
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                float const a = 1.f - weights[i];
+                float const b = weights[i];
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                ax += colors[i] * a;
+                bx += colors[i] * b;
+            }
+
+            float const determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) < 1e-6f)
+                return false;
+
+            first  = clamp_color((ax * bb - bx * ab) / determinant);
+            second = clamp_color((bx * aa - ax * ab) / determinant);
+
+            return true;
+        }
+
+        // Index of the palette entry closest to the color, and its squared distance.
+        template<std::size_t N, std::size_t P>
+        [[nodiscard]]
+        std::pair<uint32_t, float> find_closest(
+                std::array<Color<N>, P> const &palette, Color<N> const &color
+        ) {
+            uint32_t best_index{};
+            float    best_error = std::numeric_limits<float>::max();
+            for (uint32_t index = 0; index < P; ++index) {
+                float const error =
+                        (palette[index] - color).get_magnitude_squared();
+                if (error < best_error) {
+                    best_index = index;
+                    best_error = error;
+                }
+            }
+
+            return {best_index, best_error};
+        }
+
+        void write_u16(std::span<uint8_t> bytes, uint16_t value) {
+            bytes[0] = static_cast<uint8_t>(value);
+            bytes[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        [[nodiscard]]
+        uint16_t read_u16(std::span<uint8_t const> bytes) {
+            return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+        }
+
+        // Writes and reads the bits of a block from the least significant bit of the first byte on.
+        class BlockBits final {
+        public:
+            explicit BlockBits(std::span<uint8_t> bytes)
+                : bytes_{bytes} {
+                std::ranges::fill(bytes_, uint8_t{0});
+            }
+
+            void write(uint32_t value, uint32_t bit_count) {
+                for (uint32_t bit = 0; bit < bit_count; ++bit, ++position_) {
+                    if ((value >> bit) & 1)
+                        bytes_[position_ / 8] |=
+                                static_cast<uint8_t>(1u << (position_ % 8));
+                }
+            }
+
+        private:
+            std::span<uint8_t> bytes_;
+            uint32_t           position_{};
+        };
+
+        class BlockBitReader final {
+        public:
+            explicit BlockBitReader(std::span<uint8_t const> bytes)
+                : bytes_{bytes} {
+            }
+
+            [[nodiscard]]
+            uint32_t read(uint32_t bit_count) {
+                uint32_t value{};
+                for (uint32_t bit = 0; bit < bit_count; ++bit, ++position_) {
+                    value |= ((bytes_[position_ / 8] >> (position_ % 8)) & 1u)
+                             << bit;
+                }
+
+                return value;
+            }
+
+        private:
+            std::span<uint8_t const> bytes_;
+            uint32_t                 position_{};
+        };
+
+        // BC1 colors
+
+        [[nodiscard]]
+        uint16_t to_rgb565(Color<3> const &color) {
+            auto const quantize = [](float value, float max) {
+                return static_cast<uint16_t>(std::lround(value * max / 255.f));
+            };
+
+            return static_cast<uint16_t>(
+                    (quantize(color[0], 31.f) << 11) |
+                    (quantize(color[1], 63.f) << 5) | quantize(color[2], 31.f)
+            );
+        }
+
+        [[nodiscard]]
+        std::array<int, 3> from_rgb565(uint16_t value) {
+            int const r = (value >> 11) & 31;
+            int const g = (value >> 5) & 63;
+            int const b = value & 31;
+
+            return {(r << 3) | (r >> 2), (g << 2) | (g >> 4),
+                    (b << 3) | (b >> 2)};
+        }
+
+        // Colors of the four indices, as the decoder computes them.
+        [[nodiscard]]
+        std::array<std::array<int, 3>, 4>
+        get_bc1_palette(uint16_t color0, uint16_t color1) {
+            auto const first  = from_rgb565(color0);
+            auto const second = from_rgb565(color1);
+
+            std::array<std::array<int, 3>, 4> palette{first, second};
+            for (std::size_t channel = 0; channel < 3; ++channel) {
+                palette[2][channel] =
+                        (2 * first[channel] + second[channel]) / 3;
+                palette[3][channel] =
+                        (first[channel] + 2 * second[channel]) / 3;
+            }
+
+            return palette;
+        }
+
+        struct ColorBlock final {
+            uint16_t color0_;
+            uint16_t color1_;
+            uint32_t indices_;
+            float    error_;
+        };
+
+        // Always uses the four color mode, which BC3 requires, by keeping color0 above color1.
+        [[nodiscard]]
+        ColorBlock encode_color_endpoints(
+                BlockColors<3> const &colors, Color<3> const &first,
+                Color<3> const &second
+        ) {
+            uint16_t color0 = to_rgb565(first);
+            uint16_t color1 = to_rgb565(second);
+            if (color0 < color1)
+                std::swap(color0, color1);
+
+            std::array<Color<3>, 4> palette;
+            auto const              decoded = get_bc1_palette(color0, color1);
+            for (std::size_t index = 0; index < 4; ++index) {
+                palette[index] = Color<3>{
+                        static_cast<float>(decoded[index][0]),
+                        static_cast<float>(decoded[index][1]),
+                        static_cast<float>(decoded[index][2])
+                };
+            }
+
+            ColorBlock block{color0, color1, 0, 0.f};
+            // Equal endpoints would select the three color mode, every texel uses the first one.
+            if (color0 == color1) {
+                for (auto const &color : colors) {
+                    block.error_ +=
+                            (palette[0] - color).get_magnitude_squared();
+                }
+
+                return block;
+            }
+
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                auto const [index, error] = find_closest(palette, colors[i]);
+                block.indices_ |= index << (2 * i);
+                block.error_ += error;
+            }
+
+            return block;
+        }
+
+        void compress_color_block(
+                BlockTexels const &texels, std::span<uint8_t> block
+        ) {
+            auto const colors    = get_colors<3>(texels);
+            auto [first, second] = fit_endpoints(colors);
+            auto best = encode_color_endpoints(colors, first, second);
+
+            for (int refinement = 0; refinement < refinements; ++refinement) {
+                std::array<float, texel_count> weights;
+                for (std::size_t i = 0; i < texel_count; ++i) {
+                    weights[i] = bc1_weights[(best.indices_ >> (2 * i)) & 3];
+                }
+                if (!fit_to_weights(colors, weights, first, second))
+                    break;
+
+                auto const refined =
+                        encode_color_endpoints(colors, first, second);
+                if (refined.error_ >= best.error_)
+                    break;
+                best = refined;
+            }
+
+            write_u16(block, best.color0_);
+            write_u16(block.subspan(2), best.color1_);
+            for (std::size_t byte = 0; byte < 4; ++byte) {
+                block[4 + byte] =
+                        static_cast<uint8_t>(best.indices_ >> (8 * byte));
+            }
+        }
+
+        void decompress_color_block(
+                std::span<uint8_t const> block, BlockTexels &texels
+        ) {
+            auto const palette = get_bc1_palette(
+                    read_u16(block), read_u16(block.subspan(2))
+            );
+            uint32_t const indices = block[4] | (block[5] << 8) |
+                                     (block[6] << 16) |
+                                     (static_cast<uint32_t>(block[7]) << 24);
+
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                auto const &color = palette[(indices >> (2 * i)) & 3];
+                for (std::size_t channel = 0; channel < 3; ++channel) {
+                    texels[i * 4 + channel] =
+                            static_cast<uint8_t>(color[channel]);
+                }
+                texels[i * 4 + 3] = 255;
+            }
+        }
+
+        // BC4 channels, used for the alpha of BC3 and both channels of BC5
+
+        [[nodiscard]]
+        std::array<int, 8> get_channel_palette(int first, int second) {
+            std::array<int, 8> palette{first, second};
+            if (first > second) {
+                for (int i = 2; i < 8; ++i) {
+                    palette[i] = ((8 - i) * first + (i - 1) * second + 3) / 7;
+                }
+            } else {
+                for (int i = 2; i < 6; ++i) {
+                    palette[i] = ((6 - i) * first + (i - 1) * second + 2) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            return palette;
+        }
+
+        void compress_channel_block(
+                BlockTexels const &texels, std::size_t channel,
+                std::span<uint8_t> block
+        ) {
+            int low  = 255;
+            int high = 0;
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                low  = std::min<int>(low, texels[i * 4 + channel]);
+                high = std::max<int>(high, texels[i * 4 + channel]);
+            }
+
+            // The eight value mode, unless all values are equal.
+            auto const palette = get_channel_palette(high, low);
+            block[0]           = static_cast<uint8_t>(high);
+            block[1]           = static_cast<uint8_t>(low);
+
+            uint64_t indices{};
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                int const value = texels[i * 4 + channel];
+
+                uint64_t best_index{};
+                int      best_error = std::numeric_limits<int>::max();
+                for (uint64_t index = 0; index < palette.size(); ++index) {
+                    int const error = std::abs(palette[index] - value);
+                    if (error < best_error) {
+                        best_index = index;
+                        best_error = error;
+                    }
+                }
+                indices |= best_index << (3 * i);
+            }
+
+            for (std::size_t byte = 0; byte < 6; ++byte) {
+                block[2 + byte] = static_cast<uint8_t>(indices >> (8 * byte));
+            }
+        }
+
+        void decompress_channel_block(
+                std::span<uint8_t const> block, std::size_t channel,
+                BlockTexels &texels
+        ) {
+            auto const palette = get_channel_palette(block[0], block[1]);
+
+            uint64_t indices{};
+            for (std::size_t byte = 0; byte < 6; ++byte) {
+                indices |= static_cast<uint64_t>(block[2 + byte]) << (8 * byte);
+            }
+
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                texels[i * 4 + channel] =
+                        static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+            }
+        }
+
+        // BC7 mode 6: 7 bits per endpoint channel plus a shared low bit per endpoint, and 4 bit indices.
+
+        struct Bc7Endpoint final {
+            std::array<uint32_t, 4> channels_;
+            uint32_t                p_bit_;
+
+            [[nodiscard]]
+            int get_channel(std::size_t channel) const {
+                return static_cast<int>((channels_[channel] << 1) | p_bit_);
+            }
+        };
+
+        // Picks the low bit that keeps the endpoint closest to the color.
+        [[nodiscard]]
+        Bc7Endpoint quantize_bc7_endpoint(Color<4> const &color) {
+            Bc7Endpoint best{};
+            float       best_error = std::numeric_limits<float>::max();
+            for (uint32_t p_bit = 0; p_bit < 2; ++p_bit) {
+                Bc7Endpoint endpoint{{}, p_bit};
+                float       error{};
+                for (std::size_t channel = 0; channel < 4; ++channel) {
+                    float const value =
+                            (color[channel] - static_cast<float>(p_bit)) / 2.f;
+                    endpoint.channels_[channel] = static_cast<uint32_t>(
+                            std::clamp(std::lround(value), 0l, 127l)
+                    );
+                    float const difference =
+                            static_cast<float>(endpoint.get_channel(channel)) -
+                            color[channel];
+                    error += difference * difference;
+                }
+
+                if (error < best_error) {
+                    best       = endpoint;
+                    best_error = error;
+                }
+            }
+
+            return best;
+        }
+
+        [[nodiscard]]
+        std::array<std::array<int, 4>, 16> get_bc7_palette(
+                Bc7Endpoint const &first, Bc7Endpoint const &second
+        ) {
+            std::array<std::array<int, 4>, 16> palette;
+            for (std::size_t index = 0; index < 16; ++index) {
+                int const weight = bc7_weights[index];
+                for (std::size_t channel = 0; channel < 4; ++channel) {
+                    palette[index][channel] =
+                            ((64 - weight) * first.get_channel(channel) +
+                             weight * second.get_channel(channel) + 32) >>
+                            6;
+                }
+            }
+
+            return palette;
+        }
+
+        struct Bc7Block final {
+            Bc7Endpoint                       first_;
+            Bc7Endpoint                       second_;
+            std::array<uint32_t, texel_count> indices_;
+            float                             error_;
+        };
+
+        [[nodiscard]]
+        Bc7Block encode_bc7_endpoints(
+                BlockColors<4> const &colors, Color<4> const &first,
+                Color<4> const &second
+        ) {
+            Bc7Block block{
+                    quantize_bc7_endpoint(first), quantize_bc7_endpoint(second),
+                    {}, 0.f
+            };
+
+            auto const decoded =
+                    get_bc7_palette(block.first_, block.second_);
+            std::array<Color<4>, 16> palette;
+            for (std::size_t index = 0; index < 16; ++index) {
+                for (std::size_t channel = 0; channel < 4; ++channel) {
+                    palette[index][channel] =
+                            static_cast<float>(decoded[index][channel]);
+                }
+            }
+
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                auto const [index, error] = find_closest(palette, colors[i]);
+                block.indices_[i]         = index;
+                block.error_ += error;
+            }
+
+            return block;
+        }
+
+        void compress_bc7_block(
+                BlockTexels const &texels, std::span<uint8_t> bytes
+        ) {
+            auto const colors    = get_colors<4>(texels);
+            auto [first, second] = fit_endpoints(colors);
+            auto best = encode_bc7_endpoints(colors, first, second);
+
+            for (int refinement = 0; refinement < refinements; ++refinement) {
+                std::array<float, texel_count> weights;
+                for (std::size_t i = 0; i < texel_count; ++i) {
+                    weights[i] = static_cast<float>(
+                                         bc7_weights[best.indices_[i]]
+                                 ) /
+                                 64.f;
+                }
+                if (!fit_to_weights(colors, weights, first, second))
+                    break;
+
+                auto const refined =
+                        encode_bc7_endpoints(colors, first, second);
+                if (refined.error_ >= best.error_)
+                    break;
+                best = refined;
+            }
+
+            // The highest bit of the first index is implied to be 0, swapping the endpoints makes sure it is.
+            if (best.indices_[0] >= 8) {
+                std::swap(best.first_, best.second_);
+                for (auto &index : best.indices_) {
+                    index = 15 - index;
+                }
+            }
+
+            BlockBits bits{bytes};
+            bits.write(bc7_mode6_bits, 7);
+            for (std::size_t channel = 0; channel < 4; ++channel) {
+                bits.write(best.first_.channels_[channel], 7);
+                bits.write(best.second_.channels_[channel], 7);
+            }
+            bits.write(best.first_.p_bit_, 1);
+            bits.write(best.second_.p_bit_, 1);
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                bits.write(best.indices_[i], i == 0 ? 3 : 4);
+            }
+        }
+
+        void decompress_bc7_block(
+                std::span<uint8_t const> bytes, BlockTexels &texels
+        ) {
+            BlockBitReader bits{bytes};
+            if (bits.read(7) != bc7_mode6_bits) {
+                throw std::runtime_error{
+                        "Only BC7 mode 6 blocks can be decompressed"
+                };
+            }
+
+            Bc7Endpoint first{};
+            Bc7Endpoint second{};
+            for (std::size_t channel = 0; channel < 4; ++channel) {
+                first.channels_[channel]  = bits.read(7);
+                second.channels_[channel] = bits.read(7);
+            }
+            first.p_bit_  = bits.read(1);
+            second.p_bit_ = bits.read(1);
+
+            auto const palette = get_bc7_palette(first, second);
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                auto const &color = palette[bits.read(i == 0 ? 3 : 4)];
+                for (std::size_t channel = 0; channel < 4; ++channel) {
+                    texels[i * 4 + channel] =
+                            static_cast<uint8_t>(color[channel]);
+                }
+            }
+        }
+
+        // Gathers the texels of a block as RGBA, texels beyond the edges of the level repeat the last row or column.
+        [[nodiscard]]
+        BlockTexels read_block(
+                std::span<uint8_t const> level, MipLevel const &size,
+                uint32_t channels, uint32_t block_x, uint32_t block_y
+        ) {
+            BlockTexels texels{};
+            for (uint32_t y = 0; y < block_texels; ++y) {
+                uint32_t const source_y =
+                        std::min(block_y * block_texels + y, size.height_ - 1);
+                for (uint32_t x = 0; x < block_texels; ++x) {
+                    uint32_t const source_x = std::min(
+                            block_x * block_texels + x, size.width_ - 1
+                    );
+                    auto const source = level.subspan(
+                            (static_cast<std::size_t>(source_y) * size.width_ +
+                             source_x) *
+                                    channels,
+                            channels
+                    );
+
+                    auto *const texel =
+                            texels.data() + (y * block_texels + x) * 4;
+                    std::ranges::copy(source, texel);
+                    texel[3] = channels == 4 ? source[3] : 255;
+                }
+            }
+
+            return texels;
+        }
+
+        [[nodiscard]]
+        uint32_t get_block_count(uint32_t texels) {
+            return (texels + block_texels - 1) / block_texels;
+        }
+    }// namespace
+
+    std::size_t get_block_byte_size(BlockFormat format) {
+        return format == BlockFormat::BC1 ? 8 : 16;
+    }
+
+    std::size_t
+    get_level_byte_size(BlockFormat format, uint32_t width, uint32_t height) {
+        return static_cast<std::size_t>(get_block_count(width)) *
+               get_block_count(height) * get_block_byte_size(format);
+    }
+
+    std::span<uint8_t const>
+    CompressedTexture::get_level_data(std::size_t level) const {
+        auto const &mip = levels_[level];
+
+        return std::span{data_}.subspan(
+                mip.offset_,
+                get_level_byte_size(format_, mip.width_, mip.height_)
+        );
+    }
+
+    void compress_block(
+            BlockFormat format, BlockTexels const &texels,
+            std::span<uint8_t> block
+    ) {
+        assert(block.size() == get_block_byte_size(format));
+
+        switch (format) {
+            case BlockFormat::BC1:
+                compress_color_block(texels, block);
+                break;
+            case BlockFormat::BC3:
+                compress_channel_block(texels, 3, block.first(8));
+                compress_color_block(texels, block.subspan(8));
+                break;
+            case BlockFormat::BC5:
+                compress_channel_block(texels, 0, block.first(8));
+                compress_channel_block(texels, 1, block.subspan(8));
+                break;
+            case BlockFormat::BC7:
+                compress_bc7_block(texels, block);
+                break;
+        }
+    }
+
+    void decompress_block(
+            BlockFormat format, std::span<uint8_t const> block,
+            BlockTexels &texels
+    ) {
+        assert(block.size() == get_block_byte_size(format));
+
+        switch (format) {
+            case BlockFormat::BC1:
+                decompress_color_block(block, texels);
+                break;
+            case BlockFormat::BC3:
+                decompress_color_block(block.subspan(8), texels);
+                decompress_channel_block(block.first(8), 3, texels);
+                break;
+            case BlockFormat::BC5:
+                texels.fill(0);
+                decompress_channel_block(block.first(8), 0, texels);
+                decompress_channel_block(block.subspan(8), 1, texels);
+                for (std::size_t i = 0; i < texel_count; ++i) {
+                    texels[i * 4 + 3] = 255;
+                }
+                break;
+            case BlockFormat::BC7:
+                decompress_bc7_block(block, texels);
+                break;
+        }
+    }
+
+    CompressedTexture compress_texture(
+            MipChain const &chain, BlockFormat format, ThreadPool &thread_pool
+    ) {
+        CompressedTexture texture;
+        texture.format_ = format;
+
+        std::size_t total_size{};
+        for (auto const &level : chain.levels_) {
+            texture.levels_.push_back(
+                    {level.width_, level.height_, total_size}
+            );
+            total_size +=
+                    get_level_byte_size(format, level.width_, level.height_);
+        }
+        texture.data_.resize(total_size);
+
+        std::size_t const block_size = get_block_byte_size(format);
+
+        for (std::size_t level = 0; level < chain.levels_.size(); ++level) {
+            auto const    &size          = chain.levels_[level];
+            auto const     source        = chain.get_level_data(level);
+            uint32_t const blocks_x      = get_block_count(size.width_);
+            uint32_t const blocks_y      = get_block_count(size.height_);
+            uint32_t const jobs_count    =
+                    (blocks_y + block_rows_per_job - 1) / block_rows_per_job;
+            auto const     target_offset = texture.levels_[level].offset_;
+
+            thread_pool.parallel_for(jobs_count, [&](std::size_t job) {
+                uint32_t const first_row =
+                        static_cast<uint32_t>(job) * block_rows_per_job;
+                uint32_t const last_row =
+                        std::min(first_row + block_rows_per_job, blocks_y);
+
+                for (uint32_t block_y = first_row; block_y < last_row;
+                     ++block_y) {
+                    for (uint32_t block_x = 0; block_x < blocks_x; ++block_x) {
+                        std::size_t const offset =
+                                target_offset +
+                                (static_cast<std::size_t>(block_y) * blocks_x +
+                                 block_x) *
+                                        block_size;
+                        compress_block(
+                                format,
+                                read_block(
+                                        source, size, chain.channels_, block_x,
+                                        block_y
+                                ),
+                                std::span{texture.data_}.subspan(
+                                        offset, block_size
+                                )
+                        );
+                    }
+                }
+            });
+        }
+
+        return texture;
+    }
+}// namespace engine::texture_processing
@@ -0,0 +1,72 @@
+#ifndef BLOCK_COMPRESSION_H
+#define BLOCK_COMPRESSION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "mip_chain.h"
+#include "misc/thread_pool.h"
+
+namespace engine::texture_processing {
+    enum class BlockFormat {
+        // RGB in 4 bits per texel, alpha is dropped.
+        BC1,
+        // BC1 colors and separately compressed alpha, 8 bits per texel.
+        BC3,
+        // Two separately compressed channels (red and green), 8 bits per texel. Meant for normal maps.
+        BC5,
+        // RGBA in 8 bits per texel, with less banding than BC3.
+        BC7,
+    };
+
+    // Blocks cover 4x4 texels.
+    constexpr uint32_t block_texels = 4;
+
+    // The texels of a block in RGBA8, row by row.
+    using BlockTexels = std::array<uint8_t, block_texels * block_texels * 4>;
+
+    [[nodiscard]]
+    std::size_t get_block_byte_size(BlockFormat format);
+
+    // Byte size of a level of the given size in texels, partial blocks at the edges count as whole blocks.
+    [[nodiscard]]
+    std::size_t
+    get_level_byte_size(BlockFormat format, uint32_t width, uint32_t height);
+
+    // Every mip level of a texture as blocks, stored one after another like the levels of a MipChain.
+    struct CompressedTexture final {
+        BlockFormat           format_{};
+        std::vector<MipLevel> levels_;
+        std::vector<uint8_t>  data_;
+
+        [[nodiscard]]
+        std::span<uint8_t const> get_level_data(std::size_t level) const;
+    };
+
+    // Endpoints are fitted along the principal axis of the texels and then refined with a least squares fit to the
+    // chosen indices. BC7 blocks always use mode 6, a single pair of RGBA endpoints with 16 interpolation steps.
+    void compress_block(
+            BlockFormat format, BlockTexels const &texels,
+            std::span<uint8_t> block
+    );
+
+    // Decodes the blocks that compress_block writes, for BC7 only mode 6 blocks are supported.
+    void decompress_block(
+            BlockFormat format, std::span<uint8_t const> block,
+            BlockTexels &texels
+    );
+
+    // Compresses every level of the chain, with the rows of blocks of each level split into jobs on the given thread
+    // pool. Images with fewer than four channels are read the way bgfx samples R8, RG8 and RGB8 textures, the missing
+    // color channels are 0 and alpha is opaque.
+    [[nodiscard]]
+    CompressedTexture compress_texture(
+            MipChain const &chain, BlockFormat format,
+            ThreadPool &thread_pool = ThreadPool::get_instance()
+    );
+}// namespace engine::texture_processing
+
+#endif//BLOCK_COMPRESSION_H
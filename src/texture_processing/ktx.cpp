@@ -0,0 +1,188 @@
+#include "ktx.h"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <stdexcept>
+
+namespace engine::texture_processing {
+    namespace {
+        constexpr std::array<uint8_t, 12> identifier{
+                0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31,
+                0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+        constexpr uint32_t endianness = 0x04030201;
+
+        // Header fields after the identifier, in file order.
+        enum HeaderField : std::size_t {
+            Endianness,
+            GlType,
+            GlTypeSize,
+            GlFormat,
+            GlInternalFormat,
+            GlBaseInternalFormat,
+            PixelWidth,
+            PixelHeight,
+            PixelDepth,
+            ArrayElementCount,
+            FaceCount,
+            MipLevelCount,
+            KeyValueDataSize,
+            FieldCount,
+        };
+        constexpr std::size_t header_size =
+                identifier.size() + FieldCount * sizeof(uint32_t);
+
+        constexpr uint32_t gl_rgba                 = 0x1908;
+        constexpr uint32_t gl_rg                   = 0x8227;
+        constexpr uint32_t gl_compressed_rgb_s3tc  = 0x83F0;
+        constexpr uint32_t gl_compressed_rgba_s3tc = 0x83F1;
+        constexpr uint32_t gl_compressed_rgba_dxt5 = 0x83F3;
+        constexpr uint32_t gl_compressed_rg_rgtc2  = 0x8DBD;
+        constexpr uint32_t gl_compressed_la_latc2  = 0x8C72;
+        constexpr uint32_t gl_compressed_rgba_bptc = 0x8E8C;
+
+        [[nodiscard]]
+        uint32_t get_internal_format(BlockFormat format) {
+            switch (format) {
+                case BlockFormat::BC1:
+                    return gl_compressed_rgba_s3tc;
+                case BlockFormat::BC3:
+                    return gl_compressed_rgba_dxt5;
+                case BlockFormat::BC5:
+                    return gl_compressed_la_latc2;
+                case BlockFormat::BC7:
+                    return gl_compressed_rgba_bptc;
+            }
+
+            throw std::runtime_error{"Unknown block format"};
+        }
+
+        [[nodiscard]]
+        BlockFormat get_block_format(uint32_t internal_format) {
+            switch (internal_format) {
+                case gl_compressed_rgb_s3tc:
+                case gl_compressed_rgba_s3tc:
+                    return BlockFormat::BC1;
+                case gl_compressed_rgba_dxt5:
+                    return BlockFormat::BC3;
+                case gl_compressed_la_latc2:
+                case gl_compressed_rg_rgtc2:
+                    return BlockFormat::BC5;
+                case gl_compressed_rgba_bptc:
+                    return BlockFormat::BC7;
+                default:
+                    throw std::runtime_error{std::format(
+                            "Unsupported KTX internal format: {:#x}",
+                            internal_format
+                    )};
+            }
+        }
+
+        void write_u32(std::vector<uint8_t> &data, uint32_t value) {
+            for (std::size_t byte = 0; byte < sizeof(uint32_t); ++byte) {
+                data.push_back(static_cast<uint8_t>(value >> (8 * byte)));
+            }
+        }
+
+        // Reads a little endian value and fails on truncated data.
+        [[nodiscard]]
+        uint32_t read_u32(std::span<uint8_t const> data, std::size_t offset) {
+            if (offset + sizeof(uint32_t) > data.size())
+                throw std::runtime_error{"Truncated KTX data"};
+
+            uint32_t value{};
+            for (std::size_t byte = 0; byte < sizeof(uint32_t); ++byte) {
+                value |= static_cast<uint32_t>(data[offset + byte])
+                         << (8 * byte);
+            }
+
+            return value;
+        }
+    }// namespace
+
+    bool is_ktx(std::span<uint8_t const> data) {
+        return data.size() >= identifier.size() &&
+               std::ranges::equal(data.first(identifier.size()), identifier);
+    }
+
+    std::vector<uint8_t> encode_ktx(CompressedTexture const &texture) {
+        auto const &base = texture.levels_.front();
+
+        std::vector<uint8_t> data{identifier.begin(), identifier.end()};
+        data.reserve(
+                header_size + texture.data_.size() +
+                texture.levels_.size() * sizeof(uint32_t)
+        );
+
+        std::array<uint32_t, FieldCount> header{};
+        header[Endianness]       = endianness;
+        header[GlTypeSize]       = 1;
+        header[GlInternalFormat] = get_internal_format(texture.format_);
+        header[GlBaseInternalFormat] =
+                texture.format_ == BlockFormat::BC5 ? gl_rg : gl_rgba;
+        header[PixelWidth]    = base.width_;
+        header[PixelHeight]   = base.height_;
+        header[FaceCount]     = 1;
+        header[MipLevelCount] = static_cast<uint32_t>(texture.levels_.size());
+        for (uint32_t const field : header) {
+            write_u32(data, field);
+        }
+
+        // Block sizes are multiples of four bytes, so levels never need padding.
+        for (std::size_t level = 0; level < texture.levels_.size(); ++level) {
+            auto const level_data = texture.get_level_data(level);
+            write_u32(data, static_cast<uint32_t>(level_data.size()));
+            data.insert(data.end(), level_data.begin(), level_data.end());
+        }
+
+        return data;
+    }
+
+    CompressedTexture decode_ktx(std::span<uint8_t const> data) {
+        if (!is_ktx(data))
+            throw std::runtime_error{"Not a KTX file"};
+
+        std::array<uint32_t, FieldCount> header{};
+        for (std::size_t field = 0; field < FieldCount; ++field) {
+            header[field] = read_u32(
+                    data, identifier.size() + field * sizeof(uint32_t)
+            );
+        }
+
+        if (header[Endianness] != endianness)
+            throw std::runtime_error{"Big endian KTX files aren't supported"};
+        if (header[PixelDepth] > 1 || header[ArrayElementCount] > 0 ||
+            header[FaceCount] != 1)
+            throw std::runtime_error{"Only 2D KTX textures are supported"};
+
+        CompressedTexture texture;
+        texture.format_ = get_block_format(header[GlInternalFormat]);
+
+        std::size_t    offset      = header_size + header[KeyValueDataSize];
+        uint32_t       width       = header[PixelWidth];
+        uint32_t       height      = header[PixelHeight];
+        uint32_t const level_count = std::max(header[MipLevelCount], 1u);
+
+        for (uint32_t level = 0; level < level_count; ++level) {
+            uint32_t const size = read_u32(data, offset);
+            offset += sizeof(uint32_t);
+
+            if (size != get_level_byte_size(texture.format_, width, height) ||
+                offset + size > data.size())
+                throw std::runtime_error{"Invalid KTX mip level size"};
+
+            texture.levels_.push_back({width, height, texture.data_.size()});
+            texture.data_.insert(
+                    texture.data_.end(), data.begin() + offset,
+                    data.begin() + offset + size
+            );
+
+            offset += size;
+            width  = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+
+        return texture;
+    }
+}// namespace engine::texture_processing
@@ -0,0 +1,24 @@
+#ifndef KTX_H
+#define KTX_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "block_compression.h"
+
+namespace engine::texture_processing {
+    // Whether the data starts like a KTX 1 file.
+    [[nodiscard]]
+    bool is_ktx(std::span<uint8_t const> data);
+
+    // Writes a KTX 1 file with a single 2D image and all of its mip levels, which bgfx (through bimg) loads as is.
+    [[nodiscard]]
+    std::vector<uint8_t> encode_ktx(CompressedTexture const &texture);
+
+    // Reads KTX 1 files in one of the block formats, throws for anything else.
+    [[nodiscard]]
+    CompressedTexture decode_ktx(std::span<uint8_t const> data);
+}// namespace engine::texture_processing
+
+#endif//KTX_H
@@ -0,0 +1,309 @@
+#include "mip_chain.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_MIPS_SSE
+#include <emmintrin.h>
+#endif
+
+namespace engine::texture_processing {
+    namespace {
+        // Texels are filtered as four linear floats, whatever the number of channels.
+        constexpr std::size_t filter_channels = 4;
+        constexpr uint32_t    rows_per_job    = 32;
+        // Steps of the encoding table are finer than the distance between the darkest sRGB values in linear light.
+        constexpr std::size_t encode_table_size = 4096;
+        constexpr float       encode_table_scale =
+                static_cast<float>(encode_table_size - 1);
+
+        [[nodiscard]]
+        float srgb_to_linear(float value) {
+            return value <= 0.04045f
+                         ? value / 12.92f
+                         : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        [[nodiscard]]
+        float linear_to_srgb(float value) {
+            return value <= 0.0031308f
+                         ? value * 12.92f
+                         : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+        }
+
+        struct ColorTables final {
+            std::array<float, 256>                   srgb_decode_;
+            std::array<float, 256>                   linear_decode_;
+            std::array<uint8_t, encode_table_size> srgb_encode_;
+
+            ColorTables() {
+                for (std::size_t value = 0; value < 256; ++value) {
+                    float const normalized = static_cast<float>(value) / 255.f;
+                    srgb_decode_[value]    = srgb_to_linear(normalized);
+                    linear_decode_[value]  = normalized;
+                }
+                for (std::size_t index = 0; index < encode_table_size;
+                     ++index) {
+                    float const linear =
+                            static_cast<float>(index) / encode_table_scale;
+                    srgb_encode_[index] = static_cast<uint8_t>(
+                            std::lround(linear_to_srgb(linear) * 255.f)
+                    );
+                }
+            }
+        };
+
+        [[nodiscard]]
+        ColorTables const &get_color_tables() {
+            static ColorTables const tables{};
+            return tables;
+        }
+
+        // Converts texels between their stored channels and four linear floats.
+        class TexelCodec final {
+        public:
+            TexelCodec(uint32_t channels, ColorSpace color_space)
+                : channels_{channels} {
+                auto const &tables = get_color_tables();
+
+                // Grey and alpha images keep their alpha in the second channel.
+                std::size_t const alpha_channel = channels == 2 ? 1 : 3;
+                for (std::size_t channel = 0; channel < channels; ++channel) {
+                    srgb_[channel] = color_space == ColorSpace::Srgb &&
+                                     channel != alpha_channel;
+                    decode_tables_[channel] = srgb_[channel]
+                                                    ? &tables.srgb_decode_
+                                                    : &tables.linear_decode_;
+                }
+            }
+
+            void decode_row(
+                    uint8_t const *texels, uint32_t width, float *linear
+            ) const {
+                std::fill_n(linear, width * filter_channels, 0.f);
+                for (uint32_t x = 0; x < width; ++x) {
+                    for (std::size_t channel = 0; channel < channels_;
+                         ++channel) {
+                        linear[x * filter_channels + channel] =
+                                (*decode_tables_[channel])
+                                        [texels[x * channels_ + channel]];
+                    }
+                }
+            }
+
+            void encode_row(
+                    float const *linear, uint32_t width, uint8_t *texels
+            ) const {
+                auto const &srgb_encode = get_color_tables().srgb_encode_;
+
+                for (uint32_t x = 0; x < width; ++x) {
+                    std::array<int32_t, filter_channels> srgb_indices;
+                    std::array<int32_t, filter_channels> linear_values;
+#ifdef ENGINE_MIPS_SSE
+                    __m128 const value = _mm_min_ps(
+                            _mm_max_ps(
+                                    _mm_loadu_ps(linear + x * filter_channels),
+                                    _mm_setzero_ps()
+                            ),
+                            _mm_set1_ps(1.f)
+                    );
+                    _mm_storeu_si128(
+                            reinterpret_cast<__m128i *>(srgb_indices.data()),
+                            _mm_cvtps_epi32(_mm_mul_ps(
+                                    value, _mm_set1_ps(encode_table_scale)
+                            ))
+                    );
+                    _mm_storeu_si128(
+                            reinterpret_cast<__m128i *>(linear_values.data()),
+                            _mm_cvtps_epi32(
+                                    _mm_mul_ps(value, _mm_set1_ps(255.f))
+                            )
+                    );
+#else
+                    for (std::size_t channel = 0; channel < filter_channels;
+                         ++channel) {
+                        float const value = std::clamp(
+                                linear[x * filter_channels + channel], 0.f, 1.f
+                        );
+                        srgb_indices[channel] = static_cast<int32_t>(
+                                std::lround(value * encode_table_scale)
+                        );
+                        linear_values[channel] =
+                                static_cast<int32_t>(std::lround(value * 255.f)
+                                );
+                    }
+#endif
+                    for (std::size_t channel = 0; channel < channels_;
+                         ++channel) {
+                        texels[x * channels_ + channel] =
+                                srgb_[channel]
+                                        ? srgb_encode[srgb_indices[channel]]
+                                        : static_cast<uint8_t>(
+                                                  linear_values[channel]
+                                          );
+                    }
+                }
+            }
+
+        private:
+            uint32_t                                      channels_;
+            std::array<bool, filter_channels>             srgb_{};
+            std::array<std::array<float, 256> const *, 4> decode_tables_{};
+        };
+
+        // Averages the 2x2 blocks of two linear rows into a row of half the width.
+        void filter_row(
+                float const *row0, float const *row1, uint32_t source_width,
+                uint32_t target_width, float *target
+        ) {
+            for (uint32_t x = 0; x < target_width; ++x) {
+                std::size_t const x0 =
+                        std::min(2 * x, source_width - 1) * filter_channels;
+                std::size_t const x1 =
+                        std::min(2 * x + 1, source_width - 1) * filter_channels;
+#ifdef ENGINE_MIPS_SSE
+                __m128 const sum = _mm_add_ps(
+                        _mm_add_ps(
+                                _mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)
+                        ),
+                        _mm_add_ps(
+                                _mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)
+                        )
+                );
+                _mm_storeu_ps(
+                        target + x * filter_channels,
+                        _mm_mul_ps(sum, _mm_set1_ps(0.25f))
+                );
+#else
+                for (std::size_t channel = 0; channel < filter_channels;
+                     ++channel) {
+                    target[x * filter_channels + channel] =
+                            (row0[x0 + channel] + row0[x1 + channel] +
+                             row1[x0 + channel] + row1[x1 + channel]) *
+                            0.25f;
+                }
+#endif
+            }
+        }
+    }// namespace
+
+    std::span<uint8_t const> MipChain::get_level_data(std::size_t level) const {
+        auto const &mip = levels_[level];
+
+        return std::span{data_}.subspan(
+                mip.offset_,
+                static_cast<std::size_t>(mip.width_) * mip.height_ * channels_
+        );
+    }
+
+    uint32_t get_mip_count(uint32_t width, uint32_t height) {
+        return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+    }
+
+    MipChain build_mip_chain(
+            std::span<uint8_t const> pixels, uint32_t width, uint32_t height,
+            uint32_t channels, ColorSpace color_space, ThreadPool &thread_pool
+    ) {
+        if (width == 0 || height == 0 || channels == 0 ||
+            channels > filter_channels) {
+            throw std::runtime_error{"Unsupported image for a mip chain"};
+        }
+        if (pixels.size() !=
+            static_cast<std::size_t>(width) * height * channels) {
+            throw std::runtime_error{"Image data doesn't match its size"};
+        }
+
+        MipChain chain;
+        chain.channels_ = channels;
+
+        std::size_t total_size{};
+        for (uint32_t level = 0; level < get_mip_count(width, height);
+             ++level) {
+            uint32_t const level_width  = std::max(width >> level, 1u);
+            uint32_t const level_height = std::max(height >> level, 1u);
+            chain.levels_.push_back({level_width, level_height, total_size});
+            total_size += static_cast<std::size_t>(level_width) *
+                          level_height * channels;
+        }
+
+        chain.data_.resize(total_size);
+        std::ranges::copy(pixels, chain.data_.begin());
+
+        TexelCodec const codec{channels, color_space};
+
+        // Levels are filtered from the linear floats of the previous level, except for the first one, whose rows
+        // are decoded as they're needed.
+        std::vector<float> previous;
+        std::vector<float> current;
+        for (std::size_t level = 1; level < chain.levels_.size(); ++level) {
+            auto const &source = chain.levels_[level - 1];
+            auto const &target = chain.levels_[level];
+            current.resize(
+                    static_cast<std::size_t>(target.width_) * target.height_ *
+                    filter_channels
+            );
+
+            std::size_t const row_size   = source.width_ * filter_channels;
+            uint32_t const    jobs_count =
+                    (target.height_ + rows_per_job - 1) / rows_per_job;
+
+            auto const get_source_row = [&](uint32_t y) {
+                return chain.data_.data() + source.offset_ +
+                       static_cast<std::size_t>(y) * source.width_ * channels;
+            };
+
+            thread_pool.parallel_for(jobs_count, [&](std::size_t job) {
+                std::vector<float> decoded_rows(level == 1 ? 2 * row_size : 0);
+
+                uint32_t const first_row =
+                        static_cast<uint32_t>(job) * rows_per_job;
+                uint32_t const last_row =
+                        std::min(first_row + rows_per_job, target.height_);
+                for (uint32_t y = first_row; y < last_row; ++y) {
+                    uint32_t const y0 = std::min(2 * y, source.height_ - 1);
+                    uint32_t const y1 = std::min(2 * y + 1, source.height_ - 1);
+
+                    float const *row0;
+                    float const *row1;
+                    if (level == 1) {
+                        codec.decode_row(
+                                get_source_row(y0), source.width_,
+                                decoded_rows.data()
+                        );
+                        codec.decode_row(
+                                get_source_row(y1), source.width_,
+                                decoded_rows.data() + row_size
+                        );
+                        row0 = decoded_rows.data();
+                        row1 = decoded_rows.data() + row_size;
+                    } else {
+                        row0 = previous.data() + y0 * row_size;
+                        row1 = previous.data() + y1 * row_size;
+                    }
+
+                    float *const target_row = current.data() +
+                                              y * target.width_ *
+                                                      filter_channels;
+                    filter_row(
+                            row0, row1, source.width_, target.width_,
+                            target_row
+                    );
+                    codec.encode_row(
+                            target_row, target.width_,
+                            chain.data_.data() + target.offset_ +
+                                    y * target.width_ * channels
+                    );
+                }
+            });
+
+            std::swap(previous, current);
+        }
+
+        return chain;
+    }
+}// namespace engine::texture_processing
@@ -0,0 +1,50 @@
+#ifndef MIP_CHAIN_H
+#define MIP_CHAIN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "misc/thread_pool.h"
+
+namespace engine::texture_processing {
+    enum class ColorSpace {
+        Linear,
+        // Color channels are sRGB encoded, alpha is always linear.
+        Srgb,
+    };
+
+    struct MipLevel final {
+        uint32_t    width_;
+        uint32_t    height_;
+        // Byte offset of the level in the data of the chain.
+        std::size_t offset_;
+    };
+
+    // Every level of a texture from the full size down to 1x1, stored one after another without padding, the layout
+    // bgfx expects for the memory of a texture with mips.
+    struct MipChain final {
+        uint32_t              channels_{};
+        std::vector<MipLevel> levels_;
+        std::vector<uint8_t>  data_;
+
+        [[nodiscard]]
+        std::span<uint8_t const> get_level_data(std::size_t level) const;
+    };
+
+    [[nodiscard]]
+    uint32_t get_mip_count(uint32_t width, uint32_t height);
+
+    // Builds the full mip chain of an image with 8 bits per channel and 1 to 4 channels. Each level is a 2x2 box
+    // filter of the previous one, texels beyond odd edges are clamped. sRGB colors are averaged in linear light, so
+    // that minified textures don't get darker. Rows of each level are filtered in parallel on the given thread pool.
+    [[nodiscard]]
+    MipChain build_mip_chain(
+            std::span<uint8_t const> pixels, uint32_t width, uint32_t height,
+            uint32_t channels, ColorSpace color_space,
+            ThreadPool &thread_pool = ThreadPool::get_instance()
+    );
+}// namespace engine::texture_processing
+
+#endif//MIP_CHAIN_H
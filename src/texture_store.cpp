@@ -1,27 +1,264 @@
 #include "texture_store.h"
 
+#include <algorithm>
+#include <array>
+#include <format>
+#include <iostream>
+#include <thread>
+
+#include "texture_processing/mip_chain.h"
+
 namespace engine {
+    namespace {
+        [[nodiscard]]
+        Texture make_placeholder() {
+            constexpr std::array<uint8_t, 4> white{255, 255, 255, 255};
+
+            return Texture{
+                    DecodedImage{MipChainView::from_chain(
+                            texture_processing::build_mip_chain(
+                                    white, 1, 1, white.size(),
+                                    texture_processing::ColorSpace::Linear
+                            )
+                    )},
+                    "Placeholder"
+            };
+        }
+    }// namespace
+
+    TextureStore::TextureStore() = default;
+
+    TextureStore::~TextureStore() {
+        // Workers still decoding use the store, so they have to stop first.
+        ++generation_;
+        decode_pool_.reset();
+    }
+
     TextureHandle
     TextureStore::add_texture(std::string const &name, Texture &&texture) {
         textures_.emplace_back(std::move(texture));
+        usages_.push_back({.resident_frame_ = frame_});
 
         return TextureHandle{textures_.size() - 1};
     }
 
+    TextureHandle TextureStore::add_texture(
+            std::string const &name, Texture &&texture, Hash128 const &hash
+    ) {
+        auto const handle = add_texture(name, std::move(texture));
+        indices_by_hash_.emplace(hash, *handle.index_);
+
+        return handle;
+    }
+
     TextureHandle TextureStore::add_texture(
             std::span<stbi_uc const> image_data, std::string const &name
     ) {
+        auto const hash = hash_bytes(image_data);
+        if (auto const handle = find_texture(hash))
+            return *handle;
+
         Texture texture{image_data, name};
 
-        return add_texture(name, std::move(texture));
+        return add_texture(name, std::move(texture), hash);
+    }
+
+    TextureHandle
+    TextureStore::stream_texture(std::string name, Decoder decoder) {
+        if (!decode_pool_) {
+            decode_pool_ = std::make_unique<ThreadPool>(
+                    std::max(std::thread::hardware_concurrency() / 2, 1u)
+            );
+        }
+        if (!placeholder_)
+            placeholder_.emplace(make_placeholder());
+
+        std::size_t const index = textures_.size();
+        textures_.emplace_back();
+        usages_.emplace_back();
+        ++pending_count_;
+
+        decode_pool_->enqueue([this, generation = generation_.load(), index,
+                               pool_ptr = decode_pool_.get(),
+                               name     = std::move(name),
+                               decoder  = std::move(decoder)]() mutable {
+            if (generation != generation_)
+                return;
+
+            DecodedTexture decoded{index, std::move(name), {}, {}};
+            try {
+                decoded.image_ = decoder(*pool_ptr);
+            } catch (std::exception const &error) {
+                decoded.error_ = error.what();
+            } catch (...) {
+                decoded.error_ = "Unknown error";
+            }
+
+            std::lock_guard const lock{decoded_mutex_};
+            decoded_.push_back(std::move(decoded));
+        });
+
+        return TextureHandle{index};
+    }
+
+    TextureHandle TextureStore::stream_texture(
+            std::string name, Decoder decoder, Hash128 const &hash
+    ) {
+        if (auto const handle = find_texture(hash))
+            return *handle;
+
+        auto const handle = stream_texture(std::move(name), std::move(decoder));
+        indices_by_hash_.emplace(hash, *handle.index_);
+
+        return handle;
+    }
+
+    std::optional<TextureHandle>
+    TextureStore::find_texture(Hash128 const &hash) const {
+        auto const it = indices_by_hash_.find(hash);
+        if (it == indices_by_hash_.end())
+            return std::nullopt;
+
+        return TextureHandle{it->second};
+    }
+
+    void TextureStore::upload_streamed_textures() {
+        while (true) {
+            DecodedTexture decoded;
+            {
+                std::lock_guard const lock{decoded_mutex_};
+                if (decoded_.empty())
+                    return;
+
+                auto &next = decoded_.front();
+                std::size_t const size =
+                        next.image_ ? next.image_->get_byte_size() : 0;
+                if (uploaded_bytes_ > 0 &&
+                    uploaded_bytes_ + size > upload_budget_)
+                    return;
+
+                uploaded_bytes_ += size;
+                decoded = std::move(next);
+                decoded_.pop_front();
+            }
+
+            --pending_count_;
+            if (!decoded.image_) {
+                std::cerr << std::format(
+                        "Failed to decode texture {}: {}\n", decoded.name_,
+                        decoded.error_
+                );
+                continue;
+            }
+
+            textures_[decoded.index_].emplace(
+                    std::move(*decoded.image_), decoded.name_
+            );
+            usages_[decoded.index_].resident_frame_ = frame_;
+        }
+    }
+
+    void TextureStore::request(TextureHandle const &handle, float screen_size) {
+        auto &usage            = usages_[*handle.index_];
+        usage.last_used_frame_ = frame_;
+        usage.screen_size_     = std::max(usage.screen_size_, screen_size);
+    }
+
+    void TextureStore::update_residency() {
+        residencies_.clear();
+        residency_indices_.clear();
+        for (std::size_t index = 0; index < textures_.size(); ++index) {
+            if (!textures_[index])
+                continue;
+
+            auto const &texture = *textures_[index];
+            auto       &usage   = usages_[index];
+
+            // Textures that weren't drawn keep their levels unless the budget needs them.
+            uint32_t first_mip = texture.get_first_mip();
+            if (texture.can_drop_levels() && usage.last_used_frame_ == frame_ &&
+                usage.screen_size_ > 0.f) {
+                first_mip = get_kept_first_mip(
+                        static_cast<uint32_t>(texture.get_width()),
+                        static_cast<uint32_t>(texture.get_height()),
+                        texture.get_mip_count(), first_mip, usage.screen_size_,
+                        frame_ - usage.resident_frame_ >= min_resident_frames
+                );
+            }
+            usage.screen_size_ = 0.f;
+
+            // Textures that can't drop levels count as a single one, which the budget never drops.
+            residencies_.push_back(
+                    {texture.get_full_byte_size(),
+                     texture.can_drop_levels() ? texture.get_mip_count() : 1,
+                     first_mip, usage.last_used_frame_}
+            );
+            residency_indices_.push_back(index);
+        }
+
+        fit_residency_budget(residencies_, residency_budget_);
+
+        // Both dropping and adding levels upload the levels that are kept again.
+        auto const recreate = [this](std::size_t i) {
+            std::size_t const index     = residency_indices_[i];
+            uint32_t const    first_mip = residencies_[i].first_mip_;
+            auto             &texture   = *textures_[index];
+
+            std::size_t const size = engine::get_resident_byte_size(
+                    texture.get_full_byte_size(), first_mip
+            );
+            if (uploaded_bytes_ > 0 && uploaded_bytes_ + size > upload_budget_)
+                return;
+
+            texture.set_first_mip(first_mip);
+            usages_[index].resident_frame_ = frame_;
+            uploaded_bytes_ += size;
+        };
+
+        // Dropping levels frees memory before any is needed for adding levels back.
+        for (std::size_t i = 0; i < residencies_.size(); ++i) {
+            auto const &texture = *textures_[residency_indices_[i]];
+            if (residencies_[i].first_mip_ > texture.get_first_mip())
+                recreate(i);
+        }
+
+        resident_byte_size_ = 0;
+        for (std::size_t i = 0; i < residencies_.size(); ++i) {
+            auto const &texture = *textures_[residency_indices_[i]];
+            if (residencies_[i].first_mip_ < texture.get_first_mip())
+                recreate(i);
+
+            resident_byte_size_ += texture.get_byte_size();
+        }
+
+        uploaded_bytes_ = 0;
+        ++frame_;
+    }
+
+    void TextureStore::clear() {
+        ++generation_;
+        decode_pool_.reset();
+        {
+            std::lock_guard const lock{decoded_mutex_};
+            decoded_.clear();
+        }
+        pending_count_ = 0;
+
+        albedo_texture_uniform_.reset();
+        base_color_factor_.reset();
+        textures_.clear();
+        usages_.clear();
+        indices_by_hash_.clear();
+        resident_byte_size_ = 0;
+        placeholder_.reset();
     }
 
     Texture const &TextureHandle::operator*() const {
-        return TextureStore::get_instance().textures_[*index_];
+        return TextureStore::get_instance().get(*index_);
     }
 
     Texture const *TextureHandle::operator->() const {
-        return &TextureStore::get_instance().textures_[*index_];
+        return &TextureStore::get_instance().get(*index_);
     }
 
     TextureHandle::operator bool() const {
@@ -1,42 +1,173 @@
 #ifndef TEXTURE_STORE_H
 #define TEXTURE_STORE_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "graphics/texture.h"
+#include "graphics/texture_residency.h"
+#include "misc/hash.h"
 #include "misc/singleton.h"
+#include "misc/thread_pool.h"
 
 namespace engine {
     class TextureHandle;
 
+    // Textures can be added right away or streamed in. A streamed texture gets its handle immediately, which resolves
+    // to a 1x1 white placeholder until the image, decoded on a background thread, is uploaded by
+    // upload_streamed_textures. Textures whose image fails to decode keep the placeholder.
+    // Textures keep only the levels their largest size on screen needs resident. If they don't fit into the residency
+    // budget anyway, the least recently drawn textures drop their largest levels first. Changing the levels recreates
+    // the texture, which counts towards the upload budget like streamed textures do.
+    // Textures added with the hash of their source bytes are shared, adding the same bytes again returns the handle of
+    // the texture that is already there without decoding them.
     class TextureStore final : public Singleton<TextureStore> {
-        std::vector<Texture> textures_;
-        UniformUniqueHandle  albedo_texture_uniform_{
+    public:
+        // Given the pool to run parallel work on, which keeps decoding off the workers the frame uses.
+        using Decoder = std::function<DecodedImage(ThreadPool &)>;
+
+        static constexpr std::size_t default_upload_budget = 16u << 20;
+        // Levels are kept for at least this many frames after a texture's levels changed before they're dropped for
+        // not being needed, unless the residency budget needs them.
+        static constexpr uint64_t    min_resident_frames   = 60;
+
+    private:
+        struct DecodedTexture final {
+            std::size_t                 index_;
+            std::string                 name_;
+            std::optional<DecodedImage> image_;
+            // Set if decoding failed.
+            std::string                 error_;
+        };
+
+        struct Usage final {
+            uint64_t last_used_frame_{};
+            // Frame in which the levels of the texture last changed.
+            uint64_t resident_frame_{};
+            // Largest size in pixels the texture was drawn at in the current frame.
+            float    screen_size_{};
+        };
+
+        // Empty while the texture is still streaming in.
+        std::vector<std::optional<Texture>> textures_;
+        std::vector<Usage>                  usages_;
+        // Created with the first streamed texture, so that it exists whenever a texture is empty.
+        std::optional<Texture>              placeholder_;
+        UniformUniqueHandle                 albedo_texture_uniform_{
                 bgfx::createUniform("u_albedo", bgfx::UniformType::Sampler)
         };
         UniformUniqueHandle base_color_factor_{bgfx::createUniform(
                 "u_baseColorFactor", bgfx::UniformType::Vec4
         )};
 
+        std::size_t                 upload_budget_{default_upload_budget};
+        std::size_t                 residency_budget_{
+                std::numeric_limits<std::size_t>::max()
+        };
+        std::size_t                 resident_byte_size_{};
+        // Bytes uploaded in the current frame.
+        std::size_t                 uploaded_bytes_{};
+        uint64_t                    frame_{};
+        std::size_t                 pending_count_{};
+        // Decodes that were still queued when the store was cleared are skipped.
+        std::atomic<uint64_t>       generation_{};
+        // Decoding has its own workers, so that the frame's parallel work never waits for a long decode.
+        std::unique_ptr<ThreadPool> decode_pool_;
+        std::mutex                  decoded_mutex_;
+        std::deque<DecodedTexture>  decoded_;
+
+        // Index of the texture that was added with each hash.
+        std::unordered_map<Hash128, std::size_t, Hash128Hasher>
+                indices_by_hash_;
+
+        std::vector<TextureResidency> residencies_;
+        // Index of the texture of each residency.
+        std::vector<std::size_t>      residency_indices_;
+
         friend class TextureHandle;
 
+        [[nodiscard]]
+        Texture const &get(std::size_t index) const {
+            auto const &texture = textures_[index];
+
+            return texture ? *texture : *placeholder_;
+        }
+
     public:
-        TextureStore() = default;
+        TextureStore();
+
+        ~TextureStore() override;
 
         TextureHandle add_texture(std::string const &name, Texture &&texture);
 
+        // Expects that no texture with the hash was added yet.
+        TextureHandle add_texture(
+                std::string const &name, Texture &&texture, Hash128 const &hash
+        );
+
+        // Only decodes the image if no texture with the same bytes was added.
         TextureHandle add_texture(
                 std::span<stbi_uc const> image_data, std::string const &name
         );
 
-        void clear() {
-            albedo_texture_uniform_.reset();
-            base_color_factor_.reset();
-            textures_.clear();
+        // Runs the decoder on a background thread, the texture is uploaded by a later upload_streamed_textures.
+        TextureHandle stream_texture(std::string name, Decoder decoder);
+
+        // Only streams the texture in if no texture with the hash was added, the decoder isn't run otherwise.
+        TextureHandle stream_texture(
+                std::string name, Decoder decoder, Hash128 const &hash
+        );
+
+        [[nodiscard]]
+        std::optional<TextureHandle> find_texture(Hash128 const &hash) const;
+
+        // Uploads decoded textures in the order they finished until the budget is used up, but always at least one.
+        // Meant to be called once per frame. Decoders that failed are reported, their textures keep the placeholder.
+        void upload_streamed_textures();
+
+        // Bytes of image data uploaded per frame, by upload_streamed_textures and update_residency together.
+        void set_upload_budget(std::size_t bytes) {
+            upload_budget_ = bytes;
+        }
+
+        // Records that the texture is drawn this frame, at about `screen_size` pixels across.
+        void request(TextureHandle const &handle, float screen_size);
+
+        // Picks the levels every texture keeps for the requests of this frame and starts the next one. Textures whose
+        // levels change are recreated within what is left of the upload budget, dropping levels first, the others wait
+        // for a later frame. Meant to be called once per frame, after rendering.
+        void update_residency();
+
+        // Bytes that all textures may use on the GPU, textures keep at least their smallest level though.
+        void set_residency_budget(std::size_t bytes) {
+            residency_budget_ = bytes;
         }
 
+        [[nodiscard]]
+        std::size_t get_resident_byte_size() const {
+            return resident_byte_size_;
+        }
+
+        // Streamed textures that aren't uploaded yet.
+        [[nodiscard]]
+        std::size_t get_pending_count() const {
+            return pending_count_;
+        }
+
+        // Releases every texture, including the placeholder, which the next streamed texture creates again. Handles
+        // from before are invalid afterwards.
+        void clear();
+
         [[nodiscard]]
         UniformUniqueHandle::handle get_albedo_texture_uniform() const {
             return albedo_texture_uniform_.get();
@@ -60,6 +191,11 @@ namespace engine {
             : index_{index} {
         }
 
+        [[nodiscard]]
+        std::optional<std::size_t> get_index() const {
+            return index_;
+        }
+
         [[nodiscard]]
         Texture const &operator*() const;
 
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "misc/thread_pool.h"
+#include "scene_loaders/cooked_scene.h"
+#include "scene_loaders/gltf_cooker.h"
+
+namespace {
+    constexpr std::string_view usage{
+            "Usage: asset_cooker <assets directory> <output directory> "
+            "[--optimize-meshes] [--lods <count>] [--compress-textures] "
+            "[--split-16-bit] [--float-vertices] [--report]"
+    };
+
+    struct CookerArguments final {
+        std::filesystem::path   assets_directory_;
+        std::filesystem::path   output_directory_;
+        engine::GltfLoadOptions options_;
+        // Prints the optimization report of every mesh that is optimized.
+        bool                    report_{false};
+    };
+
+    [[nodiscard]]
+    std::optional<CookerArguments>
+    parse_arguments(std::span<char const *const> arguments) {
+        CookerArguments parsed;
+        std::vector<std::string_view> directories;
+
+        for (std::size_t i = 0; i < arguments.size(); ++i) {
+            std::string_view const argument{arguments[i]};
+
+            if (argument == "--optimize-meshes") {
+                parsed.options_.optimize_meshes_ = true;
+            } else if (argument == "--compress-textures") {
+                parsed.options_.compress_textures_ = true;
+            } else if (argument == "--split-16-bit") {
+                parsed.options_.split_for_16_bit_indices_ = true;
+            } else if (argument == "--float-vertices") {
+                parsed.options_.vertex_format_ = engine::VertexFormat::Float;
+            } else if (argument == "--report") {
+                parsed.report_ = true;
+            } else if (argument == "--lods") {
+                if (++i == arguments.size())
+                    return std::nullopt;
+
+                std::string_view const count{arguments[i]};
+                auto const             result = std::from_chars(
+                        count.data(), count.data() + count.size(),
+                        parsed.options_.lod_count_
+                );
+                if (result.ec != std::errc{} ||
+                    result.ptr != count.data() + count.size())
+                    return std::nullopt;
+            } else if (argument.starts_with("--")) {
+                return std::nullopt;
+            } else {
+                directories.push_back(argument);
+            }
+        }
+
+        if (directories.size() != 2)
+            return std::nullopt;
+
+        parsed.assets_directory_ = directories[0];
+        parsed.output_directory_ = directories[1];
+
+        return parsed;
+    }
+
+    // Sorted, so that the manifest and the output don't depend on the order of the directory entries.
+    [[nodiscard]]
+    std::vector<std::filesystem::path>
+    find_scenes(std::filesystem::path const &assets_directory) {
+        std::vector<std::filesystem::path> scenes;
+        for (auto const &entry :
+             std::filesystem::recursive_directory_iterator{assets_directory}) {
+            auto const extension = entry.path().extension();
+            if (entry.is_regular_file() &&
+                (extension == ".gltf" || extension == ".glb"))
+                scenes.push_back(
+                        entry.path().lexically_relative(assets_directory)
+                );
+        }
+
+        std::ranges::sort(scenes);
+
+        return scenes;
+    }
+
+    struct CookResult final {
+        std::optional<engine::CookStatus> status_;
+        engine::Hash128                   key_{};
+        std::string                       error_;
+        // One line per optimized mesh, printed after the status of the scene.
+        std::vector<std::string>          reports_;
+    };
+
+    [[nodiscard]]
+    std::string_view get_status_name(engine::CookStatus status) {
+        switch (status) {
+            case engine::CookStatus::UpToDate:
+                return "up to date";
+            case engine::CookStatus::Cooked:
+                return "cooked";
+            case engine::CookStatus::NotWritten:
+                return "failed to write";
+        }
+
+        return "unknown";
+    }
+}// namespace
+
+// Cooks every glTF scene in the assets directory into the output directory, the way load_gltf_scene caches them, and
+// lists them in a manifest there. Scenes whose cooked file is up to date are skipped, and images and geometry of
+// outdated ones are only processed again if the files they're made from changed. With --report, the vertex cache
+// statistics of every mesh that is optimized are printed below its scene.
+int main(int argc, char const *const *argv) {
+    auto const arguments = parse_arguments(std::span{argv + 1, argv + argc});
+    if (!arguments) {
+        std::cerr << usage << '\n';
+        return EXIT_FAILURE;
+    }
+
+    auto const &[assets_directory, output_directory, options, report] =
+            *arguments;
+
+    std::vector<std::filesystem::path> scenes;
+    try {
+        scenes = find_scenes(assets_directory);
+    } catch (std::exception const &error) {
+        std::cerr << error.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    // The extension of the scene is kept, so that a .gltf and a .glb file of the same name don't share a file.
+    auto const get_cooked_path = [](std::filesystem::path scene) {
+        return scene += ".scene";
+    };
+
+    // Every scene is cooked on its own, a scene that fails doesn't stop the others.
+    std::vector<CookResult> results(scenes.size());
+    engine::ThreadPool::get_instance().parallel_for(
+            scenes.size(),
+            [&](std::size_t index) {
+                auto &result = results[index];
+
+                // Scenes are cooked concurrently, so the reports are kept with the scene and printed in order.
+                auto scene_options = options;
+                if (report) {
+                    scene_options.report_optimization_ =
+                            [&result](
+                                    std::string_view mesh_name,
+                                    engine::mesh_processing::
+                                            MeshOptimizationReport const &mesh
+                            ) {
+                                std::ostringstream line;
+                                line << "  Optimized mesh " << mesh_name
+                                     << ": " << mesh;
+                                result.reports_.push_back(line.str());
+                            };
+                }
+
+                try {
+                    auto const cooked = engine::cook_gltf_scene(
+                            assets_directory / scenes[index],
+                            output_directory / get_cooked_path(scenes[index]),
+                            scene_options
+                    );
+                    result.status_ = cooked.status_;
+                    result.key_    = cooked.key_;
+                } catch (std::exception const &error) {
+                    result.error_ = error.what();
+                }
+            }
+    );
+
+    bool                                     failed = false;
+    std::vector<engine::CookedManifestEntry> manifest;
+    for (std::size_t index = 0; index < scenes.size(); ++index) {
+        auto const &result = results[index];
+        if (!result.status_) {
+            std::cerr << scenes[index].generic_string() << ": "
+                      << result.error_ << '\n';
+            failed = true;
+            continue;
+        }
+
+        std::cout << scenes[index].generic_string() << ": "
+                  << get_status_name(*result.status_) << '\n';
+        for (auto const &line : result.reports_) {
+            std::cout << line << '\n';
+        }
+        if (*result.status_ == engine::CookStatus::NotWritten) {
+            failed = true;
+            continue;
+        }
+
+        manifest.push_back(
+                {result.key_, get_cooked_path(scenes[index]), scenes[index]}
+        );
+    }
+
+    try {
+        engine::write_cooked_manifest(output_directory, manifest);
+    } catch (std::exception const &error) {
+        std::cerr << error.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
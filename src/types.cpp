@@ -2,4 +2,5 @@
 
 namespace engine {
     bgfx::VertexLayout Vertex::layout{};
+    bgfx::VertexLayout PackedVertex::layout{};
 }
@@ -20,20 +20,53 @@ namespace engine {
         }
     };
 
+    // 12 byte vertex: positions are normalized to the bounds of their primitive and quantized to 16 bits, texture
+    // coordinates are half floats. See graphics/vertex_packing.h.
+    struct PackedVertex final {
+        int16_t  x_{}, y_{}, z_{};
+        int16_t  padding_{};
+        uint16_t u_{}, v_{};
+
+        static bgfx::VertexLayout layout;
+
+        static void setup_layout() {
+            // Position is padded to four components, three component 16-bit formats are not supported everywhere.
+            layout.begin()
+                    .add(bgfx::Attrib::Position, 4, bgfx::AttribType::Int16,
+                         true)
+                    .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Half)
+                    .end();
+        }
+    };
+
+    enum class VertexFormat {
+        // Vertex
+        Float,
+        // PackedVertex
+        Packed,
+    };
+
+    // Indices are uint32_t on the CPU, primitives store them in 16 bits on the GPU whenever they fit.
     using Index = uint32_t;
 
+    enum class IndexWidth {
+        Bits16,
+        Bits32,
+    };
+
     struct GenericBgfxDestroyer final {
         void operator()(auto const handle) const {
             bgfx::destroy(handle);
         }
     };
 
-    using VertexBufferUPtr = UniqueHandle<
-            bgfx::VertexBufferHandle, BGFX_INVALID_HANDLE,
+    using DynamicVertexBufferUPtr = UniqueHandle<
+            bgfx::DynamicVertexBufferHandle, BGFX_INVALID_HANDLE,
             GenericBgfxDestroyer>;
 
-    using IndexBufferUPtr = UniqueHandle<
-            bgfx::IndexBufferHandle, BGFX_INVALID_HANDLE, GenericBgfxDestroyer>;
+    using DynamicIndexBufferUPtr = UniqueHandle<
+            bgfx::DynamicIndexBufferHandle, BGFX_INVALID_HANDLE,
+            GenericBgfxDestroyer>;
 
     using ShaderUPtr = UniqueHandle<
             bgfx::ShaderHandle, BGFX_INVALID_HANDLE, GenericBgfxDestroyer>;
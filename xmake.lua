@@ -23,6 +23,7 @@ target("engine")
 	set_default(true)
 	set_kind(binary)
 	add_files("src/*.cpp", "src/**/*.cpp")
+	remove_files("src/tools/*.cpp")
 	add_packages("glfw-local", "bgfx", "entt")
 	set_languages("c++23")
     add_includedirs("src")